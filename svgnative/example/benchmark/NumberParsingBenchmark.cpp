@@ -0,0 +1,182 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+// Compares SVGNumberParser::ParseNumber with the float accumulation parser
+// it replaced on path data like coordinates.
+
+#include "SVGNumberParser.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// The previous implementation of ParseScientificNumber.
+bool ParseLegacyNumber(const char*& pos, const char* end, float& number)
+{
+    if (pos == end)
+        return false;
+
+    number = 0;
+
+    float sign{1};
+    float exponent{0};
+    float exponentSign{1};
+
+    if (*pos == '-' || *pos == '+')
+    {
+        if (*pos == '-')
+            sign = -1;
+        pos++;
+        if (pos == end)
+            return false;
+    }
+
+    bool hasNumber{};
+    bool hasFraction{};
+    while (pos != end && isDigit(*pos))
+    {
+        hasNumber = true;
+        number *= 10;
+        number += static_cast<float>(*pos++ - '0');
+    }
+    if (pos == end)
+    {
+        number *= sign;
+        return std::isfinite(number);
+    }
+
+    if (*pos == '.')
+    {
+        pos++;
+        if (pos == end || !isDigit(*pos))
+            return false;
+
+        float division = 10;
+        while (pos != end && isDigit(*pos))
+        {
+            hasFraction = true;
+            number += static_cast<float>(*pos++ - '0') / division;
+            division *= 10;
+        }
+    }
+    if (!hasFraction && !hasNumber)
+        return false;
+
+    if (pos == end || (*pos != 'e' && *pos != 'E'))
+    {
+        number *= sign;
+        return std::isfinite(number);
+    }
+
+    pos++;
+    if (pos == end)
+        return false;
+
+    if (*pos == '-' || *pos == '+')
+    {
+        if (*pos == '-')
+            exponentSign = -1;
+        pos++;
+        if (pos == end)
+            return false;
+    }
+    if (!isDigit(*pos))
+        return false;
+
+    while (pos != end && isDigit(*pos))
+    {
+        exponent *= 10.0f;
+        exponent += static_cast<float>(*pos++ - '0');
+    }
+    if (exponent)
+        number *= pow(10.0f, exponentSign * exponent);
+
+    number *= sign;
+    return std::isfinite(number);
+}
+
+template <typename Parser>
+double Run(const std::string& data, Parser parser, std::vector<float>& numbers)
+{
+    const auto start = std::chrono::steady_clock::now();
+    numbers.clear();
+    const char* pos = data.data();
+    const char* end = pos + data.size();
+    while (pos != end)
+    {
+        float number{};
+        if (!parser(pos, end, number))
+            break;
+        numbers.push_back(number);
+        if (pos != end)
+            ++pos;
+    }
+    const auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(duration).count();
+}
+
+void Benchmark(const char* name, const std::string& data, size_t count)
+{
+    std::vector<float> legacyNumbers, numbers;
+    double legacyTime{1e300}, time{1e300};
+    for (int i = 0; i < 10; ++i)
+    {
+        legacyTime = std::min(legacyTime, Run(data, ParseLegacyNumber, legacyNumbers));
+        time = std::min(time, Run(data, SVGNative::SVGNumberParser::ParseNumber, numbers));
+    }
+
+    size_t differences{};
+    for (size_t i = 0; i < numbers.size() && i < legacyNumbers.size(); ++i)
+        differences += memcmp(&numbers[i], &legacyNumbers[i], sizeof(float)) != 0;
+
+    printf("%-28s legacy %7.2f ns/number  new %7.2f ns/number  speedup %5.2fx  different results %zu/%zu\n", name,
+        legacyTime / count, time / count, legacyTime / time, differences, count);
+}
+} // namespace
+
+int main()
+{
+    const size_t count = 1000000;
+    std::mt19937 random(2019);
+
+    std::string coordinates, longMantissas, scientific, integers;
+    std::uniform_real_distribution<double> coordinate(-2000.0, 2000.0);
+    std::uniform_int_distribution<int> exponent(-20, 20);
+    std::uniform_int_distribution<int> integer(0, 4096);
+    char buffer[64];
+    for (size_t i = 0; i < count; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "%.3f ", coordinate(random));
+        coordinates += buffer;
+        snprintf(buffer, sizeof(buffer), "%.12f ", coordinate(random));
+        longMantissas += buffer;
+        snprintf(buffer, sizeof(buffer), "%.6fe%d ", coordinate(random), exponent(random));
+        scientific += buffer;
+        snprintf(buffer, sizeof(buffer), "%d ", integer(random));
+        integers += buffer;
+    }
+
+    Benchmark("integers", integers, count);
+    Benchmark("coordinates (%.3f)", coordinates, count);
+    Benchmark("long mantissas (%.12f)", longMantissas, count);
+    Benchmark("scientific (%.6fe%d)", scientific, count);
+    return 0;
+}
@@ -0,0 +1,341 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+// Measures the render throughput of SVGRenderPool with 1 to N threads on the
+// SVG files passed on the command line and on generated large documents.
+//
+// benchRenderPool [maxThreads] [file.svg ...]
+
+#include "SVGDocument.h"
+#include "SVGRenderPool.h"
+#include "SVGRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Hashes all geometry and draw calls instead of drawing, so that the result
+// of every job can be compared between thread counts.
+inline void Mix(std::uint64_t& hash, std::uint64_t value) { hash = (hash ^ value) * 1099511628211ull; }
+
+inline void Mix(std::uint64_t& hash, float value)
+{
+    std::uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Mix(hash, static_cast<std::uint64_t>(bits));
+}
+
+class HashPath final : public SVGNative::Path
+{
+public:
+    void Rect(float x, float y, float width, float height) override { MixAll(1, {x, y, width, height}); }
+    void RoundedRect(float x, float y, float width, float height, float cornerRadius) override
+    {
+        MixAll(2, {x, y, width, height, cornerRadius});
+    }
+    void Ellipse(float cx, float cy, float rx, float ry) override { MixAll(3, {cx, cy, rx, ry}); }
+    void MoveTo(float x, float y) override { MixAll(4, {x, y}); }
+    void LineTo(float x, float y) override { MixAll(5, {x, y}); }
+    void CurveTo(float x1, float y1, float x2, float y2, float x3, float y3) override { MixAll(6, {x1, y1, x2, y2, x3, y3}); }
+    void CurveToV(float x2, float y2, float x3, float y3) override { MixAll(7, {x2, y2, x3, y3}); }
+    void ClosePath() override { Mix(hash, std::uint64_t{8}); }
+
+    std::uint64_t hash{14695981039346656037ull};
+
+private:
+    void MixAll(std::uint64_t verb, std::initializer_list<float> values)
+    {
+        Mix(hash, verb);
+        for (auto value : values)
+            Mix(hash, value);
+    }
+};
+
+class HashImageData final : public SVGNative::ImageData
+{
+public:
+    float Width() const override { return 1; }
+    float Height() const override { return 1; }
+};
+
+class HashRenderer final : public SVGNative::SVGRenderer
+{
+public:
+    std::unique_ptr<SVGNative::ImageData> CreateImageData(const std::string&, SVGNative::ImageEncoding) override
+    {
+        return std::unique_ptr<SVGNative::ImageData>(new HashImageData);
+    }
+    std::unique_ptr<SVGNative::Path> CreatePath() override { return std::unique_ptr<SVGNative::Path>(new HashPath); }
+
+    void Save(const SVGNative::GraphicStyle& graphicStyle) override { MixTransform(graphicStyle); }
+    void Restore() override { Mix(hash, std::uint64_t{9}); }
+
+    void DrawPath(const SVGNative::Path& path, const SVGNative::GraphicStyle& graphicStyle,
+        const SVGNative::FillStyle& fillStyle, const SVGNative::StrokeStyle& strokeStyle) override
+    {
+        Mix(hash, static_cast<const HashPath&>(path).hash);
+        MixTransform(graphicStyle);
+        Mix(hash, static_cast<std::uint64_t>(fillStyle.hasFill));
+        MixPaint(fillStyle.paint);
+        Mix(hash, static_cast<std::uint64_t>(strokeStyle.hasStroke));
+        MixPaint(strokeStyle.paint);
+        Mix(hash, strokeStyle.lineWidth);
+    }
+    void DrawImage(const SVGNative::ImageData&, const SVGNative::GraphicStyle& graphicStyle, const SVGNative::Rect&,
+        const SVGNative::Rect& fillArea) override
+    {
+        MixTransform(graphicStyle);
+        Mix(hash, fillArea.width);
+    }
+
+    std::uint64_t hash{};
+
+private:
+    void MixPaint(const SVGNative::Paint& paint)
+    {
+        Mix(hash, static_cast<std::uint64_t>(paint.which()));
+        if (auto color = boost::get<SVGNative::Color>(&paint))
+        {
+            for (auto component : *color)
+                Mix(hash, component);
+        }
+    }
+
+    void MixTransform(const SVGNative::GraphicStyle& graphicStyle)
+    {
+        Mix(hash, graphicStyle.opacity);
+        if (graphicStyle.clippingPath && graphicStyle.clippingPath->path)
+            Mix(hash, static_cast<const HashPath&>(*graphicStyle.clippingPath->path).hash);
+        if (graphicStyle.transform)
+        {
+            Mix(hash, graphicStyle.transform->a);
+            Mix(hash, graphicStyle.transform->e);
+            Mix(hash, graphicStyle.transform->f);
+        }
+    }
+};
+
+std::string ReadFile(const char* path)
+{
+    std::string content;
+    if (auto file = fopen(path, "rb"))
+    {
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            content.append(buffer, read);
+        fclose(file);
+    }
+    return content;
+}
+
+// Groups of transformed shapes and paths with gradients, clipping paths and
+// <use> references.
+std::string GenerateDocument(size_t shapeCount, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> coordinate(0.0f, 1000.0f);
+    std::uniform_int_distribution<int> kind(0, 5);
+    char buffer[512];
+
+    std::string svg = "<svg xmlns='http://www.w3.org/2000/svg' xmlns:xlink='http://www.w3.org/1999/xlink' "
+                      "viewBox='0 0 1000 1000'>\n<defs>\n";
+    for (int i = 0; i < 16; ++i)
+    {
+        snprintf(buffer, sizeof(buffer),
+            "<linearGradient id='g%d' x1='0' y1='0' x2='1' y2='1'><stop offset='0' stop-color='#%06x'/>"
+            "<stop offset='0.5' stop-color='#%06x' stop-opacity='0.5'/><stop offset='1' stop-color='#%06x'/></linearGradient>\n",
+            i, static_cast<unsigned>(random() & 0xffffff), static_cast<unsigned>(random() & 0xffffff),
+            static_cast<unsigned>(random() & 0xffffff));
+        svg += buffer;
+    }
+    svg += "<clipPath id='clip'><circle cx='500' cy='500' r='450'/></clipPath>\n"
+           "<path id='shape' d='M0 0 C 10 -20 30 -20 40 0 S 70 20 80 0 L 80 40 Q 40 60 0 40 Z'/>\n</defs>\n";
+
+    for (size_t i = 0; i < shapeCount; ++i)
+    {
+        if (i % 64 == 0)
+        {
+            if (i)
+                svg += "</g>\n";
+            snprintf(buffer, sizeof(buffer), "<g transform='rotate(%.1f 500 500)'%s>\n", coordinate(random) * 0.36f,
+                i % 256 == 0 ? " clip-path='url(#clip)'" : "");
+            svg += buffer;
+        }
+        float x = coordinate(random), y = coordinate(random);
+        switch (kind(random))
+        {
+        case 0:
+            snprintf(buffer, sizeof(buffer), "<rect x='%.2f' y='%.2f' width='40' height='30' rx='4' fill='url(#g%zu)'/>\n", x,
+                y, i % 16);
+            break;
+        case 1:
+            snprintf(buffer, sizeof(buffer),
+                "<circle cx='%.2f' cy='%.2f' r='12' fill='#%06x' stroke='black' stroke-width='1.5'/>\n", x, y,
+                static_cast<unsigned>(random() & 0xffffff));
+            break;
+        case 2:
+            snprintf(buffer, sizeof(buffer), "<use xlink:href='#shape' x='%.2f' y='%.2f' fill='url(#g%zu)'/>\n", x, y,
+                i % 16);
+            break;
+        case 3:
+            snprintf(buffer, sizeof(buffer),
+                "<path d='M%.2f %.2f l 20 5 c 10 10 -5 25 -15 20 a 10 10 0 0 1 -10 -10 z' fill='var(--accent, #336699)' "
+                "fill-opacity='0.8'/>\n",
+                x, y);
+            break;
+        case 4:
+            snprintf(buffer, sizeof(buffer),
+                "<polyline points='%.2f,%.2f %.2f,%.2f %.2f,%.2f %.2f,%.2f' fill='none' stroke='url(#g%zu)' "
+                "stroke-width='3' stroke-dasharray='4 2'/>\n",
+                x, y, x + 10, y + 20, x + 30, y - 5, x + 45, y + 12, i % 16);
+            break;
+        default:
+            snprintf(buffer, sizeof(buffer),
+                "<ellipse transform='translate(%.2f %.2f) scale(1.5)' rx='10' ry='6' fill='#%06x' opacity='0.7'/>\n", x,
+                y, static_cast<unsigned>(random() & 0xffffff));
+            break;
+        }
+        svg += buffer;
+    }
+    if (shapeCount)
+        svg += "</g>\n";
+    svg += "</svg>\n";
+    return svg;
+}
+
+SVGNative::RenderJob Job(const SVGNative::SVGDocument& document, float size, const SVGNative::ColorMap& colorMap)
+{
+    SVGNative::RenderJob job;
+    job.document = &document;
+    job.width = size;
+    job.height = size;
+    job.colorMap = &colorMap;
+    return job;
+}
+
+struct Result
+{
+    double seconds;
+    std::uint64_t hash;
+};
+
+Result RunBatch(unsigned threadCount, const std::vector<SVGNative::RenderJob>& jobs)
+{
+    SVGNative::SVGRenderPool pool{[](unsigned) { return std::unique_ptr<SVGNative::SVGRenderer>(new HashRenderer); },
+        threadCount};
+    std::vector<std::uint64_t> hashes(jobs.size());
+    auto completion = [&](size_t index, SVGNative::SVGRenderer* renderer, bool success) {
+        auto hashRenderer = static_cast<HashRenderer*>(renderer);
+        hashes[index] = success ? hashRenderer->hash : 0;
+        if (hashRenderer)
+            hashRenderer->hash = 0;
+    };
+
+    // Warm up so that every worker has its renderer.
+    pool.RenderBatch(jobs.data(), jobs.size(), completion);
+
+    double best{1e300};
+    for (int i = 0; i < 5; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        pool.RenderBatch(jobs.data(), jobs.size(), completion);
+        const auto duration = std::chrono::steady_clock::now() - start;
+        best = std::min(best, std::chrono::duration<double>(duration).count());
+    }
+
+    std::uint64_t hash{};
+    for (auto jobHash : hashes)
+        Mix(hash, jobHash);
+    return {best, hash};
+}
+
+void Benchmark(const char* name, unsigned maxThreads, const std::vector<SVGNative::RenderJob>& jobs)
+{
+    if (jobs.empty())
+        return;
+
+    printf("%s: %zu jobs\n", name, jobs.size());
+    Result single{};
+    for (unsigned threadCount = 1; threadCount <= maxThreads; ++threadCount)
+    {
+        auto result = RunBatch(threadCount, jobs);
+        if (threadCount == 1)
+            single = result;
+        printf("  %2u threads %9.2f ms %10.0f jobs/s  speedup %5.2fx  efficiency %3.0f%%  %s\n", threadCount,
+            result.seconds * 1000, jobs.size() / result.seconds, single.seconds / result.seconds,
+            100 * single.seconds / result.seconds / threadCount, result.hash == single.hash ? "same output" : "DIFFERENT OUTPUT");
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int firstFile = 1;
+    if (argc > 1 && atoi(argv[1]) > 0)
+    {
+        maxThreads = static_cast<unsigned>(atoi(argv[1]));
+        firstFile = 2;
+    }
+
+    SVGNative::ColorMap colorMap = {{"accent", {{0.8f, 0.2f, 0.1f, 1.0f}}}, {"test-red", {{0.502f, 0.0f, 0.0f, 1.0f}}},
+        {"test-green", {{0.0f, 0.502f, 0.0f, 1.0f}}}, {"test-blue", {{0.0f, 0.0f, 1.0f, 1.0f}}}};
+
+    // Documents are parsed without renderer and drawn by the pool's renderers.
+    std::vector<std::unique_ptr<SVGNative::SVGDocument>> corpus;
+    for (int i = firstFile; i < argc; ++i)
+    {
+        auto svg = ReadFile(argv[i]);
+        if (auto document = SVGNative::SVGDocument::CreateSVGDocument(svg.data(), svg.size(), nullptr))
+            corpus.push_back(std::move(document));
+        else
+            fprintf(stderr, "Skipping %s\n", argv[i]);
+    }
+
+    // Small documents get rendered at many sizes, like icons.
+    std::vector<SVGNative::RenderJob> corpusJobs;
+    for (int size = 16; corpus.size() && corpusJobs.size() < 4000; size += 8)
+    {
+        for (const auto& document : corpus)
+            corpusJobs.push_back(Job(*document, static_cast<float>(size), colorMap));
+    }
+    Benchmark("corpus", maxThreads, corpusJobs);
+
+    // Large documents of very different size so that workers run out of
+    // their own jobs at different times.
+    std::vector<std::unique_ptr<SVGNative::SVGDocument>> large;
+    for (size_t shapeCount : {40000, 20000, 5000, 1000, 200})
+    {
+        auto svg = GenerateDocument(shapeCount, static_cast<unsigned>(shapeCount));
+        large.push_back(SVGNative::SVGDocument::CreateSVGDocument(svg.data(), svg.size(), nullptr));
+    }
+    std::vector<SVGNative::RenderJob> largeJobs;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (const auto& document : large)
+            largeJobs.push_back(Job(*document, 512.0f * (i + 1), colorMap));
+    }
+    Benchmark("synthetic large documents", maxThreads, largeJobs);
+    return 0;
+}
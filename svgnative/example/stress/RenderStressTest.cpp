@@ -0,0 +1,311 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+// Renders shared documents on many threads at once through
+// SVGDocument::Render(renderer, colorMap, width, height) const while another
+// thread draws the same documents with Render() without renderer argument,
+// which fills the paths the documents keep for their renderer. Build with
+// -DTSAN=ON to run it under ThreadSanitizer. Every concurrent render must
+// produce the same output as a serial one.
+//
+// stressRender [threads] [file.svg ...]
+
+#include "SVGDocument.h"
+#include "SVGImageCache.h"
+#include "SVGRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Hashes all geometry and draw calls instead of drawing, so that concurrent
+// renders can be compared with a serial one.
+inline void Mix(std::uint64_t& hash, std::uint64_t value) { hash = (hash ^ value) * 1099511628211ull; }
+
+inline void Mix(std::uint64_t& hash, float value)
+{
+    std::uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Mix(hash, static_cast<std::uint64_t>(bits));
+}
+
+class HashPath final : public SVGNative::Path
+{
+public:
+    void Rect(float x, float y, float width, float height) override { MixAll(1, {x, y, width, height}); }
+    void RoundedRect(float x, float y, float width, float height, float cornerRadius) override
+    {
+        MixAll(2, {x, y, width, height, cornerRadius});
+    }
+    void Ellipse(float cx, float cy, float rx, float ry) override { MixAll(3, {cx, cy, rx, ry}); }
+    void MoveTo(float x, float y) override { MixAll(4, {x, y}); }
+    void LineTo(float x, float y) override { MixAll(5, {x, y}); }
+    void CurveTo(float x1, float y1, float x2, float y2, float x3, float y3) override { MixAll(6, {x1, y1, x2, y2, x3, y3}); }
+    void CurveToV(float x2, float y2, float x3, float y3) override { MixAll(7, {x2, y2, x3, y3}); }
+    void ClosePath() override { Mix(hash, std::uint64_t{8}); }
+
+    std::uint64_t hash{14695981039346656037ull};
+
+private:
+    void MixAll(std::uint64_t verb, std::initializer_list<float> values)
+    {
+        Mix(hash, verb);
+        for (auto value : values)
+            Mix(hash, value);
+    }
+};
+
+class HashImageData final : public SVGNative::ImageData
+{
+public:
+    float Width() const override { return 16; }
+    float Height() const override { return 16; }
+};
+
+class HashRenderer final : public SVGNative::SVGRenderer
+{
+public:
+    std::unique_ptr<SVGNative::ImageData> CreateImageData(const std::string&, SVGNative::ImageEncoding) override
+    {
+        return std::unique_ptr<SVGNative::ImageData>(new HashImageData);
+    }
+    std::unique_ptr<SVGNative::Path> CreatePath() override { return std::unique_ptr<SVGNative::Path>(new HashPath); }
+
+    void Save(const SVGNative::GraphicStyle& graphicStyle) override { MixStyle(graphicStyle); }
+    void Restore() override { Mix(hash, std::uint64_t{9}); }
+
+    void DrawPath(const SVGNative::Path& path, const SVGNative::GraphicStyle& graphicStyle,
+        const SVGNative::FillStyle& fillStyle, const SVGNative::StrokeStyle& strokeStyle) override
+    {
+        Mix(hash, static_cast<const HashPath&>(path).hash);
+        MixStyle(graphicStyle);
+        Mix(hash, static_cast<std::uint64_t>(fillStyle.hasFill));
+        MixPaint(fillStyle.paint);
+        Mix(hash, static_cast<std::uint64_t>(strokeStyle.hasStroke));
+        MixPaint(strokeStyle.paint);
+        Mix(hash, strokeStyle.lineWidth);
+    }
+    void DrawImage(const SVGNative::ImageData& image, const SVGNative::GraphicStyle& graphicStyle, const SVGNative::Rect&,
+        const SVGNative::Rect& fillArea) override
+    {
+        Mix(hash, image.Width());
+        MixStyle(graphicStyle);
+        Mix(hash, fillArea.width);
+    }
+
+    std::uint64_t hash{};
+
+private:
+    void MixPaint(const SVGNative::Paint& paint)
+    {
+        Mix(hash, static_cast<std::uint64_t>(paint.which()));
+        if (auto color = boost::get<SVGNative::Color>(&paint))
+        {
+            for (auto component : *color)
+                Mix(hash, component);
+        }
+        else if (auto gradient = boost::get<SVGNative::Gradient>(&paint))
+        {
+            for (const auto& colorStop : gradient->colorStops)
+            {
+                Mix(hash, colorStop.first);
+                for (auto component : colorStop.second)
+                    Mix(hash, component);
+            }
+        }
+    }
+
+    void MixStyle(const SVGNative::GraphicStyle& graphicStyle)
+    {
+        Mix(hash, graphicStyle.opacity);
+        if (graphicStyle.clippingPath && graphicStyle.clippingPath->path)
+            Mix(hash, static_cast<const HashPath&>(*graphicStyle.clippingPath->path).hash);
+        if (graphicStyle.transform)
+        {
+            Mix(hash, graphicStyle.transform->a);
+            Mix(hash, graphicStyle.transform->e);
+            Mix(hash, graphicStyle.transform->f);
+        }
+    }
+};
+
+std::string ReadFile(const char* path)
+{
+    std::string content;
+    if (auto file = fopen(path, "rb"))
+    {
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            content.append(buffer, read);
+        fclose(file);
+    }
+    return content;
+}
+
+// Clipping paths, gradients, var() colors, an embedded image and nested
+// <use> elements whose content is shared between instances.
+std::string GenerateDocument(size_t shapeCount)
+{
+    char buffer[512];
+    std::string svg = "<svg xmlns='http://www.w3.org/2000/svg' xmlns:xlink='http://www.w3.org/1999/xlink' "
+                      "viewBox='0 0 1000 1000'>\n<defs>\n"
+                      "<linearGradient id='gradient'><stop offset='0' stop-color='var(--accent, red)'/>"
+                      "<stop offset='1' stop-color='#00f' stop-opacity='0.5'/></linearGradient>\n"
+                      "<clipPath id='clip'><circle cx='500' cy='500' r='450'/></clipPath>\n"
+                      "<path id='shape' d='M0 0 C 10 -20 30 -20 40 0 S 70 20 80 0 L 80 40 Q 40 60 0 40 Z'/>\n"
+                      "<g id='pair'><use xlink:href='#shape'/><use xlink:href='#shape' x='90' fill='url(#gradient)'/></g>\n"
+                      "</defs>\n<g clip-path='url(#clip)'>\n";
+    for (size_t i = 0; i < shapeCount; ++i)
+    {
+        float x = static_cast<float>(i * 37 % 1000);
+        float y = static_cast<float>(i * 91 % 1000);
+        switch (i % 5)
+        {
+        case 0:
+            snprintf(buffer, sizeof(buffer), "<rect x='%.0f' y='%.0f' width='40' height='30' rx='4' fill='url(#gradient)'/>\n", x, y);
+            break;
+        case 1:
+            snprintf(buffer, sizeof(buffer), "<use xlink:href='#pair' x='%.0f' y='%.0f' fill='var(--accent, green)'/>\n", x, y);
+            break;
+        case 2:
+            snprintf(buffer, sizeof(buffer), "<polygon points='%.0f,%.0f %.0f,%.0f %.0f,%.0f' stroke='black' fill='none'/>\n", x, y,
+                x + 20, y + 30, x - 10, y + 15);
+            break;
+        case 3:
+            snprintf(buffer, sizeof(buffer),
+                "<image x='%.0f' y='%.0f' width='16' height='16' xlink:href='data:image/png;base64,iVBORw0KGgo='/>\n", x, y);
+            break;
+        default:
+            snprintf(buffer, sizeof(buffer), "<ellipse cx='%.0f' cy='%.0f' rx='10' ry='6' transform='rotate(30)' opacity='0.7'/>\n",
+                x, y);
+            break;
+        }
+        svg += buffer;
+    }
+    svg += "</g>\n</svg>\n";
+    return svg;
+}
+
+struct Document
+{
+    std::string name;
+    std::unique_ptr<SVGNative::SVGDocument> document;
+    std::uint64_t expectedHash;
+};
+
+// Adds the document with eagerly created and with lazy geometry.
+void AddDocument(std::vector<Document>& documents, const std::string& name, const std::string& svg)
+{
+    auto eager = SVGNative::SVGDocument::CreateSVGDocument(svg.data(), svg.size(), std::make_shared<HashRenderer>());
+    auto lazy = SVGNative::SVGDocument::CreateSVGDocumentLazy(
+        std::vector<char>{svg.begin(), svg.end()}, std::make_shared<HashRenderer>());
+    if (!eager || !lazy)
+    {
+        fprintf(stderr, "Skipping %s\n", name.c_str());
+        return;
+    }
+    documents.push_back({name, std::move(eager), 0});
+    documents.push_back({name + " (lazy)", std::move(lazy), 0});
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    unsigned threadCount = std::max(4u, std::thread::hardware_concurrency());
+    int firstFile = 1;
+    if (argc > 1 && atoi(argv[1]) > 0)
+    {
+        threadCount = static_cast<unsigned>(atoi(argv[1]));
+        firstFile = 2;
+    }
+
+    const SVGNative::ColorMap colorMap = {{"accent", {{0.8f, 0.2f, 0.1f, 1.0f}}}, {"test-red", {{0.502f, 0.0f, 0.0f, 1.0f}}},
+        {"test-green", {{0.0f, 0.502f, 0.0f, 1.0f}}}, {"test-blue", {{0.0f, 0.0f, 1.0f, 1.0f}}}};
+    const float size = 256.0f;
+    const int iterations = 20;
+
+    std::vector<Document> documents;
+    for (int i = firstFile; i < argc; ++i)
+        AddDocument(documents, argv[i], ReadFile(argv[i]));
+    AddDocument(documents, "generated", GenerateDocument(500));
+
+    // Expected output of a serial render. The documents have not drawn to
+    // their own renderer yet, so their path caches are still empty.
+    for (auto& document : documents)
+    {
+        HashRenderer renderer;
+        document.document->Render(renderer, colorMap, size, size);
+        document.expectedHash = renderer.hash;
+    }
+
+    std::atomic<bool> start{false};
+    std::atomic<unsigned> mismatches{0};
+    auto renderShared = [&](unsigned threadIndex) {
+        while (!start)
+            std::this_thread::yield();
+        HashRenderer renderer;
+        SVGNative::SVGImageCache imageCache;
+        for (int i = 0; i < iterations; ++i)
+        {
+            // Threads walk the documents in different orders.
+            for (size_t j = 0; j < documents.size(); ++j)
+            {
+                const auto& document = documents[(j + threadIndex) % documents.size()];
+                renderer.hash = 0;
+                // Every other pass takes the images from the cache of the thread.
+                if (i % 2)
+                    document.document->Render(renderer, colorMap, size, size, imageCache);
+                else
+                    document.document->Render(renderer, colorMap, size, size);
+                if (renderer.hash != document.expectedHash)
+                {
+                    fprintf(stderr, "Different output for %s on thread %u\n", document.name.c_str(), threadIndex);
+                    ++mismatches;
+                }
+            }
+        }
+    };
+    // Fills the paths and clipping paths documents keep for their renderer
+    // while the other threads render.
+    auto renderCached = [&]() {
+        while (!start)
+            std::this_thread::yield();
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (auto& document : documents)
+                document.document->Render(colorMap, size, size);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < threadCount; ++i)
+        threads.emplace_back(renderShared, i);
+    threads.emplace_back(renderCached);
+    start = true;
+    for (auto& thread : threads)
+        thread.join();
+
+    printf("%zu documents, %u threads, %d iterations: %s\n", documents.size(), threadCount, iterations,
+        mismatches ? "DIFFERENT OUTPUT" : "same output");
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -29,20 +29,20 @@ int main(int argc, char* const argv[])
         return 0;
     }
 
-    std::string svgInput{};
-    std::ifstream input(argv[1]);
-    if (!input)
+    auto renderer = std::make_shared<SVGNative::SkiaSVGRenderer>();
+
+    SVGNative::LoadStatus status{};
+    auto doc = SVGNative::SVGDocument::CreateFromFile(argv[1], renderer, &status);
+    if (status == SVGNative::LoadStatus::kFileError)
     {
         std::cout << "Error! Could not open input file." << std::endl;
         exit(EXIT_FAILURE);
     }
-    for (std::string line; std::getline(input, line);)
-        svgInput.append(line);
-    input.close();
-
-    auto renderer = std::make_shared<SVGNative::SkiaSVGRenderer>();
-
-    auto doc = std::unique_ptr<SVGNative::SVGDocument>(SVGNative::SVGDocument::CreateSVGDocument(svgInput.c_str(), renderer));
+    if (!doc)
+    {
+        std::cout << "Error! Could not parse input file." << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
     auto skRasterSurface = SkSurface::MakeRasterN32Premul(doc->Width(), doc->Height());
     auto skRasterCanvas = skRasterSurface->getCanvas();
@@ -17,11 +17,43 @@
  **************************************************************************/
 
 #include "SVGDocument.h"
+#include "SVGDocumentBuilder.h"
 #include "StringSVGRenderer.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <string>
+#include <vector>
+
+static const char* ParseErrorName(SVGNative::ParseErrorCode code)
+{
+    switch (code)
+    {
+    case SVGNative::ParseErrorCode::kNone: return "None";
+    case SVGNative::ParseErrorCode::kInvalidXML: return "InvalidXML";
+    case SVGNative::ParseErrorCode::kUnexpectedEnd: return "UnexpectedEnd";
+    case SVGNative::ParseErrorCode::kUnexpectedEndTag: return "UnexpectedEndTag";
+    case SVGNative::ParseErrorCode::kNoRootElement: return "NoRootElement";
+    case SVGNative::ParseErrorCode::kException: return "Exception";
+    case SVGNative::ParseErrorCode::kDepthLimitExceeded: return "DepthLimitExceeded";
+    case SVGNative::ParseErrorCode::kUseLimitExceeded: return "UseLimitExceeded";
+    case SVGNative::ParseErrorCode::kPathLimitExceeded: return "PathLimitExceeded";
+    case SVGNative::ParseErrorCode::kMemoryLimitExceeded: return "MemoryLimitExceeded";
+    case SVGNative::ParseErrorCode::kReferenceCycle: return "ReferenceCycle";
+    }
+    return "Unknown";
+}
+
+static std::string RenderToString(const std::unique_ptr<SVGNative::SVGDocument>& doc, const SVGNative::ColorMap& colorMap)
+{
+    if (!doc)
+        return "Error! Could not parse input file.";
+    SVGNative::StringSVGRenderer renderer;
+    doc->Render(renderer, colorMap, static_cast<float>(doc->Width()), static_cast<float>(doc->Height()));
+    return renderer.String();
+}
 
 int main(int argc, char* const argv[])
 {
@@ -31,26 +63,69 @@ int main(int argc, char* const argv[])
         return 0;
     }
 
-    std::string svgInput{};
-    std::ifstream input(argv[1]);
-    if (!input)
-    {
-        std::cout << "Error! Could not open input file." << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    for (std::string line; std::getline(input, line);)
-        svgInput.append(line);
-    input.close();
-
     SVGNative::ColorMap colorMap = {
         {"test-red",   {{0.502,   0.0, 0.0, 1.0}}},
         {"test-green", {{  0.0, 0.502, 0.0, 1.0}}},
         {"test-blue",  {{  0.0,   0.0, 1.0, 1.0}}}
     };
+
     auto renderer = std::make_shared<SVGNative::StringSVGRenderer>();
+    SVGNative::LoadStatus status{};
+    auto doc = SVGNative::SVGDocument::CreateFromFile(argv[1], renderer, &status);
+    if (status == SVGNative::LoadStatus::kFileError)
+    {
+        std::cout << "Error! Could not open input file." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::ifstream inputStream{argv[1], std::ios::binary};
+    std::string content{std::istreambuf_iterator<char>{inputStream}, std::istreambuf_iterator<char>{}};
 
-    auto doc = std::unique_ptr<SVGNative::SVGDocument>(SVGNative::SVGDocument::CreateSVGDocument(svgInput.c_str(), renderer));
-    doc->Render(colorMap);
+    // The builder reports why content is rejected. Expectations of invalid
+    // content record the error instead of the draw calls.
+    SVGNative::ParseError error;
+    auto builderDoc = SVGNative::SVGDocument::CreateSVGDocument(content.data(), content.size(), renderer, error);
+
+    std::string outputString;
+    if (!doc)
+    {
+        outputString = std::string{"Error! Could not parse input file: "} + ParseErrorName(error.code) + " at offset "
+            + std::to_string(error.offset) + " in " + error.elementPath + "\n";
+    }
+    else
+    {
+        doc->Render(colorMap);
+        outputString = renderer->String();
+
+        // All other ways to create a document must draw the same.
+        auto expected = RenderToString(doc, colorMap);
+
+        SVGNative::SVGDocumentBuilder chunkedBuilder{renderer};
+        for (size_t i = 0; i < content.size(); i += 7)
+            chunkedBuilder.Feed(content.data() + i, std::min<size_t>(7, content.size() - i));
+        auto chunkedDoc = chunkedBuilder.Finish();
+
+        auto parallelDoc = SVGNative::SVGDocument::CreateSVGDocumentParallel(content.data(), content.size(), renderer, 4);
+
+        std::vector<char> binary;
+        std::unique_ptr<SVGNative::SVGDocument> binaryDoc;
+        if (SVGNative::SVGDocument::CompileSVGDocument(content.c_str(), renderer, binary))
+            binaryDoc = SVGNative::SVGDocument::CreateFromBinary(binary.data(), binary.size(), renderer);
+
+        if (RenderToString(builderDoc, colorMap) != expected)
+            outputString += "Error! SVGDocumentBuilder output differs.\n";
+        if (RenderToString(chunkedDoc, colorMap) != expected)
+            outputString += "Error! Chunked SVGDocumentBuilder output differs.\n";
+        if (RenderToString(parallelDoc, colorMap) != expected)
+            outputString += "Error! CreateSVGDocumentParallel output differs.\n";
+        if (RenderToString(binaryDoc, colorMap) != expected)
+            outputString += "Error! CreateFromBinary output differs.\n";
+
+        auto dimensions = SVGNative::SVGDocument::Probe(content.data(), content.size());
+        if (!dimensions.isValid || static_cast<std::int32_t>(dimensions.width) != doc->Width()
+            || static_cast<std::int32_t>(dimensions.height) != doc->Height())
+            outputString += "Error! Probe dimensions differ.\n";
+    }
 
     std::fstream outputStream;
     outputStream.open(argv[2], std::fstream::out);
@@ -59,7 +134,6 @@ int main(int argc, char* const argv[])
         std::cout << "Error! Could not write file." << std::endl;
         exit(EXIT_FAILURE);
     }
-    std::string outputString{renderer->String()};
     outputStream << outputString;
     outputStream.close();
 
@@ -24,6 +24,13 @@ governing permissions and limitations under the License.
 #define SVG_ASSERT_MSG(exp, _message) void();
 #endif
 
+// Defined if the compiler does not support exceptions, like with -fno-exceptions.
+#ifndef SVG_NO_EXCEPTIONS
+#if !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define SVG_NO_EXCEPTIONS 1
+#endif
+#endif
+
 #ifndef SVG_PARSE_TRACE
 #define SVG_PARSE_TRACE(_message) void();
 #endif
@@ -16,6 +16,7 @@ governing permissions and limitations under the License.
 #include "Config.h"
 
 #include <array>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -31,21 +32,239 @@ class CssDocument;
 namespace SVGNative
 {
 class SVGDocumentImpl;
+class SVGImageCache;
+class SVGParserContext;
+class SVGParserContextImpl;
 class SVGRenderer;
 using ColorMap = std::map<std::string, std::array<float, 4>>;
 
+/**
+ * Outcome of loading an SVG document.
+ */
+enum class LoadStatus
+{
+    kSuccess,
+    kFileError, /** The file could not be opened or mapped. **/
+    kParseError /** The content could not be parsed as SVG. **/
+};
+
+/**
+ * Reason why SVG content could not be parsed.
+ */
+enum class ParseErrorCode
+{
+    kNone,
+    kInvalidXML, /** Malformed markup. **/
+    kUnexpectedEnd, /** The content ends within a tag or before all elements are closed. **/
+    kUnexpectedEndTag, /** An end tag without an open element. **/
+    kNoRootElement, /** The content has no element at all. **/
+    kException, /** An exception, like std::bad_alloc, was thrown while building the document. **/
+    kDepthLimitExceeded, /** Elements are nested deeper than ParseLimits::maxDepth. **/
+    kUseLimitExceeded, /** <use> elements expand to more than ParseLimits::maxUseExpansions elements. **/
+    kPathLimitExceeded, /** Shapes have more than ParseLimits::maxPathSegments segments in total. **/
+    kMemoryLimitExceeded, /** Buffered content exceeds ParseLimits::maxMemory. **/
+    kReferenceCycle /** A <use> element references itself directly or indirectly. **/
+};
+
+/**
+ * Budgets for parsing untrusted content. Parsing stops with the matching
+ * ParseErrorCode as soon as one is exceeded. The defaults are far above
+ * what real-world documents need. Functions without a limits parameter use
+ * the defaults and return nullptr if one is exceeded.
+ */
+struct ParseLimits
+{
+    size_t maxDepth{256}; /** Maximum nesting of elements, including nesting through <use>. **/
+    size_t maxUseExpansions{100000}; /** Maximum number of <use> expansions. Nested <use> elements count once per expansion of their ancestors. **/
+    size_t maxPathSegments{10000000}; /** Maximum number of segments of all shapes together. **/
+    size_t maxMemory{256 * 1024 * 1024}; /** Maximum bytes the builder buffers: incomplete tokens and elements kept for <use>. **/
+};
+
+/**
+ * Location and reason of the first error in SVG content.
+ */
+struct ParseError
+{
+    ParseErrorCode code{ParseErrorCode::kNone};
+    size_t offset{}; /** Byte offset into the content at which parsing stopped. **/
+    std::string elementPath; /** Elements open at offset, separated by '/'. Example: "svg/g/path". **/
+};
+
+/**
+ * Intrinsic dimensions of an SVG document in local coordinates, see SVGDocument::Probe().
+ */
+struct SVGDimensions
+{
+    bool isValid{}; /** False if the content does not start with an <svg> element. **/
+    float x{};
+    float y{};
+    float width{320.0f};
+    float height{200.0f};
+};
+
 class SVGDocument
 {
 public:
     /**
-     * Parses the passed string as SVG.
-     * @param s SVG content as string.
-     * @param renderer The renderer provides the Transform, Shape and Path interface needed at parse time and
-     *      the actual renderer used during rendering process.
+     * Parses the passed string as SVG. All functions that parse SVG content
+     * resolve references to gradients, clipping paths and <use> targets
+     * independently of the order of definition and reference.
+     * @param s SVG content as NUL-terminated string. The string does not get modified.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
      * @return Returns a pointer to a new SVGDocument object.
      */
     static std::unique_ptr<SVGDocument> CreateSVGDocument(const char* s, std::shared_ptr<SVGNative::SVGRenderer> renderer);
 
+    /**
+     * Parses the passed buffer as SVG.
+     * @param s SVG content. The buffer does not need to be NUL-terminated and gets neither
+     *      modified nor copied.
+     * @param length Number of bytes in s.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocument(const char* s, size_t length, std::shared_ptr<SVGNative::SVGRenderer> renderer);
+
+    /**
+     * Parses the passed buffer as SVG like CreateSVGDocument(s, length, renderer)
+     * but with the memory of context. Saves allocations when parsing many documents.
+     * @param s SVG content. The buffer does not need to be NUL-terminated and does not get modified.
+     * @param length Number of bytes in s.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @param context Memory kept for the next document. See SVGParserContext.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocument(
+        const char* s, size_t length, std::shared_ptr<SVGNative::SVGRenderer> renderer, SVGParserContext& context);
+
+    /**
+     * Parses the passed buffer as SVG without throwing exceptions. Malformed
+     * content is reported in error instead. This is the parser of
+     * SVGDocumentBuilder and also available in builds without exception support.
+     * @param s SVG content. The buffer does not need to be NUL-terminated and does not get modified.
+     * @param length Number of bytes in s.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @param error Receives the reason and location of the first error. Its code is
+     *      ParseErrorCode::kNone if parsing succeeded.
+     * @param limits Budgets for nesting, <use> expansion, path segments and memory.
+     * @return Returns a pointer to a new SVGDocument object or nullptr on error.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocument(const char* s, size_t length, std::shared_ptr<SVGNative::SVGRenderer> renderer,
+        ParseError& error, const ParseLimits& limits = ParseLimits{});
+
+    /**
+     * Parses the passed buffer as SVG and builds the children of the root element
+     * on several threads. This pays off for large documents with many top-level
+     * elements, like layers of maps and floor plans.
+     * All gradients, clipping paths and <use> targets are parsed before any other
+     * element. Documents rendering a <symbol> directly get parsed on the calling
+     * thread only.
+     * @param s SVG content. The buffer does not need to be NUL-terminated and does not get modified.
+     * @param length Number of bytes in s.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr. CreatePath() and
+     *      CreateImageData() get called concurrently and must be thread-safe.
+     * @param threadCount Maximum number of threads to use including the calling thread. 0 uses
+     *      one thread per hardware thread.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocumentParallel(
+        const char* s, size_t length, std::shared_ptr<SVGNative::SVGRenderer> renderer, unsigned threadCount = 0);
+
+    /**
+     * Parses the passed string as SVG. The string is consumed and parsed in place
+     * without copying it.
+     * @param s SVG content as string.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocument(std::string&& s, std::shared_ptr<SVGNative::SVGRenderer> renderer);
+
+    /**
+     * Parses the passed buffer as SVG but defers creating the Path of shapes until
+     * they get rendered first. The document keeps the buffer for that. This saves
+     * time and memory if the document gets parsed for its dimensions only or if
+     * most of it is never drawn.
+     * @param s SVG content. The document takes ownership of the buffer.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocumentLazy(std::vector<char>&& s, std::shared_ptr<SVGNative::SVGRenderer> renderer);
+
+    /**
+     * Parses the passed buffer as SVG. The buffer is consumed and parsed in place
+     * without copying it. The buffer does not need to be NUL-terminated.
+     * @param s SVG content.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateSVGDocument(std::vector<char>&& s, std::shared_ptr<SVGNative::SVGRenderer> renderer);
+
+    /**
+     * Parses the SVG file at path. The file gets mapped into memory with a private
+     * copy-on-write mapping and is parsed directly from the mapping.
+     * @param path Path to the SVG file.
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @param status Optional. Reports whether reading or parsing the file failed.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateFromFile(
+        const char* path, std::shared_ptr<SVGNative::SVGRenderer> renderer, LoadStatus* status = nullptr);
+
+    /**
+     * Reads the dimensions of the passed SVG content without parsing it. Only the
+     * content up to the start tag of the root element gets read. Nothing gets
+     * allocated. The result matches Width() and Height() of the parsed document.
+     * @param s SVG content. The buffer does not need to be NUL-terminated.
+     * @param length Number of bytes in s.
+     * @return Dimensions from the viewBox or the x, y, width and height attributes of the root element.
+     */
+    static SVGDimensions Probe(const char* s, size_t length);
+
+    /**
+     * Parses the passed string as SVG and writes the parsed document in a compact,
+     * versioned binary representation. Loading the binary representation with
+     * CreateFromBinary() is much faster than parsing the SVG content again.
+     * The binary representation is only valid for the same library version on
+     * machines with the same byte order.
+     * @param s SVG content as NUL-terminated string.
+     * @param renderer Used to determine the dimensions of embedded images only. Images
+     *      get dropped if renderer is nullptr.
+     * @param binary Receives the binary representation.
+     * @return Returns false if s could not be parsed.
+     */
+    static bool CompileSVGDocument(const char* s, std::shared_ptr<SVGNative::SVGRenderer> renderer, std::vector<char>& binary);
+
+    /**
+     * Creates a document from the binary representation written by CompileSVGDocument().
+     * Neither XML nor numbers get parsed. Paths are used directly from the stored data.
+     * @param data Binary representation of the document. Not referenced after the call returns.
+     * @param length Number of bytes in data.
+     * @param renderer Decodes embedded images at load time and is the renderer of Render()
+     *      without renderer argument. May be nullptr.
+     * @return Returns a pointer to a new SVGDocument object or nullptr if data is invalid or of another version.
+     */
+    static std::unique_ptr<SVGDocument> CreateFromBinary(const char* data, size_t length, std::shared_ptr<SVGNative::SVGRenderer> renderer);
+
+    /**
+     * Maps the binary document file at path into memory and loads it with CreateFromBinary().
+     * @param path Path to a file with the content written by CompileSVGDocument().
+     * @param renderer Decodes embedded images at load time and is the renderer of Render()
+     *      without renderer argument. May be nullptr.
+     * @param status Optional. Reports whether reading or loading the file failed.
+     * @return Returns a pointer to a new SVGDocument object.
+     */
+    static std::unique_ptr<SVGDocument> CreateFromBinaryFile(
+        const char* path, std::shared_ptr<SVGNative::SVGRenderer> renderer, LoadStatus* status = nullptr);
+
     ~SVGDocument();
 
     /**
@@ -62,7 +281,7 @@ public:
 
     /**
      * Renderer used to draw SVG content to. This was passed to ParserSVG() first.
-     * @return SVGRenderer
+     * @return SVGRenderer or nullptr if the document was created without renderer.
      */
     SVGNative::SVGRenderer* Renderer() const;
 
@@ -151,9 +370,47 @@ public:
      */
     void Render(const ColorMap& colorMap, float width, float height);
 
+    /**
+     * Renders the parsed SVG document to renderer instead of the renderer the document
+     * was created with. Parsed documents do not depend on a renderer. One document
+     * can be drawn by renderers of different ports without parsing it again.
+     * Paths and images get created for renderer on each call. Only Render() without
+     * renderer argument keeps them in the document between calls. Embedded images
+     * get decoded from their base64 source with SVGRenderer::CreateImageData() on
+     * every call. For documents with images that get drawn repeatedly, use the
+     * variant with an SVGImageCache instead.
+     *
+     * The document does not get modified. Several threads may render the same document
+     * at once, each to a renderer of its own, also while another thread calls Render()
+     * without renderer argument. Renderers themselves are not shared between threads.
+     * This does not hold for documents with custom CSS added with AddCustomCSS().
+     * @param renderer Renderer to draw to.
+     * @param colorMap A string-to-Color map for pre-defined colors that replace
+     *      CSS custom properties in the SVG file.
+     * @param width Horrizontal dimension of surface.
+     * @param height Vertical dimension of surface.
+     */
+    void Render(SVGNative::SVGRenderer& renderer, const ColorMap& colorMap, float width, float height) const;
+
+    /**
+     * Renders the parsed SVG document to renderer like Render(renderer, colorMap,
+     * width, height) but decodes each embedded image only once for renderer.
+     * @param imageCache Decoded images of renderer. See SVGImageCache.
+     */
+    void Render(SVGNative::SVGRenderer& renderer, const ColorMap& colorMap, float width, float height,
+        SVGImageCache& imageCache) const;
+
 private:
+    friend class SVGDocumentBuilder;
+
     SVGDocument();
 
+    // Parses s without copying it. Entities get decoded in place if writable
+    // is s, otherwise s does not get modified. Uses up to threadCount threads,
+    // see CreateSVGDocumentParallel(). Uses the memory of context if passed.
+    static std::unique_ptr<SVGDocument> CreateSVGDocumentFromBuffer(const char* s, char* writable, size_t length,
+        std::shared_ptr<SVGNative::SVGRenderer> renderer, unsigned threadCount = 1, SVGParserContextImpl* context = nullptr);
+
     std::unique_ptr<SVGDocumentImpl> mDocument;
 };
 
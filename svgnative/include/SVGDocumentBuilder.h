@@ -0,0 +1,87 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#ifndef SVGViewer_SVGDocumentBuilder_h
+#define SVGViewer_SVGDocumentBuilder_h
+
+#include "SVGDocument.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace SVGNative
+{
+class SVGDocumentBuilderImpl;
+class SVGRenderer;
+
+/**
+ * Push parser that builds an SVGDocument from chunks of SVG content as they
+ * arrive. Elements get added to the document as soon as they are complete.
+ * Neither the whole SVG content nor a complete XML tree is kept in memory.
+ * Only elements that reference gradients, clipping paths or <use> targets
+ * defined later in the content are kept until Finish() resolves them.
+ *
+ * @code
+ * SVGDocumentBuilder builder{renderer};
+ * while (auto size = ReadFromSocket(buffer, sizeof(buffer)))
+ * {
+ *     if (!builder.Feed(buffer, size))
+ *         break;
+ * }
+ * auto document = builder.Finish();
+ * @endcode
+ */
+class SVGDocumentBuilder
+{
+public:
+    /**
+     * @param renderer Decodes embedded images at parse time and is the renderer of Render()
+     *      without renderer argument. Images get dropped if renderer is nullptr.
+     * @param limits Budgets for nesting, <use> expansion, path segments and memory. Feed()
+     *      fails as soon as one is exceeded.
+     */
+    SVGDocumentBuilder(std::shared_ptr<SVGRenderer> renderer, const ParseLimits& limits = ParseLimits{});
+    ~SVGDocumentBuilder();
+
+    SVGDocumentBuilder(const SVGDocumentBuilder&) = delete;
+    SVGDocumentBuilder& operator=(const SVGDocumentBuilder&) = delete;
+
+    /**
+     * Parses the next chunk of SVG content. Chunks may split the content at
+     * any byte. The chunk is not referenced after the call returns.
+     * @param data Next chunk of SVG content.
+     * @param length Number of bytes in data.
+     * @return false if the content is known to be invalid. Further calls are ignored.
+     */
+    bool Feed(const char* data, size_t length);
+
+    /**
+     * Signals the end of the SVG content.
+     * @return Returns a pointer to a new SVGDocument object or nullptr if the content
+     *      was invalid or incomplete. The builder can not be used afterwards.
+     */
+    std::unique_ptr<SVGDocument> Finish();
+
+    /**
+     * Reason and location of the first error. The offset counts bytes from
+     * the start of the first chunk.
+     * @return Error with code ParseErrorCode::kNone as long as no error occurred.
+     */
+    const ParseError& Error() const;
+
+private:
+    std::unique_ptr<SVGDocumentBuilderImpl> mImpl;
+};
+
+} // namespace SVGNative
+
+#endif // SVGViewer_SVGDocumentBuilder_h
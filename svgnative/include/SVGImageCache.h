@@ -0,0 +1,62 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#ifndef SVGViewer_SVGImageCache_h
+#define SVGViewer_SVGImageCache_h
+
+#include "SVGDocument.h"
+
+#include <memory>
+
+namespace SVGNative
+{
+class SVGImageCacheImpl;
+
+/**
+ * Keeps the images that SVGDocument::Render() with a renderer argument decoded
+ * for that renderer. Without a cache, every call decodes all embedded images
+ * again with SVGRenderer::CreateImageData(). With a cache, each distinct image
+ * gets decoded once and reused by all following calls, also for other
+ * documents embedding the same image. Images stay in the cache until Clear().
+ * Images belong to the renderer that created them. Use a cache with one
+ * renderer only and clear or destroy it before the renderer. A cache must not
+ * be used by multiple threads at the same time.
+ *
+ * @code
+ * SVGImageCache imageCache;
+ * for (const auto& document : documents)
+ *     document->Render(renderer, colorMap, width, height, imageCache);
+ * @endcode
+ */
+class SVGImageCache
+{
+public:
+    SVGImageCache();
+    ~SVGImageCache();
+
+    SVGImageCache(const SVGImageCache&) = delete;
+    SVGImageCache& operator=(const SVGImageCache&) = delete;
+
+    /**
+     * Releases all images.
+     */
+    void Clear();
+
+private:
+    friend class SVGDocument;
+
+    std::unique_ptr<SVGImageCacheImpl> mImpl;
+};
+
+} // namespace SVGNative
+
+#endif // SVGViewer_SVGImageCache_h
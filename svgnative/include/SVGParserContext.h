@@ -0,0 +1,55 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+
+#ifndef SVGViewer_SVGParserContext_h
+#define SVGViewer_SVGParserContext_h
+
+#include "SVGDocument.h"
+
+#include <memory>
+
+namespace SVGNative
+{
+class SVGParserContextImpl;
+
+/**
+ * Keeps the memory parsing needs between documents. Parsing many documents
+ * with the same context reuses the XML tree, style stacks and resource
+ * tables instead of allocating them per document.
+ * A context must not be used by multiple threads at the same time. Documents
+ * do not reference the context after parsing.
+ *
+ * @code
+ * SVGParserContext context;
+ * for (const auto& icon : icons)
+ *     documents.push_back(SVGDocument::CreateSVGDocument(icon.data(), icon.size(), renderer, context));
+ * @endcode
+ */
+class SVGParserContext
+{
+public:
+    SVGParserContext();
+    ~SVGParserContext();
+
+    SVGParserContext(const SVGParserContext&) = delete;
+    SVGParserContext& operator=(const SVGParserContext&) = delete;
+
+private:
+    friend class SVGDocument;
+
+    std::unique_ptr<SVGParserContextImpl> mImpl;
+};
+
+} // namespace SVGNative
+
+#endif // SVGViewer_SVGParserContext_h
@@ -0,0 +1,125 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+
+#ifndef SVGViewer_SVGRenderPool_h
+#define SVGViewer_SVGRenderPool_h
+
+#include "SVGDocument.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace SVGNative
+{
+class SVGRenderPoolImpl;
+
+/**
+ * One document to render with RenderBatch().
+ */
+struct RenderJob
+{
+    const SVGDocument* document{};
+    /**
+     * Area the viewport of the document gets scaled into. The document's own
+     * dimensions are used if width or height is not positive.
+     */
+    float width{};
+    float height{};
+    /**
+     * Colors for CSS custom properties. No colors if nullptr.
+     */
+    const ColorMap* colorMap{};
+};
+
+/**
+ * Renders batches of jobs on a fixed set of worker threads. Every worker
+ * keeps one renderer, created by the factory on the worker's first job and
+ * reused for all following jobs and batches. The jobs of a batch are split
+ * evenly between the workers. Workers that run out of jobs take half of the
+ * remaining jobs of another worker, so documents of different complexity
+ * keep all workers busy.
+ *
+ * Documents get drawn with SVGDocument::Render(SVGRenderer&, ...). The same
+ * document may appear in several jobs of a batch. See there for documents
+ * with custom CSS. Every worker keeps an SVGImageCache with its renderer, so
+ * embedded images get decoded once per worker, not once per job.
+ *
+ * @code
+ * SVGRenderPool pool{[](unsigned) { return std::unique_ptr<SVGRenderer>(new SkiaSVGRenderer); }};
+ * pool.RenderBatch(jobs.data(), jobs.size(),
+ *     [&](size_t index, SVGRenderer* renderer, bool success) { ... },
+ *     [&](size_t index, SVGRenderer& renderer) {
+ *         static_cast<SkiaSVGRenderer&>(renderer).SetSkCanvas(surfaces[index]->getCanvas());
+ *     });
+ * @endcode
+ */
+class SVGRenderPool
+{
+public:
+    /**
+     * Creates the renderer of a worker. Gets called on the worker's thread.
+     * Returning nullptr fails all jobs of the worker until a later job
+     * succeeds to create one.
+     */
+    using RendererFactory = std::function<std::unique_ptr<SVGRenderer>(unsigned worker)>;
+    /**
+     * Gets called on the worker right before the job with index gets drawn,
+     * for instance to point the renderer to the output of the job.
+     */
+    using PrepareCallback = std::function<void(size_t index, SVGRenderer& renderer)>;
+    /**
+     * Gets called on the worker once the job with index is done. renderer
+     * is nullptr if the worker has none. success is false if the job has no
+     * document, if there is no renderer or if drawing threw an exception.
+     */
+    using CompletionCallback = std::function<void(size_t index, SVGRenderer* renderer, bool success)>;
+
+    /**
+     * @param factory Creates the renderer of each worker.
+     * @param threadCount Number of workers including the thread calling
+     *      RenderBatch(). 0 uses the number of hardware threads. Fewer
+     *      workers get used if the system refuses to create more threads.
+     */
+    explicit SVGRenderPool(RendererFactory factory, unsigned threadCount = 0);
+    ~SVGRenderPool();
+
+    SVGRenderPool(const SVGRenderPool&) = delete;
+    SVGRenderPool& operator=(const SVGRenderPool&) = delete;
+
+    /**
+     * @return Number of workers including the thread calling RenderBatch().
+     */
+    unsigned ThreadCount() const;
+
+    /**
+     * Renders all count jobs and returns once every job completed. The
+     * calling thread works on the batch as well. Callbacks get called
+     * concurrently from different workers, the two callbacks of one job on
+     * the same worker. Calls from multiple threads run one after another.
+     * Exceptions thrown by completion get rethrown after the batch.
+     * @param jobs Jobs to render. Must stay valid until the call returns.
+     * @param count Number of jobs.
+     * @param completion Reports each finished job. May be empty.
+     * @param prepare Prepares the renderer for each job. May be empty.
+     */
+    void RenderBatch(const RenderJob* jobs, size_t count, const CompletionCallback& completion,
+        const PrepareCallback& prepare = nullptr);
+
+private:
+    std::unique_ptr<SVGRenderPoolImpl> mImpl;
+};
+
+} // namespace SVGNative
+
+#endif // SVGViewer_SVGRenderPool_h
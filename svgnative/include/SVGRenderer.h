@@ -14,12 +14,18 @@ governing permissions and limitations under the License.
 #define SVGViewer_SVGRenderer_h
 
 #include <array>
+#include <boost/optional.hpp>
 #include <boost/variant.hpp>
+#include <cmath>
+#include <cstddef>
 #include <limits>
 #include <map>
 #include <memory>
+#include <new>
 #include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace SVGNative
@@ -93,7 +99,6 @@ enum class SpreadMethod
 };
 
 struct Gradient;
-class Transform;
 class Path;
 class Shape;
 
@@ -118,6 +123,79 @@ struct Rect
     float height = std::numeric_limits<float>::quiet_NaN();
 };
 
+/**
+ * 2D affine transformation matrix. Maps (x, y) to (a * x + c * y + e, b * x + d * y + f)
+ * like the SVG transform function matrix(a, b, c, d, e, f). Ports convert it
+ * to their native matrix type when drawing.
+ */
+struct AffineTransform
+{
+    AffineTransform() = default;
+    AffineTransform(float aA, float aB, float aC, float aD, float aE, float aF)
+        : a{aA}
+        , b{aB}
+        , c{aC}
+        , d{aD}
+        , e{aE}
+        , f{aF}
+    {
+    }
+
+    /**
+     * Multiplies other from the right. other gets applied to coordinates first.
+     */
+    void Concat(const AffineTransform& other)
+    {
+        AffineTransform result;
+        result.a = other.a * a + other.b * c;
+        result.b = other.a * b + other.b * d;
+        result.c = other.c * a + other.d * c;
+        result.d = other.c * b + other.d * d;
+        result.e = other.e * a + other.f * c + e;
+        result.f = other.e * b + other.f * d + f;
+        *this = result;
+    }
+
+    void Translate(float tx, float ty)
+    {
+        e += tx * a + ty * c;
+        f += tx * b + ty * d;
+    }
+
+    void Scale(float sx, float sy)
+    {
+        a *= sx;
+        b *= sx;
+        c *= sy;
+        d *= sy;
+    }
+
+    /**
+     * @param angle Rotation angle in degrees.
+     */
+    void Rotate(float angle)
+    {
+        // M_PI is not available everywhere without extra defines.
+        auto radians = static_cast<float>(3.14159265358979323846 / 180.0 * angle);
+        float cosAngle = std::cos(radians);
+        float sinAngle = std::sin(radians);
+        Concat({cosAngle, sinAngle, -sinAngle, cosAngle, 0, 0});
+    }
+
+    bool operator==(const AffineTransform& other) const
+    {
+        return a == other.a && b == other.b && c == other.c && d == other.d && e == other.e && f == other.f;
+    }
+    bool operator!=(const AffineTransform& other) const { return !(*this == other); }
+
+    float a{1};
+    float b{0};
+    float c{0};
+    float d{1};
+    float e{0};
+    float f{0};
+};
+
 /**
  * Representation of a linear gradient paint server.
  */
@@ -135,7 +213,7 @@ struct Gradient
     float fx = std::numeric_limits<float>::quiet_NaN(); /** fx for radialGradient **/
     float fy = std::numeric_limits<float>::quiet_NaN(); /** fy for radialGradient **/
     float r = std::numeric_limits<float>::quiet_NaN(); /** r for radialGradient **/
-    std::shared_ptr<Transform> transform; /** Joined transformation matrix based to the "transform" attribute. **/
+    boost::optional<AffineTransform> transform; /** Joined transformation matrix based to the "transform" attribute. **/
 };
 
 /**
@@ -165,24 +243,9 @@ struct FillStyle
     Paint paint = Color{{0, 0, 0, 1.0}};
 };
 
-/**
- * Representation of a 2D affine transform with 6 values.
- */
-class Transform
-{
-public:
-    virtual ~Transform() = default;
-
-    virtual void Set(float a, float b, float c, float d, float tx, float ty) = 0;
-    virtual void Rotate(float r) = 0;
-    virtual void Translate(float tx, float ty) = 0;
-    virtual void Scale(float sx, float sy) = 0;
-    virtual void Concat(const Transform& other) = 0;
-};
-
 struct ClippingPath
 {
-    ClippingPath(bool aHasClipContent, WindingRule aClipRule, std::shared_ptr<Path> aPath, std::shared_ptr<Transform> aTransform)
+    ClippingPath(bool aHasClipContent, WindingRule aClipRule, std::shared_ptr<Path> aPath, boost::optional<AffineTransform> aTransform)
         : hasClipContent{aHasClipContent}
         , clipRule{aClipRule}
         , path{aPath}
@@ -192,7 +255,7 @@ struct ClippingPath
     bool hasClipContent = false;
     WindingRule clipRule = WindingRule::kNonZero;
     std::shared_ptr<Path> path; /** Clipping path. **/
-    std::shared_ptr<Transform> transform; /** Joined transformation matrix based to the "transform" attribute. **/
+    boost::optional<AffineTransform> transform; /** Joined transformation matrix based to the "transform" attribute. **/
 };
 
 /**
@@ -202,7 +265,7 @@ struct GraphicStyle
 {
     // Add blend modes and other graohic style options here.
     float opacity = 1.0; /** Corresponds to the "opacty" CSS property. **/
-    std::shared_ptr<Transform> transform; /** Joined transformation matrix based to the "transform" attribute. **/
+    boost::optional<AffineTransform> transform; /** Joined transformation matrix based to the "transform" attribute. **/
     std::shared_ptr<ClippingPath> clippingPath;
 };
 
@@ -239,6 +302,55 @@ public:
     virtual float Height() const = 0;
 };
 
+/**
+ * Memory of one document. Objects allocated from it live as long as the
+ * document and get released all at once, without a free per object.
+ * Not thread-safe.
+ */
+class SVGAllocator
+{
+public:
+    virtual ~SVGAllocator() = default;
+
+    /**
+     * @return Uninitialized memory of size bytes. alignment must not exceed
+     * alignof(std::max_align_t).
+     */
+    virtual void* Allocate(size_t size, size_t alignment) = 0;
+
+    /**
+     * Registers destroy to be called with object before the memory gets
+     * released. Destructors run in reverse order of registration.
+     */
+    virtual void AddDestructor(void (*destroy)(void*), void* object) = 0;
+
+    /**
+     * Constructs a T in the allocator. The destructor of T runs when the
+     * document gets destroyed.
+     */
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        auto object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value)
+            AddDestructor([](void* p) { static_cast<T*>(p)->~T(); }, object);
+        return object;
+    }
+
+    /**
+     * Takes ownership of a heap allocated object.
+     * @return The object or nullptr if object is empty.
+     */
+    template <typename T>
+    T* Adopt(std::unique_ptr<T> object)
+    {
+        auto p = object.release();
+        if (p)
+            AddDestructor([](void* q) { delete static_cast<T*>(q); }, p);
+        return p;
+    }
+};
+
 /**
  * Base class for deriving, platform dependent renderer classes with immediate
  * graphic library calls.
@@ -250,8 +362,25 @@ public:
 
     virtual std::unique_ptr<ImageData> CreateImageData(const std::string& base64, ImageEncoding) = 0;
     virtual std::unique_ptr<Path> CreatePath() = 0;
-    virtual std::unique_ptr<Transform> CreateTransform(
-        float a = 1.0, float b = 0.0, float c = 0.0, float d = 1.0, float tx = 0.0, float ty = 0.0) = 0;
+
+    /**
+     * Variants of CreateImageData() and CreatePath() for objects the document
+     * keeps. Only called on the renderer a document was created with.
+     * AllocateImageData() gets called while parsing or loading a binary
+     * document, to get the dimensions of embedded images. AllocatePath()
+     * gets called by SVGDocument::Render() without renderer argument, the
+     * first time a shape gets drawn. Render() with a renderer argument uses
+     * CreatePath() and CreateImageData() instead and keeps nothing.
+     * allocator is the memory of the document. It owns the returned object
+     * and destroys it together with the document. The default implementations
+     * adopt the heap allocated objects of the plain factory functions. Ports
+     * may construct their objects in allocator instead with allocator.New<T>().
+     */
+    virtual ImageData* AllocateImageData(const std::string& base64, ImageEncoding encoding, SVGAllocator& allocator)
+    {
+        return allocator.Adopt(CreateImageData(base64, encoding));
+    }
+    virtual Path* AllocatePath(SVGAllocator& allocator) { return allocator.Adopt(CreatePath()); }
 
     virtual void Save(const GraphicStyle& graphicStyle) = 0;
     virtual void Restore() = 0;
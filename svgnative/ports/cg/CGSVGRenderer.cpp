@@ -62,19 +62,9 @@ void CGSVGPath::CurveToV(float x2, float y2, float x3, float y3)
 
 void CGSVGPath::ClosePath() { CGPathCloseSubpath(mPath); }
 
-CGSVGTransform::CGSVGTransform(float a, float b, float c, float d, float tx, float ty) { mTransform = {a, b, c, d, tx, ty}; }
-
-void CGSVGTransform::Set(float a, float b, float c, float d, float tx, float ty) { mTransform = {a, b, c, d, tx, ty}; }
-
-void CGSVGTransform::Rotate(float r) { mTransform = CGAffineTransformRotate(mTransform, r); }
-
-void CGSVGTransform::Translate(float tx, float ty) { mTransform = CGAffineTransformTranslate(mTransform, tx, ty); }
-
-void CGSVGTransform::Scale(float sx, float sy) { mTransform = CGAffineTransformScale(mTransform, sx, sy); }
-
-void CGSVGTransform::Concat(const Transform& other)
+static CGAffineTransform ToCGAffineTransform(const AffineTransform& transform)
 {
-    mTransform = CGAffineTransformConcat(mTransform, static_cast<const CGSVGTransform&>(other).mTransform);
+    return {transform.a, transform.b, transform.c, transform.d, transform.e, transform.f};
 }
 
 CGSVGImageData::CGSVGImageData(const std::string& base64, ImageEncoding encoding)
@@ -115,14 +105,15 @@ void CGSVGRenderer::Save(const GraphicStyle& graphicStyle)
     SVG_ASSERT(mContext);
     CGContextSaveGState(mContext);
     if (graphicStyle.transform)
-        CGContextConcatCTM(mContext, static_cast<CGSVGTransform*>(graphicStyle.transform.get())->mTransform);
+        CGContextConcatCTM(mContext, ToCGAffineTransform(*graphicStyle.transform));
     if (graphicStyle.clippingPath)
     {
         CGContextBeginPath(mContext);
         auto path = static_cast<const CGSVGPath*>(graphicStyle.clippingPath->path.get())->mPath;
         if (graphicStyle.clippingPath->transform)
         {
-            auto newPath = CGPathCreateCopyByTransformingPath(path, &static_cast<CGSVGTransform*>(graphicStyle.clippingPath->transform.get())->mTransform);
+            auto transform = ToCGAffineTransform(*graphicStyle.clippingPath->transform);
+            auto newPath = CGPathCreateCopyByTransformingPath(path, &transform);
             CGContextAddPath(mContext, newPath);
             CGPathRelease(newPath);
         }
@@ -190,7 +181,7 @@ void CGSVGRenderer::DrawPath(const Path& path, const GraphicStyle& graphicStyle,
             CGContextSaveGState(mContext);
 
             if (gradient.transform)
-                CGContextConcatCTM(mContext, static_cast<CGSVGTransform*>(gradient.transform.get())->mTransform);
+                CGContextConcatCTM(mContext, ToCGAffineTransform(*gradient.transform));
             if (fillStyle.fillRule == WindingRule::kEvenOdd)
                 CGContextEOClip(mContext);
             else
@@ -246,7 +237,7 @@ void CGSVGRenderer::DrawPath(const Path& path, const GraphicStyle& graphicStyle,
             CGContextReplacePathWithStrokedPath(mContext);
             CGContextClip(mContext);
             if (gradient.transform)
-                CGContextConcatCTM(mContext, static_cast<CGSVGTransform*>(gradient.transform.get())->mTransform);
+                CGContextConcatCTM(mContext, ToCGAffineTransform(*gradient.transform));
 
             DrawGradientToContext(gradient, strokeStyle.strokeOpacity);
 
@@ -41,20 +41,6 @@ private:
     float mCurrentY{};
 };
 
-class CGSVGTransform final : public Transform
-{
-public:
-    CGSVGTransform(float a, float b, float c, float d, float tx, float ty);
-
-    void Set(float a, float b, float c, float d, float tx, float ty) override;
-    void Rotate(float r) override;
-    void Translate(float tx, float ty) override;
-    void Scale(float sx, float sy) override;
-    void Concat(const Transform& other) override;
-
-    CGAffineTransform mTransform;
-};
-
 class CGSVGImageData final : public ImageData
 {
 public:
@@ -80,11 +66,9 @@ public:
 
     std::unique_ptr<Path> CreatePath() override { return std::unique_ptr<CGSVGPath>(new CGSVGPath); }
 
-    std::unique_ptr<Transform> CreateTransform(
-        float a = 1.0, float b = 0.0, float c = 0.0, float d = 1.0, float tx = 0.0, float ty = 0.0) override
-    {
-        return std::unique_ptr<CGSVGTransform>(new CGSVGTransform(a, b, c, d, tx, ty));
-    }
+    ImageData* AllocateImageData(const std::string& base64, ImageEncoding encoding, SVGAllocator& allocator) override { return allocator.New<CGSVGImageData>(base64, encoding); }
+
+    Path* AllocatePath(SVGAllocator& allocator) override { return allocator.New<CGSVGPath>(); }
 
     void Save(const GraphicStyle& graphicStyle) override;
     void Restore() override;
@@ -68,17 +68,12 @@ void SkiaSVGPath::CurveToV(float x2, float y2, float x3, float y3)
 
 void SkiaSVGPath::ClosePath() { mPath.close(); }
 
-SkiaSVGTransform::SkiaSVGTransform(float a, float b, float c, float d, float tx, float ty) { Set(a, b, c, d, tx, ty); }
-
-void SkiaSVGTransform::Set(float a, float b, float c, float d, float tx, float ty) { mMatrix.setAll(a, c, tx, b, d, ty, 0, 0, 1); }
-
-void SkiaSVGTransform::Rotate(float degree) { mMatrix.preRotate(degree); }
-
-void SkiaSVGTransform::Translate(float tx, float ty) { mMatrix.preTranslate(tx, ty); }
-
-void SkiaSVGTransform::Scale(float sx, float sy) { mMatrix.preScale(sx, sy, 0.0, 0.0); }
-
-void SkiaSVGTransform::Concat(const Transform& other) { mMatrix.preConcat(static_cast<const SkiaSVGTransform&>(other).mMatrix); }
+static SkMatrix ToSkMatrix(const AffineTransform& transform)
+{
+    SkMatrix matrix;
+    matrix.setAll(transform.a, transform.c, transform.e, transform.b, transform.d, transform.f, 0, 0, 1);
+    return matrix;
+}
 
 SkiaSVGImageData::SkiaSVGImageData(const std::string& base64, ImageEncoding /*encoding*/)
 {
@@ -111,15 +106,12 @@ void SkiaSVGRenderer::Save(const GraphicStyle& graphicStyle)
     else
         mCanvas->save();
     if (graphicStyle.transform)
-        mCanvas->concat(static_cast<SkiaSVGTransform*>(graphicStyle.transform.get())->mMatrix);
+        mCanvas->concat(ToSkMatrix(*graphicStyle.transform));
     if (graphicStyle.clippingPath && graphicStyle.clippingPath->path)
     {
         SkPath clippingPath(static_cast<const SkiaSVGPath*>(graphicStyle.clippingPath->path.get())->mPath);
         if (graphicStyle.clippingPath->transform)
-        {
-            const auto& matrix = static_cast<const SkiaSVGTransform*>(graphicStyle.clippingPath->transform.get())->mMatrix;
-            clippingPath.transform(matrix);
-        }
+            clippingPath.transform(ToSkMatrix(*graphicStyle.clippingPath->transform));
 		clippingPath.setFillType(graphicStyle.clippingPath->clipRule == WindingRule::kNonZero ? SkPath::kWinding_FillType : SkPath::kEvenOdd_FillType);
         mCanvas->clipPath(clippingPath);
     }
@@ -165,9 +157,13 @@ inline void CreateSkPaint(const Paint& paint, float opacity, SkPaint& skPaint)
             mode = SkShader::TileMode::kClamp_TileMode;
             break;
         }
+        SkMatrix gradientMatrix;
         SkMatrix* matrix{};
         if (gradient.transform)
-            matrix = &(static_cast<SkiaSVGTransform*>(gradient.transform.get())->mMatrix);
+        {
+            gradientMatrix = ToSkMatrix(*gradient.transform);
+            matrix = &gradientMatrix;
+        }
         if (gradient.type == GradientType::kLinearGradient)
         {
             SkPoint points[2] = {SkPoint::Make(gradient.x1, gradient.y1), SkPoint::Make(gradient.x2, gradient.y2)};
@@ -12,11 +12,7 @@ governing permissions and limitations under the License.
 
 #include "StringSVGRenderer.h"
 
-#define _USE_MATH_DEFINES
 #include <cmath>
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 
 namespace SVGNative
 {
@@ -52,60 +48,6 @@ void StringSVGPath::ClosePath() { mStringStream << " Z"; }
 
 std::string StringSVGPath::String() const { return mStringStream.str(); }
 
-float deg2rad(float angle);
-float deg2rad(float angle) { return static_cast<float>(M_PI / 180.0 * angle); }
-
-StringSVGTransform::StringSVGTransform(float a, float b, float c, float d, float tx, float ty) { Set(a, b, c, d, tx, ty); }
-
-void StringSVGTransform::Set(float a, float b, float c, float d, float tx, float ty) { mTransform = {a, b, c, d, tx, ty}; }
-
-void StringSVGTransform::Rotate(float r)
-{
-    r = deg2rad(r);
-    float cosAngle = cos(r);
-    float sinAngle = sin(r);
-
-    auto rot = AffineTransform{cosAngle, sinAngle, -sinAngle, cosAngle, 0, 0};
-    Multiply(rot);
-}
-
-void StringSVGTransform::Translate(float tx, float ty)
-{
-    mTransform.e += tx * mTransform.a + ty * mTransform.c;
-    mTransform.f += tx * mTransform.b + ty * mTransform.d;
-}
-
-void StringSVGTransform::Scale(float sx, float sy)
-{
-    mTransform.a *= sx;
-    mTransform.b *= sx;
-    mTransform.c *= sy;
-    mTransform.d *= sy;
-}
-
-void StringSVGTransform::Concat(const Transform& other) { Multiply(static_cast<const StringSVGTransform&>(other).mTransform); }
-
-std::string StringSVGTransform::String() const
-{
-    std::ostringstream stringStream;
-    stringStream.precision(3);
-    stringStream << "matrix(" << mTransform.a << ',' << mTransform.b << ',' << mTransform.c << ',' << mTransform.d << ',' << mTransform.e
-                 << ',' << mTransform.f << ')';
-    return stringStream.str();
-}
-
-void StringSVGTransform::Multiply(const AffineTransform& o)
-{
-    AffineTransform newT;
-    newT.a = o.a * mTransform.a + o.b * mTransform.c;
-    newT.b = o.a * mTransform.b + o.b * mTransform.d;
-    newT.c = o.c * mTransform.a + o.d * mTransform.c;
-    newT.d = o.c * mTransform.b + o.d * mTransform.d;
-    newT.e = o.e * mTransform.a + o.f * mTransform.c + mTransform.e;
-    newT.f = o.e * mTransform.b + o.f * mTransform.d + mTransform.f;
-    mTransform = newT;
-}
-
 StringSVGRenderer::StringSVGRenderer() { mStringStream.precision(3); }
 
 void StringSVGRenderer::Save(const GraphicStyle& graphicStyle)
@@ -220,18 +162,24 @@ void StringSVGRenderer::WriteGraphic(const GraphicStyle& graphicStyle)
     if (graphicStyle.opacity != 1.0)
         mStringStream << " opacity: " << graphicStyle.opacity;
     if (graphicStyle.transform)
-        mStringStream << " transform: " << static_cast<StringSVGTransform*>(graphicStyle.transform.get())->String();
+        WriteTransform(*graphicStyle.transform);
     if (graphicStyle.clippingPath && graphicStyle.clippingPath->path)
     {
         mStringStream << " clipping: {";
         mStringStream << " winding: " << (graphicStyle.clippingPath->clipRule == WindingRule::kNonZero ? "nonzero" : "evenodd");
         if (graphicStyle.clippingPath->transform)
-            mStringStream << " transform: " << static_cast<StringSVGTransform*>(graphicStyle.clippingPath->transform.get())->String();
+            WriteTransform(*graphicStyle.clippingPath->transform);
         mStringStream <<  " [path" << static_cast<const StringSVGPath*>(graphicStyle.clippingPath->path.get())->String();
         mStringStream << "]}";
     }
 }
 
+void StringSVGRenderer::WriteTransform(const AffineTransform& transform)
+{
+    mStringStream << " transform: matrix(" << transform.a << ',' << transform.b << ',' << transform.c << ',' << transform.d << ','
+                  << transform.e << ',' << transform.f << ')';
+}
+
 void StringSVGRenderer::WritePaint(const Paint& paint)
 {
     // FIXME: use static_visitor
@@ -244,7 +192,7 @@ void StringSVGRenderer::WritePaint(const Paint& paint)
         WriteIndent();
         mStringStream << (gradient.type == GradientType::kLinearGradient ? "linearGradient:" : "radialGradient:");
         if (gradient.transform)
-            mStringStream << " transform: " << static_cast<StringSVGTransform*>(gradient.transform.get())->String();
+            WriteTransform(*gradient.transform);
         if (gradient.type == GradientType::kLinearGradient)
         {
             if (std::isfinite(gradient.x1))
@@ -42,46 +42,6 @@ private:
     std::ostringstream mStringStream;
 };
 
-class StringSVGTransform final : public Transform
-{
-public:
-    struct AffineTransform
-    {
-        AffineTransform() = default;
-        AffineTransform(float aA, float aB, float aC, float aD, float aE, float aF)
-            : a{aA}
-            , b{aB}
-            , c{aC}
-            , d{aD}
-            , e{aE}
-            , f{aF}
-        {
-        }
-        float a{1};
-        float b{0};
-        float c{0};
-        float d{1};
-        float e{0};
-        float f{0};
-    };
-
-    StringSVGTransform(float a, float b, float c, float d, float tx, float ty);
-
-    void Set(float a, float b, float c, float d, float tx, float ty) override;
-    void Rotate(float r) override;
-    void Translate(float tx, float ty) override;
-    void Scale(float sx, float sy) override;
-    void Concat(const Transform& other) override;
-
-    std::string String() const;
-
-private:
-    void Multiply(const AffineTransform& o);
-
-private:
-    AffineTransform mTransform{};
-};
-
 class StringSVGImageData final : public ImageData
 {
 public:
@@ -111,11 +71,9 @@ public:
 
     std::unique_ptr<Path> CreatePath() override { return std::unique_ptr<StringSVGPath>(new StringSVGPath); }
 
-    std::unique_ptr<Transform> CreateTransform(
-        float a = 1.0, float b = 0.0, float c = 0.0, float d = 1.0, float tx = 0.0, float ty = 0.0) override
-    {
-        return std::unique_ptr<StringSVGTransform>(new StringSVGTransform(a, b, c, d, tx, ty));
-    }
+    ImageData* AllocateImageData(const std::string& base64, ImageEncoding encoding, SVGAllocator& allocator) override { return allocator.New<StringSVGImageData>(base64, encoding); }
+
+    Path* AllocatePath(SVGAllocator& allocator) override { return allocator.New<StringSVGPath>(); }
 
     void Save(const GraphicStyle& graphicStyle) override;
     void Restore() override;
@@ -135,6 +93,7 @@ private:
     void WriteFill(const FillStyle& fillStyle);
     void WriteStroke(const StrokeStyle& strokeStyle);
     void WriteGraphic(const GraphicStyle& graphicStyle);
+    void WriteTransform(const AffineTransform& transform);
     void WritePaint(const Paint& paint);
 
     size_t mIndent{};
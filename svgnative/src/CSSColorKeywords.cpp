@@ -0,0 +1,143 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "CSSColorKeywords.h"
+
+#include <cstdint>
+
+namespace SVGNative
+{
+namespace
+{
+// FNV-1a with a seed that was searched for offline such that the top
+// kHashBits bits of the hash differ for all color names.
+constexpr std::uint32_t kHashSeed = 27249;
+constexpr std::uint32_t kHashPrime = 16777619;
+constexpr unsigned kHashBits = 10;
+constexpr std::uint8_t kNoColor = 0xFF;
+
+constexpr std::uint32_t HashName(const char* name, std::uint32_t hash = kHashSeed)
+{
+    return *name ? HashName(name + 1, (hash ^ static_cast<std::uint8_t>(*name)) * kHashPrime) : hash;
+}
+
+constexpr std::uint32_t HashSlot(std::uint32_t hash) { return hash >> (32 - kHashBits); }
+
+inline char ToLowerASCII(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+// Slot -> index into gCSSNamedColors. Regenerate together with kHashSeed when
+// changing gCSSNamedColors.
+constexpr std::uint8_t gColorSlots[1 << kHashBits] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 133, 255, 51, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 30, 255,
+    255, 255, 86, 255, 124, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 84, 255, 255, 255, 255, 43, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 11, 255, 255, 113, 255, 255, 255, 67, 255, 49, 255,
+    255, 255, 255, 255, 40, 255, 255, 255, 255, 255, 255, 42, 255, 255, 255, 255,
+    255, 255, 59, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 104, 255, 255, 255, 255, 255, 255, 255, 255, 4, 255,
+    80, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 41, 255, 96,
+    255, 255, 255, 255, 255, 255, 255, 255, 17, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 23, 255, 33, 255, 255, 3, 9, 255, 29, 255, 255, 129, 255, 255, 255,
+    121, 137, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 142, 255, 255, 255, 255, 255, 255, 36, 255, 255, 255, 255, 28, 255,
+    123, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 135, 102, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 37, 255, 255, 117, 255, 255, 255,
+    16, 255, 255, 255, 255, 255, 111, 255, 255, 255, 255, 141, 255, 255, 255, 255,
+    255, 255, 255, 115, 255, 255, 255, 255, 122, 255, 8, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 103, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 147, 120, 255, 255, 19, 255, 255, 255, 255, 255, 255, 255,
+    106, 255, 255, 58, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    88, 94, 101, 255, 255, 255, 255, 107, 255, 255, 255, 70, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 20, 53, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 130, 255, 255, 255,
+    34, 255, 127, 82, 62, 255, 255, 255, 255, 255, 255, 255, 255, 56, 255, 255,
+    255, 255, 255, 44, 255, 255, 255, 116, 255, 255, 255, 255, 255, 255, 68, 255,
+    255, 255, 112, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 143, 255, 255, 27, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 32, 255, 255, 255, 255, 255, 255, 18,
+    255, 255, 255, 255, 255, 255, 255, 255, 10, 255, 255, 255, 126, 65, 255, 255,
+    255, 90, 255, 136, 0, 255, 255, 255, 98, 255, 48, 63, 255, 255, 255, 255,
+    255, 125, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 71, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 85, 255, 255,
+    31, 255, 75, 255, 255, 255, 255, 255, 255, 60, 255, 255, 255, 255, 255, 21,
+    255, 73, 105, 255, 255, 255, 255, 255, 255, 255, 131, 255, 255, 255, 87, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 66, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 118, 255, 6, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 46, 255, 255, 114, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 146, 255, 255, 255, 255, 255, 255,
+    255, 55, 255, 14, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 61, 255, 255, 255, 64, 255, 52, 255, 255, 255, 255, 255,
+    255, 13, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 93, 255, 255, 255, 255, 255, 76, 255, 45, 255, 255, 255, 134,
+    255, 255, 255, 2, 255, 255, 255, 255, 255, 255, 255, 54, 99, 12, 255, 255,
+    255, 74, 255, 255, 255, 255, 144, 255, 255, 255, 255, 255, 255, 35, 255, 255,
+    255, 255, 255, 15, 255, 255, 255, 24, 255, 255, 255, 255, 255, 255, 95, 255,
+    91, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 7, 138, 255, 26, 255, 77, 255, 255, 255, 255, 255, 255,
+    128, 255, 255, 255, 255, 255, 255, 255, 255, 255, 139, 255, 255, 255, 57, 89,
+    255, 255, 39, 255, 255, 255, 255, 255, 255, 255, 255, 78, 255, 255, 255, 255,
+    25, 255, 255, 255, 255, 255, 92, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 38, 255, 255, 119, 255, 255, 255, 255, 255, 255, 79, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 5, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 72,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 145, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 47, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    81, 255, 255, 255, 255, 69, 255, 255, 255, 255, 97, 255, 255, 255, 255, 255,
+    110, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 100, 255, 255, 255, 22,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1, 255, 255, 255, 255,
+    255, 109, 255, 255, 255, 50, 255, 255, 255, 255, 255, 255, 255, 140, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 132, 255, 255, 108, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 83, 255, 255, 255, 255, 255
+};
+
+// Splits the range to stay within the constexpr recursion limits of compilers.
+constexpr size_t CountSlots(size_t begin = 0, size_t end = 1 << kHashBits)
+{
+    return end - begin == 1 ? (gColorSlots[begin] != kNoColor)
+                            : CountSlots(begin, begin + (end - begin) / 2) + CountSlots(begin + (end - begin) / 2, end);
+}
+
+constexpr bool VerifySlots(size_t color = 0)
+{
+    return color == kCSSNamedColorCount
+        || (gColorSlots[HashSlot(HashName(gCSSNamedColors[color].name))] == color && VerifySlots(color + 1));
+}
+
+static_assert(VerifySlots() && CountSlots() == kCSSNamedColorCount, "gColorSlots does not match gCSSNamedColors");
+} // namespace
+
+const Color* FindCSSNamedColor(const char* name, size_t size)
+{
+    std::uint32_t hash = kHashSeed;
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ static_cast<std::uint8_t>(ToLowerASCII(name[i]))) * kHashPrime;
+
+    auto index = gColorSlots[HashSlot(hash)];
+    if (index == kNoColor)
+        return nullptr;
+    // Different names may share the slot of a color name.
+    const auto& namedColor = gCSSNamedColors[index];
+    if (namedColor.size != size)
+        return nullptr;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (ToLowerASCII(name[i]) != namedColor.name[i])
+            return nullptr;
+    }
+    return &namedColor.color;
+}
+
+} // namespace SVGNative
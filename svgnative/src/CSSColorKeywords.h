@@ -13,13 +13,17 @@ governing permissions and limitations under the License.
 #pragma once
 
 #include "SVGRenderer.h"
-#include <array>
-#include <tuple>
+#include <cstddef>
 
 namespace SVGNative
 {
 
-using CSSColorInfo = std::tuple<const char*, size_t, Color>;
+struct CSSColorInfo
+{
+    const char* name;
+    size_t size;
+    Color color;
+};
 
 // Generated in web browser with following code. ele must be an element embedded in a loaded document.
 // var string = '';
@@ -30,7 +34,7 @@ using CSSColorInfo = std::tuple<const char*, size_t, Color>;
 //         + rgb.map(item => { return String(rgb[0] + '.0f / 255.0f').padStart(13)}).join(', ')
 //         + ', 1.0f}}},\n';
 // });
-constexpr std::array<CSSColorInfo, 148> gCSSNamedColors = {{
+constexpr CSSColorInfo gCSSNamedColors[] = {
     CSSColorInfo{"aliceblue"            , 9  , {{240.0f / 255.0f, 248.0f / 255.0f, 255.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"antiquewhite"         , 12 , {{250.0f / 255.0f, 235.0f / 255.0f, 215.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"aqua"                 , 4  , {{  0.0f / 255.0f, 255.0f / 255.0f, 255.0f / 255.0f, 1.0f}}},
@@ -98,7 +102,7 @@ constexpr std::array<CSSColorInfo, 148> gCSSNamedColors = {{
     CSSColorInfo{"lavenderblush"        , 13 , {{255.0f / 255.0f, 240.0f / 255.0f, 245.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"lawngreen"            , 9  , {{124.0f / 255.0f, 252.0f / 255.0f,   0.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"lemonchiffon"         , 12 , {{255.0f / 255.0f, 250.0f / 255.0f, 205.0f / 255.0f, 1.0f}}},
-    CSSColorInfo{"darkslateblue"        , 13 , {{ 72.0f / 255.0f,  61.0f / 255.0f, 139.0f / 255.0f, 1.0f}}},
+    CSSColorInfo{"lightblue"            , 9  , {{173.0f / 255.0f, 216.0f / 255.0f, 230.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"lightcoral"           , 10 , {{240.0f / 255.0f, 128.0f / 255.0f, 128.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"lightcyan"            , 9  , {{224.0f / 255.0f, 255.0f / 255.0f, 255.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"lightgoldenrodyellow" , 20 , {{250.0f / 255.0f, 250.0f / 255.0f, 210.0f / 255.0f, 1.0f}}},
@@ -179,6 +183,15 @@ constexpr std::array<CSSColorInfo, 148> gCSSNamedColors = {{
     CSSColorInfo{"whitesmoke"           , 10 , {{245.0f / 255.0f, 245.0f / 255.0f, 245.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"yellow"               , 6  , {{255.0f / 255.0f, 255.0f / 255.0f,   0.0f / 255.0f, 1.0f}}},
     CSSColorInfo{"yellowgreen"          , 11 , {{154.0f / 255.0f, 205.0f / 255.0f,  50.0f / 255.0f, 1.0f}}}
-}};
+};
+
+constexpr size_t kCSSNamedColorCount = sizeof(gCSSNamedColors) / sizeof(gCSSNamedColors[0]);
+
+/**
+ * Maps a CSS named color to its color value with a single hash table lookup.
+ * ASCII case is ignored.
+ * @return nullptr if name is not a named color.
+ */
+const Color* FindCSSNamedColor(const char* name, size_t size);
 
-}
\ No newline at end of file
+} // namespace SVGNative
@@ -16,6 +16,19 @@ governing permissions and limitations under the License.
 
 namespace SVGNative
 {
+namespace
+{
+// The values stay owned by properties, which must outlive the returned set.
+template <typename CssProperties>
+SVGAttributeSet ToAttributeSet(const CssProperties& properties)
+{
+    SVGAttributeSet attributes;
+    for (const auto& property : properties)
+        attributes.Add(property.first.data(), property.first.size(), property.second.data(), property.second.size());
+    return attributes;
+}
+} // namespace
+
 void SVGDocumentImpl::AddCustomCSS(const StyleSheet::CssDocument* cssDocument) { mOverrideStyle = cssDocument; }
 
 void SVGDocumentImpl::ClearCustomCSS()
@@ -32,7 +45,7 @@ void SVGDocumentImpl::ParseStyle(XMLNode* child)
 
     // StyleSheet Library expects one definition per line, so we need to
     // format the string accordingly.
-    std::string styleSheet = std::string(child->value());
+    std::string styleSheet = std::string(child->value, child->valueSize);
 
     SVG_CSS_TRACE("ParseStyle INPUT:\n" << styleSheet);
 
@@ -85,52 +98,62 @@ void SVGDocumentImpl::ParseStyle(XMLNode* child)
 }
 
 void SVGDocumentImpl::ApplyCSSStyle(
-    const std::set<std::string>& classNames, GraphicStyleImpl& graphicStyle, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle)
+    const ClassNames& classNames, GraphicStyleImpl& graphicStyle, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle) const
 {
     if (!mOverrideStyle)
         return;
 
+    // The property parsers are shared with parsing. Override styles are
+    // deprecated and documents with them must not be rendered concurrently.
+    auto document = const_cast<SVGDocumentImpl*>(this);
+
     for (const auto& className : classNames)
     {
-        auto selector = StyleSheet::CssSelector::CssClassSelector(className);
+        auto selector = StyleSheet::CssSelector::CssClassSelector(className.to_string());
         if (!mOverrideStyle->hasSelector(selector))
             continue;
 
         auto cssElement = mOverrideStyle->getElement(selector);
         auto properties = cssElement.getProperties();
-        ParseGraphicsProperties(graphicStyle, properties);
-        ParseFillProperties(fillStyle, properties);
-        ParseStrokeProperties(strokeStyle, properties);
+        auto propertySet = ToAttributeSet(properties);
+        document->ParseGraphicsProperties(graphicStyle, propertySet);
+        document->ParseFillProperties(fillStyle, propertySet);
+        document->ParseStrokeProperties(strokeStyle, propertySet);
     }
 }
 
-void SVGDocumentImpl::ParseStyleAttr(XMLNode* node, std::vector<PropertySet>& propertySets, std::set<std::string>& classNames)
+void SVGDocumentImpl::ParseStyleAttr(const SVGAttributeSet& attributes, GraphicStyleImpl& graphicStyle,
+    FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle, std::set<std::string>& classNames)
 {
-    auto attr = node->first_attribute("style");
-    if (attr)
+    auto applyProperties = [&](const StyleSheet::CssPropertySet& properties) {
+        auto propertySet = ToAttributeSet(properties);
+        ParseGraphicsProperties(graphicStyle, propertySet);
+        ParseFillProperties(fillStyle, propertySet);
+        ParseStrokeProperties(strokeStyle, propertySet);
+    };
+
+    auto attr = attributes.Get(SVGAttribute::kStyle);
+    if (!attr.empty())
     {
-        auto cssDoc = StyleSheet::CssDocument::parse(attr->value());
+        auto cssDoc = StyleSheet::CssDocument::parse(attr.to_string());
         auto cssElements = cssDoc.getElements();
         if (!cssElements.empty())
-        {
-            propertySets.push_back(cssElements.front().getProperties());
-        }
+            applyProperties(cssElements.front().getProperties());
     }
     // Warning: The inheritance order is incorrect but required by current clients at this point.
     // The code is going to get removed once clients do no longer use "<style>" or
     // override styles.
-    attr = node->first_attribute("class");
-    if (attr)
+    attr = attributes.Get(SVGAttribute::kClass);
+    if (!attr.empty())
     {
         boost::char_separator<char> sep("\n\r\t ");
-        std::string cssString = attr->value();
-        boost::tokenizer<boost::char_separator<char>> tok(cssString, sep);
-        for (boost::tokenizer<boost::char_separator<char>>::iterator it = tok.begin(); it != tok.end(); ++it)
+        boost::tokenizer<boost::char_separator<char>, const char*> tok(attr.begin(), attr.end(), sep);
+        for (auto it = tok.begin(); it != tok.end(); ++it)
         {
             classNames.insert(*it);
             auto selector = StyleSheet::CssSelector::CssClassSelector(*it);
             auto cssElement = mCSSInfo.getElement(selector);
-            propertySets.push_back(cssElement.getProperties());
+            applyProperties(cssElement.getProperties());
         }
     }
 }
@@ -0,0 +1,50 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace SVGNative
+{
+/**
+ * Private copy-on-write mapping of a file. The mapped content is writable, so
+ * it can be parsed in place. Writes never reach the file on disk.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Maps the file at path. Any previous mapping gets released.
+     * @return false if the file could not be opened or mapped.
+     */
+    bool Open(const char* path);
+    void Close();
+
+    /**
+     * @return The content of the file or nullptr if the file is empty.
+     */
+    char* Data() { return mData; }
+    size_t Size() const { return mSize; }
+
+private:
+    char* mData{};
+    size_t mSize{};
+};
+
+} // namespace SVGNative
@@ -0,0 +1,117 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGArena.h"
+#include "Config.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace SVGNative
+{
+constexpr size_t SVGArena::kMinBlockSize;
+constexpr size_t SVGArena::kMaxBlockSize;
+
+// Data of a block follows its header, aligned for any type.
+static constexpr size_t kBlockHeaderSize = (2 * sizeof(void*) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+SVGArena::~SVGArena()
+{
+    for (auto destructor = mDestructors; destructor != nullptr; destructor = destructor->next)
+        destructor->destroy(destructor->object);
+    while (mBlocks)
+    {
+        auto next = mBlocks->next;
+        ::operator delete(mBlocks);
+        mBlocks = next;
+    }
+}
+
+void* SVGArena::Allocate(size_t size, size_t alignment)
+{
+    SVG_ASSERT(alignment && alignment <= alignof(std::max_align_t));
+    auto padding = (alignment - reinterpret_cast<std::uintptr_t>(mBlockPos) % alignment) % alignment;
+    if (!mBlockPos || size + padding > mBlockRemaining)
+    {
+        auto blockSize = std::max(size, mNextBlockSize);
+        mNextBlockSize = std::min(mNextBlockSize * 2, kMaxBlockSize);
+        auto block = static_cast<Block*>(::operator new(kBlockHeaderSize + blockSize));
+        block->next = mBlocks;
+        block->size = blockSize;
+        mBlocks = block;
+        mBlockPos = reinterpret_cast<char*>(block) + kBlockHeaderSize;
+        mBlockRemaining = blockSize;
+        padding = 0;
+    }
+    auto result = mBlockPos + padding;
+    mBlockPos += padding + size;
+    mBlockRemaining -= padding + size;
+    mSize += size;
+    return result;
+}
+
+boost::string_view SVGArena::CopyString(boost::string_view string)
+{
+    if (string.empty())
+        return {};
+    auto copy = static_cast<char*>(Allocate(string.size(), 1));
+    memcpy(copy, string.data(), string.size());
+    return {copy, string.size()};
+}
+
+void SVGArena::AddDestructor(void (*destroy)(void*), void* object)
+{
+    mDestructors = new (Allocate(sizeof(Destructor), alignof(Destructor))) Destructor{destroy, object, mDestructors};
+    if (!mOldestDestructor)
+        mOldestDestructor = mDestructors;
+}
+
+void SVGArena::Merge(SVGArena& other)
+{
+    if (&other == this)
+        return;
+
+    // Objects of other get destroyed first.
+    if (other.mDestructors)
+    {
+        other.mOldestDestructor->next = mDestructors;
+        if (!mOldestDestructor)
+            mOldestDestructor = other.mOldestDestructor;
+        mDestructors = other.mDestructors;
+    }
+    if (other.mBlocks)
+    {
+        auto last = other.mBlocks;
+        while (last->next)
+            last = last->next;
+        last->next = mBlocks;
+        mBlocks = other.mBlocks;
+        // Continue in the block of other if there is none yet.
+        if (!mBlockPos)
+        {
+            mBlockPos = other.mBlockPos;
+            mBlockRemaining = other.mBlockRemaining;
+        }
+    }
+    mSize += other.mSize;
+
+    other.mBlocks = nullptr;
+    other.mDestructors = nullptr;
+    other.mOldestDestructor = nullptr;
+    other.mBlockPos = nullptr;
+    other.mBlockRemaining = 0;
+    other.mSize = 0;
+}
+
+} // namespace SVGNative
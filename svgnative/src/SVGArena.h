@@ -0,0 +1,83 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "SVGRenderer.h"
+
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+
+namespace SVGNative
+{
+/**
+ * Monotonic allocator owning the element tree of one document together with
+ * the paths and images the renderer creates for it. Memory gets allocated in
+ * growing blocks and is released as a whole when the arena gets destroyed.
+ * Destructor records live in the blocks as well.
+ */
+class SVGArena final : public SVGAllocator
+{
+public:
+    SVGArena() = default;
+    SVGArena(const SVGArena&) = delete;
+    SVGArena& operator=(const SVGArena&) = delete;
+    ~SVGArena() override;
+
+    void* Allocate(size_t size, size_t alignment) override;
+    void AddDestructor(void (*destroy)(void*), void* object) override;
+
+    /**
+     * @return Copy of string in the arena.
+     */
+    boost::string_view CopyString(boost::string_view string);
+
+    /**
+     * Takes over all blocks and objects of other, which is empty afterwards.
+     * Lets a document keep the elements that worker threads parsed into
+     * arenas of their own.
+     */
+    void Merge(SVGArena& other);
+
+    /**
+     * @return Bytes handed out so far.
+     */
+    size_t Size() const { return mSize; }
+
+private:
+    struct Block
+    {
+        Block* next;
+        size_t size;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+        Destructor* next;
+    };
+
+    // Newest first.
+    Block* mBlocks{};
+    Destructor* mDestructors{};
+    Destructor* mOldestDestructor{};
+    char* mBlockPos{};
+    size_t mBlockRemaining{};
+    size_t mNextBlockSize{kMinBlockSize};
+    size_t mSize{};
+
+    static constexpr size_t kMinBlockSize = 4 * 1024;
+    static constexpr size_t kMaxBlockSize = 64 * 1024;
+};
+
+} // namespace SVGNative
@@ -0,0 +1,128 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGAttributes.h"
+
+#include <cstring>
+
+namespace SVGNative
+{
+namespace
+{
+// Same order as SVGAttribute.
+constexpr const char* gAttributeNames[kSVGAttributeCount] = {
+    "color",
+    "clip-rule",
+    "fill",
+    "fill-rule",
+    "fill-opacity",
+    "stroke",
+    "stroke-dasharray",
+    "stroke-dashoffset",
+    "stroke-linecap",
+    "stroke-linejoin",
+    "stroke-miterlimit",
+    "stroke-opacity",
+    "stroke-width",
+    "visibility",
+    "clip-path",
+    "display",
+    "opacity",
+    "stop-opacity",
+    "stop-color",
+    "class",
+    "cx",
+    "cy",
+    "d",
+    "data-name",
+    "fx",
+    "fy",
+    "gradientTransform",
+    "height",
+    "id",
+    "offset",
+    "points",
+    "preserveAspectRatio",
+    "r",
+    "rx",
+    "ry",
+    "spreadMethod",
+    "style",
+    "transform",
+    "viewBox",
+    "width",
+    "x",
+    "x1",
+    "x2",
+    "xlink:href",
+    "y",
+    "y1",
+    "y2"
+};
+
+// FNV-1a with a seed that was searched for offline such that the top
+// kHashBits bits of the hash differ for all names above.
+constexpr std::uint32_t kHashSeed = 1148319;
+constexpr std::uint32_t kHashPrime = 16777619;
+constexpr unsigned kHashBits = 7;
+constexpr std::uint8_t kNoAttribute = 0xFF;
+
+constexpr std::uint32_t HashName(const char* name, std::uint32_t hash = kHashSeed)
+{
+    return *name ? HashName(name + 1, (hash ^ static_cast<std::uint8_t>(*name)) * kHashPrime) : hash;
+}
+
+constexpr std::uint32_t HashSlot(std::uint32_t hash) { return hash >> (32 - kHashBits); }
+
+// Slot -> SVGAttribute. Regenerate together with kHashSeed when adding attributes.
+constexpr std::uint8_t gAttributeSlots[1 << kHashBits] = {
+    44, 40, 255, 2, 32, 39, 1, 255, 255, 255, 255, 22, 255, 255, 0, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 11, 255, 255, 255, 255, 37,
+    6, 255, 8, 16, 255, 255, 255, 255, 14, 255, 255, 31, 255, 12, 30, 255,
+    29, 255, 3, 255, 27, 38, 255, 18, 255, 9, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 23, 255, 255, 255, 255, 255, 43, 255, 255, 255, 46,
+    45, 4, 41, 255, 42, 255, 255, 255, 255, 255, 19, 255, 255, 255, 5, 255,
+    17, 10, 255, 15, 255, 255, 35, 36, 255, 26, 28, 255, 255, 255, 7, 255,
+    255, 255, 255, 255, 25, 24, 20, 21, 34, 33, 13, 255, 255, 255, 255, 255
+};
+
+constexpr size_t CountSlots(size_t slot = 0)
+{
+    return slot == (1 << kHashBits) ? 0 : (gAttributeSlots[slot] != kNoAttribute) + CountSlots(slot + 1);
+}
+
+constexpr bool VerifySlots(size_t attribute = 0)
+{
+    return attribute == kSVGAttributeCount
+        || (gAttributeSlots[HashSlot(HashName(gAttributeNames[attribute]))] == attribute && VerifySlots(attribute + 1));
+}
+
+static_assert(VerifySlots() && CountSlots() == kSVGAttributeCount, "gAttributeSlots does not match gAttributeNames");
+} // namespace
+
+SVGAttribute ClassifySVGAttribute(const char* name, size_t size)
+{
+    std::uint32_t hash = kHashSeed;
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ static_cast<std::uint8_t>(name[i])) * kHashPrime;
+
+    auto attribute = gAttributeSlots[HashSlot(hash)];
+    if (attribute == kNoAttribute)
+        return SVGAttribute::kUnknown;
+    // Different names may share the slot of a known name.
+    const char* candidate = gAttributeNames[attribute];
+    if (strlen(candidate) != size || memcmp(candidate, name, size) != 0)
+        return SVGAttribute::kUnknown;
+    return static_cast<SVGAttribute>(attribute);
+}
+
+} // namespace SVGNative
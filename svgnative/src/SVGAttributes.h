@@ -0,0 +1,119 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <array>
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace SVGNative
+{
+/**
+ * All attributes and CSS properties the parser understands. The first
+ * entries are the presentation attributes.
+ */
+enum class SVGAttribute : std::uint8_t
+{
+    // Inherited presentation attributes
+    kColor,
+    kClipRule,
+    kFill,
+    kFillRule,
+    kFillOpacity,
+    kStroke,
+    kStrokeDasharray,
+    kStrokeDashoffset,
+    kStrokeLinecap,
+    kStrokeLinejoin,
+    kStrokeMiterlimit,
+    kStrokeOpacity,
+    kStrokeWidth,
+    kVisibility,
+    // Non-inherited presentation attributes
+    kClipPath,
+    kDisplay,
+    kOpacity,
+    kStopOpacity,
+    kStopColor,
+    // Other attributes
+    kClass,
+    kCx,
+    kCy,
+    kD,
+    kDataName,
+    kFx,
+    kFy,
+    kGradientTransform,
+    kHeight,
+    kId,
+    kOffset,
+    kPoints,
+    kPreserveAspectRatio,
+    kR,
+    kRx,
+    kRy,
+    kSpreadMethod,
+    kStyle,
+    kTransform,
+    kViewBox,
+    kWidth,
+    kX,
+    kX1,
+    kX2,
+    kXlinkHref,
+    kY,
+    kY1,
+    kY2,
+
+    kUnknown
+};
+
+constexpr size_t kSVGAttributeCount = static_cast<size_t>(SVGAttribute::kUnknown);
+
+/**
+ * Maps an attribute or CSS property name to its SVGAttribute with a single
+ * hash table lookup.
+ * @return SVGAttribute::kUnknown for all names the parser does not handle.
+ */
+SVGAttribute ClassifySVGAttribute(const char* name, size_t size);
+
+/**
+ * Values of all known attributes of one element, or of the properties of one
+ * CSS declaration block, indexed by SVGAttribute. Values are not copied and
+ * must outlive the set.
+ */
+class SVGAttributeSet
+{
+public:
+    // Keeps the first value of repeated attributes.
+    void Add(const char* name, size_t nameSize, const char* value, size_t valueSize)
+    {
+        Add(ClassifySVGAttribute(name, nameSize), value, valueSize);
+    }
+
+    void Add(SVGAttribute attribute, const char* value, size_t valueSize)
+    {
+        if (attribute != SVGAttribute::kUnknown && !Has(attribute))
+            mValues[static_cast<size_t>(attribute)] = boost::string_view{value, valueSize};
+    }
+
+    // Empty for missing attributes.
+    boost::string_view Get(SVGAttribute attribute) const { return mValues[static_cast<size_t>(attribute)]; }
+    bool Has(SVGAttribute attribute) const { return Get(attribute).data() != nullptr; }
+
+private:
+    std::array<boost::string_view, kSVGAttributeCount> mValues;
+};
+
+} // namespace SVGNative
@@ -11,44 +11,282 @@ governing permissions and limitations under the License.
 */
 
 #include "SVGDocument.h"
+#include "MappedFile.h"
+#include "SVGDocumentBuilder.h"
 #include "SVGDocumentImpl.h"
+#include "SVGDocumentSerializer.h"
+#include "SVGImageCache.h"
+#include "SVGParserContext.h"
 #include "SVGRenderer.h"
+#include "XMLTokenizer.h"
 #ifdef STYLE_SUPPORT
 #include "StyleSheet/Document.h"
 #include "StyleSheet/Parser.h"
 #endif
 
 #include <boost/algorithm/string/replace.hpp>
-#include <boost/property_tree/detail/xml_parser_read_rapidxml.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/version.hpp>
 #include <stdexcept>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
-
-using namespace boost::property_tree::detail::rapidxml;
+#include <vector>
 
 namespace SVGNative
 {
 std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocument(const char* s, std::shared_ptr<SVGRenderer> renderer)
 {
+    if (!s)
+        return nullptr;
+    return CreateSVGDocument(s, strlen(s), renderer);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocument(const char* s, size_t length, std::shared_ptr<SVGRenderer> renderer)
+{
+    if (!s)
+        return nullptr;
+    // Never write to the caller's buffer. Values with entities get decoded
+    // into the XML tree instead.
+    return CreateSVGDocumentFromBuffer(s, nullptr, length, renderer);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocument(
+    const char* s, size_t length, std::shared_ptr<SVGRenderer> renderer, ParseError& error, const ParseLimits& limits)
+{
+    // The builder never throws on malformed content and does not need a
+    // NUL-terminated or writable buffer.
+    if (!s)
+    {
+        error = ParseError{};
+        error.code = ParseErrorCode::kNoRootElement;
+        return nullptr;
+    }
+    SVGDocumentBuilder builder{renderer, limits};
+    auto document = builder.Feed(s, length) ? builder.Finish() : nullptr;
+    error = builder.Error();
+    return document;
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocument(
+    const char* s, size_t length, std::shared_ptr<SVGRenderer> renderer, SVGParserContext& context)
+{
+    if (!s)
+        return nullptr;
+    return CreateSVGDocumentFromBuffer(s, nullptr, length, renderer, 1, context.mImpl.get());
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocumentParallel(
+    const char* s, size_t length, std::shared_ptr<SVGRenderer> renderer, unsigned threadCount)
+{
+    if (!s)
+        return nullptr;
+    return CreateSVGDocumentFromBuffer(s, nullptr, length, renderer, threadCount);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocument(std::string&& s, std::shared_ptr<SVGRenderer> renderer)
+{
+    // Moved in so that entities can be decoded in place without a copy. The
+    // document keeps nothing from the buffer.
+    std::string buffer{std::move(s)};
+    return CreateSVGDocumentFromBuffer(&buffer[0], &buffer[0], buffer.size(), renderer);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocument(std::vector<char>&& s, std::shared_ptr<SVGRenderer> renderer)
+{
+    // Moved in for in-place decoding, like the std::string overload.
+    std::vector<char> buffer{std::move(s)};
+    return CreateSVGDocumentFromBuffer(buffer.data(), buffer.data(), buffer.size(), renderer);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocumentLazy(std::vector<char>&& s, std::shared_ptr<SVGRenderer> renderer)
+{
+#ifndef SVG_NO_EXCEPTIONS
     try
+#endif
     {
         auto realSVGDoc = std::unique_ptr<SVGDocumentImpl>(new SVGDocumentImpl(renderer));
-        realSVGDoc->mXMLDocument.parse<0>((char*)s); // 0 means default parse flags
-        realSVGDoc->TraverseSVGTree();
-        realSVGDoc->mXMLDocument.clear();
+        auto& source = realSVGDoc->mSource;
+        source = std::move(s);
+
+        realSVGDoc->mLazyGeometry = true;
+        XMLDocument xmlDocument;
+        if (!xmlDocument.Parse(source.data(), source.size(), source.data()))
+            return nullptr;
+        realSVGDoc->TraverseSVGTree(xmlDocument.RootNode());
+        realSVGDoc->FinishParsing();
+        if (realSVGDoc->LimitError() != ParseErrorCode::kNone)
+            return nullptr;
+
+        auto retval = new SVGDocument();
+        retval->mDocument = std::move(realSVGDoc);
+
+        return std::unique_ptr<SVGDocument>(retval);
+    }
+#ifndef SVG_NO_EXCEPTIONS
+    catch (...)
+    {
+    }
+
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateFromFile(const char* path, std::shared_ptr<SVGRenderer> renderer, LoadStatus* status)
+{
+    MappedFile file;
+    if (!path || !file.Open(path))
+    {
+        if (status)
+            *status = LoadStatus::kFileError;
+        return nullptr;
+    }
+
+    auto document = CreateSVGDocumentFromBuffer(file.Data(), file.Data(), file.Size(), renderer);
+    if (status)
+        *status = document ? LoadStatus::kSuccess : LoadStatus::kParseError;
+    return document;
+}
+
+static void AddProbedAttribute(void* context, const XMLAttribute& attribute)
+{
+    static_cast<SVGAttributeSet*>(context)->Add(attribute.name, attribute.nameSize, attribute.value, attribute.valueSize);
+}
+
+SVGDimensions SVGDocument::Probe(const char* s, size_t length)
+{
+    SVGDimensions dimensions;
+    if (!s)
+        return dimensions;
+
+    auto pos = s;
+    auto end = s + length;
+    if (length >= 3 && memcmp(pos, "\xEF\xBB\xBF", 3) == 0)
+        pos += 3;
+
+    // Skip the XML declaration, DOCTYPE, comments and whitespace before the root element.
+    XMLToken token;
+    while (pos != end)
+    {
+        if (*pos == '<' && end - pos > 1 && pos[1] != '?' && pos[1] != '!' && pos[1] != '/')
+        {
+            SVGAttributeSet attributes;
+            if (ReadXMLStartTag(pos, end, token, AddProbedAttribute, &attributes) != XMLTokenType::kStartElement
+                || ClassifySVGElement(token.name, token.nameSize) != SVGElement::kSvg)
+                return dimensions;
+
+            std::array<float, 4> viewBox{{dimensions.x, dimensions.y, dimensions.width, dimensions.height}};
+            SVGDocumentImpl::ParseViewBox(attributes, viewBox);
+            dimensions.isValid = true;
+            dimensions.x = viewBox[0];
+            dimensions.y = viewBox[1];
+            dimensions.width = viewBox[2];
+            dimensions.height = viewBox[3];
+            return dimensions;
+        }
+
+        auto tokenType = ReadXMLToken(pos, end, true, token);
+        if (tokenType == XMLTokenType::kText)
+        {
+            for (size_t i = 0; i < token.textSize; ++i)
+            {
+                char c = token.text[i];
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                    return dimensions;
+            }
+        }
+        else if (tokenType != XMLTokenType::kSkipped)
+            return dimensions;
+    }
+    return dimensions;
+}
+
+bool SVGDocument::CompileSVGDocument(const char* s, std::shared_ptr<SVGRenderer> renderer, std::vector<char>& binary)
+{
+    auto document = CreateSVGDocument(s, renderer);
+    if (!document)
+        return false;
+    return SVGDocumentSerializer::Serialize(*document->mDocument, binary);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateFromBinary(const char* data, size_t length, std::shared_ptr<SVGRenderer> renderer)
+{
+    auto realSVGDoc = SVGDocumentSerializer::Deserialize(data, length, renderer);
+    if (!realSVGDoc)
+        return nullptr;
+
+    auto retval = new SVGDocument();
+    retval->mDocument = std::move(realSVGDoc);
+    return std::unique_ptr<SVGDocument>(retval);
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateFromBinaryFile(const char* path, std::shared_ptr<SVGRenderer> renderer, LoadStatus* status)
+{
+    MappedFile file;
+    if (!path || !file.Open(path))
+    {
+        if (status)
+            *status = LoadStatus::kFileError;
+        return nullptr;
+    }
+
+    auto document = CreateFromBinary(file.Data(), file.Size(), renderer);
+    if (status)
+        *status = document ? LoadStatus::kSuccess : LoadStatus::kParseError;
+    return document;
+}
+
+std::unique_ptr<SVGDocument> SVGDocument::CreateSVGDocumentFromBuffer(const char* s, char* writable, size_t length,
+    std::shared_ptr<SVGRenderer> renderer, unsigned threadCount, SVGParserContextImpl* context)
+{
+#ifndef SVG_NO_EXCEPTIONS
+    try
+#endif
+    {
+        XMLDocument localXMLDocument;
+        auto& xmlDocument = context ? context->xmlDocument : localXMLDocument;
+        auto realSVGDoc = std::unique_ptr<SVGDocumentImpl>(new SVGDocumentImpl(renderer, context ? &context->parseState : nullptr));
+        if (!xmlDocument.Parse(s, length, writable))
+            return nullptr;
+        if (threadCount == 1)
+            realSVGDoc->TraverseSVGTree(xmlDocument.RootNode());
+        else
+            realSVGDoc->TraverseSVGTreeParallel(xmlDocument.RootNode(), threadCount);
+        realSVGDoc->FinishParsing();
+        xmlDocument.Clear();
+        if (realSVGDoc->LimitError() != ParseErrorCode::kNone)
+            return nullptr;
 
         auto retval = new SVGDocument();
         retval->mDocument = std::move(realSVGDoc);
 
         return std::unique_ptr<SVGDocument>(retval);
     }
+#ifndef SVG_NO_EXCEPTIONS
     catch (...)
     {
     }
 
     return nullptr;
+#endif
+}
+
+SVGParserContext::SVGParserContext()
+    : mImpl{new SVGParserContextImpl}
+{
+}
+
+SVGParserContext::~SVGParserContext() {}
+
+SVGImageCache::SVGImageCache()
+    : mImpl{new SVGImageCacheImpl}
+{
 }
 
+SVGImageCache::~SVGImageCache() {}
+
+void SVGImageCache::Clear() { mImpl->Clear(); }
+
 SVGDocument::SVGDocument() {}
 
 SVGDocument::~SVGDocument() {}
@@ -72,6 +310,16 @@ void SVGDocument::Render(const ColorMap& colorMap)
 
 void SVGDocument::Render(const ColorMap& colorMap, float width, float height) { mDocument->Render(colorMap, width, height); }
 
+void SVGDocument::Render(SVGRenderer& renderer, const ColorMap& colorMap, float width, float height) const
+{
+    mDocument->Render(renderer, colorMap, width, height);
+}
+
+void SVGDocument::Render(SVGRenderer& renderer, const ColorMap& colorMap, float width, float height, SVGImageCache& imageCache) const
+{
+    mDocument->Render(renderer, colorMap, width, height, imageCache.mImpl.get());
+}
+
 std::int32_t SVGDocument::Width() const { return static_cast<std::int32_t>(mDocument->mViewBox[2]); }
 
 std::int32_t SVGDocument::Height() const { return static_cast<std::int32_t>(mDocument->mViewBox[3]); }
@@ -84,3 +332,19 @@ void SVGDocument::AddCustomCSS(const StyleSheet::CssDocument* cssDocument) { mDo
 void SVGDocument::ClearCustomCSS() { mDocument->ClearCustomCSS(); }
 #endif
 } // namespace SVGNative
+
+#if defined(SVG_NO_EXCEPTIONS) && defined(BOOST_NO_EXCEPTIONS)
+namespace boost
+{
+/**
+ * Boost requires the embedder to provide these hooks when exceptions are
+ * disabled. They are only reached on programming errors (e.g. a bad variant
+ * access), so there is nothing better to do than to stop.
+ */
+void throw_exception(const std::exception&) { abort(); }
+
+#if BOOST_VERSION >= 107300
+void throw_exception(const std::exception&, const boost::source_location&) { abort(); }
+#endif
+} // namespace boost
+#endif
@@ -0,0 +1,477 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGDocumentBuilder.h"
+#include "SVGDocumentImpl.h"
+#include "SVGRenderer.h"
+#include "XMLTokenizer.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace SVGNative
+{
+/**
+ * Container elements (<svg>, <g>, <symbol> and <defs>) are opened on their
+ * start tag and closed on their end tag. Only the attributes of containers
+ * are kept until the container is opened. All other elements are collected
+ * into a small XML tree and parsed as soon as their end tag arrives. The tree
+ * gets discarded afterwards unless the element may be referenced by <use>.
+ * Elements that reference definitions which did not arrive yet get copied
+ * and parsed again by Finish().
+ * The content of unsupported elements is skipped without collecting it.
+ */
+class SVGDocumentBuilderImpl
+{
+public:
+    SVGDocumentBuilderImpl(std::shared_ptr<SVGRenderer> renderer, const ParseLimits& limits)
+        : mDocument{new SVGDocumentImpl(renderer)}
+        , mSubtreeDocument{new XMLDocument}
+        , mLimits{limits}
+    {
+        mDocument->SetLimits(limits);
+    }
+
+    bool Feed(const char* data, size_t length);
+    std::unique_ptr<SVGDocumentImpl> Finish();
+    const ParseError& Error() const { return mError; }
+
+private:
+    enum class FrameType
+    {
+        kContainer,
+        kSubtree,
+        kIgnored
+    };
+
+    struct Frame
+    {
+        FrameType type;
+        SVGDocumentImpl::ContainerType containerType;
+        XMLNode* node;
+        // Size of mElementPath without this element.
+        size_t parentPathSize;
+    };
+
+    bool Consume(const char*& pos, const char* end, bool isFinal);
+    bool Fail(ParseErrorCode code, size_t offset);
+    bool CheckLimits(size_t offset);
+    void HandleStartElement();
+    bool HandleEndElement();
+    void PushFrame(FrameType type, SVGDocumentImpl::ContainerType containerType, XMLNode* node);
+    void HandleText(XMLNodeType type);
+    void ParseSubtree(XMLNode* node, bool isResource);
+
+    XMLNode* CreateNode(XMLDocument& xmlDocument, SVGElement element);
+
+    std::unique_ptr<SVGDocumentImpl> mDocument;
+    std::vector<Frame> mFrames;
+
+    // Attributes of the root element and of containers. Cleared after use.
+    XMLDocument mAttributeDocument;
+    // Tree of the element currently being collected.
+    std::unique_ptr<XMLDocument> mSubtreeDocument;
+    // Trees with elements that can be referenced by <use>.
+    std::vector<std::unique_ptr<XMLDocument>> mRetainedDocuments;
+    // Bytes allocated in mRetainedDocuments.
+    size_t mRetainedBytes{};
+    // Copies of the elements that wait for definitions, see ParseSubtree().
+    XMLDocument mDeferredDocument;
+    ParseLimits mLimits;
+
+    // Incomplete token at the end of the last chunk.
+    std::string mPending;
+    bool mHasIncompleteToken{};
+    XMLToken mToken;
+    // Offset of the first byte not consumed yet.
+    size_t mOffset{};
+    // Names of all open elements for error reports.
+    std::string mElementPath;
+
+    bool mHasRoot{};
+    bool mFailed{};
+    ParseError mError;
+};
+
+bool SVGDocumentBuilderImpl::Feed(const char* data, size_t length)
+{
+    if (mFailed || !mDocument)
+        return false;
+    if (!length)
+        return true;
+
+#ifndef SVG_NO_EXCEPTIONS
+    try
+#endif
+    {
+        if (mPending.empty())
+        {
+            // Parse straight from the chunk and only keep the incomplete rest.
+            auto pos = data;
+            auto end = data + length;
+            if (!Consume(pos, end, false))
+                return false;
+            mPending.assign(pos, end);
+            return CheckLimits(mOffset);
+        }
+
+        // Incomplete tokens can only end with a '>' or get terminated by the '<' of the
+        // next tag. Avoid rescanning large tokens (like long path data) for every chunk.
+        bool mayComplete = !mHasIncompleteToken || memchr(data, '>', length) || memchr(data, '<', length);
+        mPending.append(data, length);
+        if (!mayComplete)
+            return CheckLimits(mOffset);
+
+        const char* begin = mPending.data();
+        auto pos = begin;
+        if (!Consume(pos, begin + mPending.size(), false))
+            return false;
+        mPending.erase(0, static_cast<size_t>(pos - begin));
+    }
+#ifndef SVG_NO_EXCEPTIONS
+    catch (...)
+    {
+        Fail(ParseErrorCode::kException, mOffset);
+    }
+#endif
+    return !mFailed;
+}
+
+std::unique_ptr<SVGDocumentImpl> SVGDocumentBuilderImpl::Finish()
+{
+    if (mFailed || !mDocument)
+        return nullptr;
+
+#ifndef SVG_NO_EXCEPTIONS
+    try
+#endif
+    {
+        const char* begin = mPending.data();
+        auto pos = begin;
+        if (!Consume(pos, begin + mPending.size(), true))
+            return nullptr;
+        mPending.clear();
+    }
+#ifndef SVG_NO_EXCEPTIONS
+    catch (...)
+    {
+        Fail(ParseErrorCode::kException, mOffset);
+        return nullptr;
+    }
+#endif
+
+    if (!mHasRoot)
+    {
+        Fail(ParseErrorCode::kNoRootElement, mOffset);
+        return nullptr;
+    }
+    if (!mFrames.empty())
+    {
+        Fail(ParseErrorCode::kUnexpectedEnd, mOffset);
+        return nullptr;
+    }
+
+    mDocument->ParseDeferredElements();
+    if (!CheckLimits(mOffset))
+        return nullptr;
+    mDocument->FinishParsing();
+    mRetainedDocuments.clear();
+    mDeferredDocument.Clear();
+    return std::move(mDocument);
+}
+
+bool SVGDocumentBuilderImpl::Fail(ParseErrorCode code, size_t offset)
+{
+    mFailed = true;
+    mError.code = code;
+    mError.offset = offset;
+    mError.elementPath = mElementPath;
+    return false;
+}
+
+bool SVGDocumentBuilderImpl::CheckLimits(size_t offset)
+{
+    auto error = mDocument->LimitError();
+    if (error != ParseErrorCode::kNone)
+        return Fail(error, offset);
+    if (mFrames.size() > mLimits.maxDepth)
+        return Fail(ParseErrorCode::kDepthLimitExceeded, offset);
+    if (mPending.size() + mSubtreeDocument->Size() + mRetainedBytes + mDeferredDocument.Size() > mLimits.maxMemory)
+        return Fail(ParseErrorCode::kMemoryLimitExceeded, offset);
+    return true;
+}
+
+bool SVGDocumentBuilderImpl::Consume(const char*& pos, const char* end, bool isFinal)
+{
+    mHasIncompleteToken = false;
+    while (pos != end)
+    {
+        auto tokenStart = pos;
+        auto tokenOffset = mOffset;
+        auto tokenType = ReadXMLToken(pos, end, isFinal, mToken);
+        mOffset += static_cast<size_t>(pos - tokenStart);
+        switch (tokenType)
+        {
+        case XMLTokenType::kIncomplete:
+            mHasIncompleteToken = true;
+            return true;
+        case XMLTokenType::kError:
+        {
+            // Tokens that are cut off by the end of the content are errors on the final call as well.
+            auto truncatedPos = pos;
+            bool isTruncated = isFinal && ReadXMLToken(truncatedPos, end, false, mToken) == XMLTokenType::kIncomplete;
+            return Fail(isTruncated ? ParseErrorCode::kUnexpectedEnd : ParseErrorCode::kInvalidXML, tokenOffset);
+        }
+        case XMLTokenType::kStartElement:
+            HandleStartElement();
+            if (!CheckLimits(tokenOffset))
+                return false;
+            if (mToken.isEmptyElement)
+                HandleEndElement();
+            if (!CheckLimits(tokenOffset))
+                return false;
+            break;
+        case XMLTokenType::kEndElement:
+            if (!HandleEndElement())
+                return Fail(ParseErrorCode::kUnexpectedEndTag, tokenOffset);
+            if (!CheckLimits(tokenOffset))
+                return false;
+            break;
+        case XMLTokenType::kText:
+            HandleText(XMLNodeType::kData);
+            if (!CheckLimits(tokenOffset))
+                return false;
+            break;
+        case XMLTokenType::kCData:
+            HandleText(XMLNodeType::kCData);
+            if (!CheckLimits(tokenOffset))
+                return false;
+            break;
+        case XMLTokenType::kSkipped:
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+void SVGDocumentBuilderImpl::HandleStartElement()
+{
+    if (mFrames.empty())
+    {
+        // Only the first top-level element is parsed.
+        if (mHasRoot)
+        {
+            PushFrame(FrameType::kIgnored, SVGDocumentImpl::ContainerType::kNone, nullptr);
+            return;
+        }
+        mHasRoot = true;
+        auto node = CreateNode(mAttributeDocument, ClassifySVGElement(mToken.name, mToken.nameSize));
+        bool isSVG = mDocument->ParseSVGRoot(node);
+        mAttributeDocument.Clear();
+        PushFrame(isSVG ? FrameType::kContainer : FrameType::kIgnored, SVGDocumentImpl::ContainerType::kNone, nullptr);
+        return;
+    }
+
+    const auto& parent = mFrames.back();
+    if (parent.type == FrameType::kIgnored)
+    {
+        PushFrame(FrameType::kIgnored, SVGDocumentImpl::ContainerType::kNone, nullptr);
+        return;
+    }
+
+    auto element = ClassifySVGElement(mToken.name, mToken.nameSize);
+    switch (parent.type)
+    {
+    case FrameType::kSubtree:
+    {
+        // Unsupported elements stay in the tree without content, like in XMLDocument::Parse().
+        auto node = CreateNode(*mSubtreeDocument, element);
+        mSubtreeDocument->AppendNode(parent.node, node);
+        if (element == SVGElement::kUnknown)
+            PushFrame(FrameType::kIgnored, SVGDocumentImpl::ContainerType::kNone, nullptr);
+        else
+            PushFrame(FrameType::kSubtree, SVGDocumentImpl::ContainerType::kNone, node);
+        break;
+    }
+    case FrameType::kContainer:
+    {
+        if (element == SVGElement::kUnknown)
+        {
+            PushFrame(FrameType::kIgnored, SVGDocumentImpl::ContainerType::kNone, nullptr);
+            break;
+        }
+        // Children of <defs> are resources and parsed as a whole.
+        if (parent.containerType != SVGDocumentImpl::ContainerType::kDefs
+            && (element == SVGElement::kG || element == SVGElement::kSymbol || element == SVGElement::kDefs))
+        {
+            auto checkpoint = mDocument->CreateCheckpoint();
+            auto containerType = mDocument->OpenContainer(CreateNode(mAttributeDocument, element));
+            mAttributeDocument.Clear();
+            if (!mDocument->HasUnresolvedReferencesSince(checkpoint))
+            {
+                PushFrame(FrameType::kContainer, containerType, nullptr);
+                break;
+            }
+            // The container references a definition that did not arrive yet.
+            // Collect it with its content and defer it as a whole.
+            mDocument->CloseContainer(containerType);
+            mDocument->Rewind(checkpoint);
+        }
+        auto node = CreateNode(*mSubtreeDocument, element);
+        mSubtreeDocument->AppendNode(nullptr, node);
+        PushFrame(FrameType::kSubtree, SVGDocumentImpl::ContainerType::kNone, node);
+        break;
+    }
+    case FrameType::kIgnored:
+    default:
+        break;
+    }
+}
+
+void SVGDocumentBuilderImpl::PushFrame(FrameType type, SVGDocumentImpl::ContainerType containerType, XMLNode* node)
+{
+    mFrames.push_back({type, containerType, node, mElementPath.size()});
+    if (!mElementPath.empty())
+        mElementPath += '/';
+    mElementPath.append(mToken.name, mToken.nameSize);
+}
+
+bool SVGDocumentBuilderImpl::HandleEndElement()
+{
+    if (mFrames.empty())
+        return false;
+    auto frame = mFrames.back();
+    mFrames.pop_back();
+    mElementPath.resize(frame.parentPathSize);
+
+    switch (frame.type)
+    {
+    case FrameType::kContainer:
+        mDocument->CloseContainer(frame.containerType);
+        break;
+    case FrameType::kSubtree:
+        // The subtree is complete once its root element, the only child of the document, ends.
+        if (!frame.node->parent)
+        {
+            bool isResource = !mFrames.empty() && mFrames.back().containerType == SVGDocumentImpl::ContainerType::kDefs;
+            ParseSubtree(frame.node, isResource);
+        }
+        break;
+    case FrameType::kIgnored:
+    default:
+        break;
+    }
+    return true;
+}
+
+static bool HasIdAttribute(const XMLNode* node)
+{
+    for (auto attr = node->firstAttribute; attr != nullptr; attr = attr->next)
+    {
+        if (attr->attribute == SVGAttribute::kId)
+            return true;
+    }
+    return false;
+}
+
+void SVGDocumentBuilderImpl::ParseSubtree(XMLNode* node, bool isResource)
+{
+    auto checkpoint = mDocument->CreateCheckpoint();
+    if (isResource)
+        mDocument->ParseResource(node);
+    else
+        mDocument->ParseChild(node);
+
+    // Definitions may follow their references. Parse the element again once
+    // the whole document arrived.
+    if (mDocument->LimitError() == ParseErrorCode::kNone && mDocument->HasUnresolvedReferencesSince(checkpoint))
+        mDocument->DeferElement(checkpoint, mDeferredDocument.CopySubtree(node), isResource);
+
+    // Resources with an ID may get referenced by <use> elements later on.
+    if (isResource && HasIdAttribute(node))
+    {
+        mRetainedBytes += mSubtreeDocument->Size();
+        mRetainedDocuments.push_back(std::move(mSubtreeDocument));
+        mSubtreeDocument.reset(new XMLDocument);
+    }
+    else
+        mSubtreeDocument->Clear();
+}
+
+void SVGDocumentBuilderImpl::HandleText(XMLNodeType type)
+{
+    if (mFrames.empty() || mFrames.back().type != FrameType::kSubtree)
+        return;
+
+    // Text becomes a child node. The first text is the value of the element
+    // as well.
+    auto parent = mFrames.back().node;
+    auto value = mSubtreeDocument->CreateString(mToken.textSize);
+    auto valueSize = mToken.textSize;
+    if (type == XMLNodeType::kData)
+        valueSize = DecodeXMLEntities(mToken.text, mToken.textSize, value);
+    else
+        memcpy(value, mToken.text, valueSize);
+
+    auto node = mSubtreeDocument->CreateNode(type, SVGElement::kUnknown);
+    node->value = value;
+    node->valueSize = valueSize;
+    mSubtreeDocument->AppendNode(parent, node);
+    if (type == XMLNodeType::kData && !parent->valueSize)
+    {
+        parent->value = value;
+        parent->valueSize = valueSize;
+    }
+}
+
+XMLNode* SVGDocumentBuilderImpl::CreateNode(XMLDocument& xmlDocument, SVGElement element)
+{
+    // Only attributes the parser reads are kept.
+    auto node = xmlDocument.CreateNode(XMLNodeType::kElement, element);
+    if (element == SVGElement::kUnknown)
+        return node;
+    for (const auto& attribute : mToken.attributes)
+    {
+        auto svgAttribute = ClassifySVGAttribute(attribute.name, attribute.nameSize);
+        if (svgAttribute == SVGAttribute::kUnknown)
+            continue;
+        auto value = xmlDocument.CreateString(attribute.valueSize);
+        xmlDocument.AppendAttribute(node, svgAttribute, value, DecodeXMLEntities(attribute.value, attribute.valueSize, value));
+    }
+    return node;
+}
+
+SVGDocumentBuilder::SVGDocumentBuilder(std::shared_ptr<SVGRenderer> renderer, const ParseLimits& limits)
+    : mImpl{new SVGDocumentBuilderImpl(renderer, limits)}
+{
+}
+
+SVGDocumentBuilder::~SVGDocumentBuilder() {}
+
+bool SVGDocumentBuilder::Feed(const char* data, size_t length) { return mImpl->Feed(data, length); }
+
+std::unique_ptr<SVGDocument> SVGDocumentBuilder::Finish()
+{
+    auto realSVGDoc = mImpl->Finish();
+    if (!realSVGDoc)
+        return nullptr;
+
+    auto retval = new SVGDocument();
+    retval->mDocument = std::move(realSVGDoc);
+    return std::unique_ptr<SVGDocument>(retval);
+}
+
+const ParseError& SVGDocumentBuilder::Error() const { return mImpl->Error(); }
+
+} // namespace SVGNative
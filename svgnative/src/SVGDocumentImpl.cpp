@@ -15,94 +15,530 @@ governing permissions and limitations under the License.
 #include "SVGRenderer.h"
 #include "SVGStringParser.h"
 
+#include <algorithm>
+#include <atomic>
+#include <boost/functional/hash.hpp>
 #include <cmath>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
 
 namespace SVGNative
 {
-constexpr std::array<const char*, 14> gInheritedPropertyNames{{
-    "color",
-    "clip-rule",
-    "fill",
-    "fill-rule",
-    "fill-opacity",
-    "stroke",
-    "stroke-dasharray",
-    "stroke-dashoffset",
-    "stroke-linecap",
-    "stroke-linejoin",
-    "stroke-miterlimit",
-    "stroke-opacity",
-    "stroke-width",
-    "visibility"
-}};
-
-constexpr std::array<const char*, 5> gNonInheritedPropertyNames{{
-    "clip-path",
-    "display",
-    "opacity",
-    "stop-opacity",
-    "stop-color"
-}};
-
-SVGDocumentImpl::SVGDocumentImpl(std::shared_ptr<SVGRenderer> renderer)
+// Classifies all attributes of node in a single walk.
+static SVGAttributeSet CollectAttributes(XMLNode* node)
+{
+    SVGAttributeSet attributes;
+    for (auto attr = node->firstAttribute; attr != nullptr; attr = attr->next)
+        attributes.Add(attr->attribute, attr->value, attr->valueSize);
+    return attributes;
+}
+
+static SVGElement ClassifyElement(XMLNode* node) { return node->element; }
+
+SVGDocumentImpl::SVGDocumentImpl(std::shared_ptr<SVGRenderer> renderer, ParseState* parseState)
     : mViewBox{{0, 0, 320.0f, 200.0f}}
     , mRenderer{renderer}
+    , mState{parseState}
 {
-    mFillStyleStack.push(FillStyleImpl());
-    mStrokeStyleStack.push(StrokeStyleImpl());
+    if (!mState)
+    {
+        mOwnedParseState.reset(new ParseState);
+        mState = mOwnedParseState.get();
+    }
+    mState->Reset();
+    mState->fillStyleStack.push(FillStyleImpl());
+    mState->strokeStyleStack.push(StrokeStyleImpl());
 
     GraphicStyleImpl graphicStyle{};
     std::set<std::string> classNames;
-    mGroup = std::unique_ptr<Group>(new Group(graphicStyle, classNames));
-    mGroupStack.push(mGroup.get());
+    mGroup = mArena.New<Group>(graphicStyle, CopyClassNames(mArena, classNames));
+    mState->groupStack.push(mGroup);
+}
+
+SVGDocumentImpl::~SVGDocumentImpl() {}
+
+void SVGDocumentImpl::ParseState::Reset()
+{
+    while (!strokeStyleStack.empty())
+        strokeStyleStack.pop();
+    while (!fillStyleStack.empty())
+        fillStyleStack.pop();
+    while (!groupStack.empty())
+        groupStack.pop();
+    resourceIndex.Clear();
+    resources.clear();
+    useInstances.clear();
+    useTargetStack.clear();
+    deferredElements.clear();
 }
 
-void SVGDocumentImpl::TraverseSVGTree()
+void SVGDocumentImpl::FinishParsing()
 {
-    auto rootNode = mXMLDocument.first_node();
-    if (std::string(rootNode->name()) != "svg")
+    ClearResources();
+    mState = nullptr;
+    mOwnedParseState.reset();
+    FlattenTree();
+}
+
+void SVGDocumentImpl::TraverseSVGTree(XMLNode* rootNode)
+{
+    if (!ParseSVGRoot(rootNode))
         return;
 
-    if (!HasAttr(rootNode, "viewBox"))
+    IndexResources(rootNode);
+    ParseChildren(rootNode);
+
+    ClearResources();
+}
+
+void SVGDocumentImpl::TraverseSVGTreeParallel(XMLNode* rootNode, unsigned threadCount)
+{
+    if (!ParseSVGRoot(rootNode))
+        return;
+
+    std::vector<XMLNode*> subtrees;
+    for (auto child = rootNode->firstChild; child != nullptr; child = child->nextSibling)
+        subtrees.push_back(child);
+
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, subtrees.size()));
+#ifdef STYLE_SUPPORT
+    // Style sheets get collected into the document while parsing.
+    threadCount = 1;
+#endif
+
+    IndexResources(rootNode);
+    if (threadCount < 2 || !ParseResourcesAhead(rootNode, 1))
     {
-        if (HasAttr(rootNode, "x"))
-            mViewBox[0] = SVGDocumentImpl::ParseLengthFromAttr(rootNode, "x", LengthType::kHorrizontal);
-        if (HasAttr(rootNode, "y"))
-            mViewBox[1] = SVGDocumentImpl::ParseLengthFromAttr(rootNode, "y", LengthType::kVertical);
-        if (HasAttr(rootNode, "width"))
-            mViewBox[2] = SVGDocumentImpl::ParseLengthFromAttr(rootNode, "width", LengthType::kHorrizontal);
-        if (HasAttr(rootNode, "height"))
-            mViewBox[3] = SVGDocumentImpl::ParseLengthFromAttr(rootNode, "height", LengthType::kVertical);
+        ClearResources();
+        IndexResources(rootNode);
+        ParseChildren(rootNode);
+        ClearResources();
+        return;
     }
-    else
+
+    // Every thread parses whole subtrees with its own style and group stacks
+    // into its own arena. Resources are read-only copies of the pre-pass
+    // results. Parsed subtrees are ranges of siblings.
+    std::vector<std::pair<Element*, Element*>> parsedSubtrees(subtrees.size());
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::vector<std::unique_ptr<SVGDocumentImpl>> parsers(threadCount);
+    std::atomic<size_t> nextSubtree{0};
+    auto parseSubtrees = [&](unsigned threadIndex) {
+#ifndef SVG_NO_EXCEPTIONS
+        try
+#endif
+        {
+            parsers[threadIndex].reset(new SVGDocumentImpl(mRenderer));
+            auto parser = parsers[threadIndex].get();
+            parser->mViewBox = mViewBox;
+            parser->mLazyGeometry = mLazyGeometry;
+            parser->mState->resourceIndex = mState->resourceIndex;
+            parser->mState->resources = mState->resources;
+            parser->mLimits = mLimits;
+            parser->mUseExpansions = mUseExpansions;
+            parser->mPathSegments = mPathSegments;
+            for (size_t i = nextSubtree++; i < subtrees.size() && parser->mLimitError == ParseErrorCode::kNone; i = nextSubtree++)
+            {
+                parser->ParseChild(subtrees[i]);
+                parsedSubtrees[i] = {parser->mGroup->firstChild, parser->mGroup->lastChild};
+                parser->mGroup->firstChild = nullptr;
+                parser->mGroup->lastChild = nullptr;
+            }
+        }
+#ifndef SVG_NO_EXCEPTIONS
+        catch (...)
+        {
+            errors[threadIndex] = std::current_exception();
+        }
+#endif
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; ++i)
     {
-        auto attr = rootNode->first_attribute("viewBox");
-        std::vector<float> numberList;
-        if (SVGStringParser::ParseListOfNumbers(std::string(attr->value()), numberList) && numberList.size() == 4)
-            mViewBox = {{numberList[0], numberList[1], numberList[2], numberList[3]}};
+#ifndef SVG_NO_EXCEPTIONS
+        // Continue with fewer threads if the system refuses to create more.
+        try
+        {
+            threads.emplace_back(parseSubtrees, i);
+        }
+        catch (const std::system_error&)
+        {
+            break;
+        }
+#else
+        threads.emplace_back(parseSubtrees, i);
+#endif
     }
+    parseSubtrees(0);
+    for (auto& thread : threads)
+        thread.join();
 
-#if DEBUG
-    if (HasAttr(rootNode, "data-name"))
+#ifndef SVG_NO_EXCEPTIONS
+    for (const auto& error : errors)
     {
-        auto attr = rootNode->first_attribute("data-name");
-        if (attr)
-            mTitle = attr->value();
+        if (error)
+            std::rethrow_exception(error);
     }
 #endif
 
-    ParseChildren(rootNode);
+    // Every thread had the whole budget. Check the sum.
+    size_t useExpansions = mUseExpansions;
+    size_t pathSegments = mPathSegments;
+    for (const auto& parser : parsers)
+    {
+        if (!parser)
+            continue;
+        mArena.Merge(parser->mArena);
+        if (parser->mLimitError != ParseErrorCode::kNone)
+            SetLimitError(parser->mLimitError);
+        useExpansions += parser->mUseExpansions - mUseExpansions;
+        pathSegments += parser->mPathSegments - mPathSegments;
+    }
+    if (!AddUseExpansions(useExpansions - mUseExpansions) || !AddPathSegments(pathSegments - mPathSegments))
+    {
+        ClearResources();
+        return;
+    }
 
+    for (const auto& elements : parsedSubtrees)
+    {
+        if (elements.first)
+            mGroup->AppendChildren(elements.first, elements.second);
+    }
+
+    ClearResources();
+}
+
+bool SVGDocumentImpl::ParseSVGRoot(XMLNode* rootNode)
+{
+    if (!rootNode || ClassifyElement(rootNode) != SVGElement::kSvg)
+        return false;
+
+    auto attributes = CollectAttributes(rootNode);
+    ParseViewBox(attributes, mViewBox);
+
+#if DEBUG
+    if (attributes.Has(SVGAttribute::kDataName))
+        mTitle = attributes.Get(SVGAttribute::kDataName).to_string();
+#endif
+    return true;
+}
+
+void SVGDocumentImpl::ParseViewBox(const SVGAttributeSet& attributes, std::array<float, 4>& viewBox)
+{
+    if (!attributes.Has(SVGAttribute::kViewBox))
+    {
+        // Percentages are relative to the initial viewBox of 320x200. Invalid
+        // values count as 0.
+        auto parseLength = [&](SVGAttribute attribute, float relativeLength, float& length) {
+            float number{};
+            auto value = attributes.Get(attribute);
+            length = !value.empty() && SVGStringParser::ParseLengthOrPercentage(value, relativeLength, number, true) ? number : 0;
+        };
+        if (attributes.Has(SVGAttribute::kX))
+            parseLength(SVGAttribute::kX, viewBox[2], viewBox[0]);
+        if (attributes.Has(SVGAttribute::kY))
+            parseLength(SVGAttribute::kY, viewBox[3], viewBox[1]);
+        if (attributes.Has(SVGAttribute::kWidth))
+            parseLength(SVGAttribute::kWidth, viewBox[2], viewBox[2]);
+        if (attributes.Has(SVGAttribute::kHeight))
+            parseLength(SVGAttribute::kHeight, viewBox[3], viewBox[3]);
+    }
+    else
+    {
+        float numbers[4];
+        if (SVGStringParser::ParseListOfNumbers(attributes.Get(SVGAttribute::kViewBox), numbers, 4))
+            viewBox = {{numbers[0], numbers[1], numbers[2], numbers[3]}};
+    }
+}
+
+void SVGDocumentImpl::SetLimitError(ParseErrorCode code)
+{
+    // Keep the first error.
+    if (mLimitError == ParseErrorCode::kNone)
+        mLimitError = code;
+}
+
+bool SVGDocumentImpl::EnterLevel()
+{
+    if (++mDepth <= mLimits.maxDepth)
+        return true;
+    SetLimitError(ParseErrorCode::kDepthLimitExceeded);
+    return false;
+}
+
+bool SVGDocumentImpl::AddPathSegments(size_t count)
+{
+    mPathSegments += count;
+    if (mPathSegments <= mLimits.maxPathSegments)
+        return true;
+    SetLimitError(ParseErrorCode::kPathLimitExceeded);
+    return false;
+}
+
+bool SVGDocumentImpl::AddUseExpansions(size_t count)
+{
+    mUseExpansions += count;
+    if (mUseExpansions <= mLimits.maxUseExpansions)
+        return true;
+    SetLimitError(ParseErrorCode::kUseLimitExceeded);
+    return false;
+}
+
+SVGDocumentImpl::Checkpoint SVGDocumentImpl::CreateCheckpoint() const
+{
+    auto group = mState->groupStack.top();
+    return {group, group->lastChild, mViewBox, mDepth, mUseExpansions, mPathSegments, mUnresolvedReferences};
+}
+
+void SVGDocumentImpl::Rewind(const Checkpoint& checkpoint)
+{
+    // Elements stay in the arena until the document gets destroyed.
+    auto group = checkpoint.group;
+    group->lastChild = checkpoint.lastChild;
+    if (group->lastChild)
+        group->lastChild->nextSibling = nullptr;
+    else
+        group->firstChild = nullptr;
+
+    mViewBox = checkpoint.viewBox;
+    mDepth = checkpoint.depth;
+    mUseExpansions = checkpoint.useExpansions;
+    mPathSegments = checkpoint.pathSegments;
+    // Cached <use> content may miss the definitions as well.
+    mState->useInstances.clear();
+}
+
+void SVGDocumentImpl::DeferElement(const Checkpoint& checkpoint, XMLNode* node, bool isResource)
+{
+    Rewind(checkpoint);
+
+    Group* placeholder{};
+    if (!isResource)
+    {
+        GraphicStyleImpl graphicStyle{};
+        std::set<std::string> classNames;
+        placeholder = mArena.New<Group>(graphicStyle, CopyClassNames(mArena, classNames));
+        AddChildToCurrentGroup(placeholder);
+    }
+    mState->deferredElements.push_back({node, placeholder, mState->groupStack.top(), mState->fillStyleStack.top(),
+        mState->strokeStyleStack.top(), mViewBox, mDepth});
+}
+
+void SVGDocumentImpl::ParseDeferredElements()
+{
+    auto& deferredElements = mState->deferredElements;
+    if (deferredElements.empty())
+        return;
+
+    // Deferred gradients were parsed without the gradients they inherit
+    // from. Parse them on first reference instead, like definitions found
+    // by IndexResources().
+    for (const auto& deferred : deferredElements)
+    {
+        if (deferred.placeholder)
+            continue;
+        auto id = CollectAttributes(deferred.node).Get(SVGAttribute::kId);
+        if (id.empty())
+            continue;
+        auto& resource = AddResource(id);
+        resource.definition = deferred.node;
+        resource.gradient.reset();
+        resource.clippingPath = nullptr;
+    }
+
+    auto viewBox = mViewBox;
+    auto depth = mDepth;
+    for (const auto& deferred : deferredElements)
+    {
+        if (mLimitError != ParseErrorCode::kNone)
+            break;
+        mViewBox = deferred.viewBox;
+        mDepth = deferred.depth;
+        mState->fillStyleStack.push(deferred.fillStyle);
+        mState->strokeStyleStack.push(deferred.strokeStyle);
+        if (deferred.placeholder)
+        {
+            mState->groupStack.push(deferred.placeholder);
+            ParseChild(deferred.node);
+            mState->groupStack.pop();
+        }
+        else
+            ParseResource(deferred.node);
+        mState->fillStyleStack.pop();
+        mState->strokeStyleStack.pop();
+    }
+    mViewBox = viewBox;
+    mDepth = depth;
+
+    // Replace the placeholders by their children. Every parent gets walked once.
+    std::unordered_set<const Element*> placeholders;
+    std::unordered_set<Group*> parentSet;
+    std::vector<Group*> parents;
+    for (const auto& deferred : deferredElements)
+    {
+        if (!deferred.placeholder)
+            continue;
+        placeholders.insert(deferred.placeholder);
+        if (parentSet.insert(deferred.parent).second)
+            parents.push_back(deferred.parent);
+    }
+    for (auto parent : parents)
+    {
+        auto child = parent->firstChild;
+        parent->firstChild = nullptr;
+        parent->lastChild = nullptr;
+        while (child)
+        {
+            auto next = child->nextSibling;
+            child->nextSibling = nullptr;
+            if (placeholders.count(child))
+            {
+                auto placeholder = static_cast<Group*>(child);
+                if (placeholder->firstChild)
+                    parent->AppendChildren(placeholder->firstChild, placeholder->lastChild);
+            }
+            else
+                parent->AppendChild(child);
+            child = next;
+        }
+    }
+    deferredElements.clear();
+}
+
+void SVGDocumentImpl::ClearResources()
+{
     // Clear all temporary sets
-    mGradients.clear();
-    mResourceIDs.clear();
-    mClippingPaths.clear();
+    mState->resourceIndex.Clear();
+    mState->resources.clear();
+    mState->useInstances.clear();
+}
+
+void SVGDocumentImpl::IndexResources(XMLNode* rootNode)
+{
+    // Walk all elements in document order. Iterative, the depth of the tree is
+    // not limited.
+    auto node = rootNode->firstChild;
+    while (node)
+    {
+        if (node->type == XMLNodeType::kElement)
+        {
+            for (auto attr = node->firstAttribute; attr != nullptr; attr = attr->next)
+            {
+                if (attr->attribute == SVGAttribute::kId)
+                {
+                    auto& resource = AddResource({attr->value, attr->valueSize});
+                    if (!resource.definition)
+                        resource.definition = node;
+                    break;
+                }
+            }
+        }
+
+        if (node->firstChild)
+        {
+            node = node->firstChild;
+            continue;
+        }
+        while (node != rootNode && !node->nextSibling)
+            node = node->parent;
+        node = node == rootNode ? nullptr : node->nextSibling;
+    }
+}
+
+SVGDocumentImpl::Resource& SVGDocumentImpl::AddResource(boost::string_view id)
+{
+    auto index = mState->resourceIndex.Intern(id);
+    if (index >= mState->resources.size())
+        mState->resources.resize(index + 1);
+    return mState->resources[index];
 }
 
-bool SVGDocumentImpl::HasAttr(XMLNode* node, const char* attrName)
+// Returns the definition of the resource at index if it is one of the passed
+// elements and has not been taken before. References to the definition get
+// resolved by parsing it right away, in the context of the referencing element.
+XMLNode* SVGDocumentImpl::TakeDefinition(std::uint32_t index, SVGElement element, SVGElement alternativeElement)
 {
-    auto attr = node->first_attribute(attrName);
-    return attr != nullptr;
+    auto node = mState->resources[index].definition;
+    if (!node)
+        return nullptr;
+    auto definitionElement = ClassifyElement(node);
+    if (definitionElement != element && definitionElement != alternativeElement)
+        return nullptr;
+    // Taking the definition once also breaks reference cycles.
+    mState->resources[index].definition = nullptr;
+    return node;
+}
+
+const GradientImpl* SVGDocumentImpl::FindGradient(boost::string_view id)
+{
+    auto index = mState->resourceIndex.Find(id);
+    if (index == SVGResourceIndex::kNotFound)
+    {
+        ++mUnresolvedReferences;
+        return nullptr;
+    }
+    if (!mState->resources[index].gradient)
+    {
+        if (auto node = TakeDefinition(index, SVGElement::kLinearGradient, SVGElement::kRadialGradient))
+            ParseResource(node);
+    }
+    auto gradient = mState->resources[index].gradient.get();
+    if (!gradient)
+        ++mUnresolvedReferences;
+    return gradient;
+}
+
+const ClippingPathImpl* SVGDocumentImpl::FindClippingPath(boost::string_view id)
+{
+    auto index = mState->resourceIndex.Find(id);
+    if (index == SVGResourceIndex::kNotFound)
+    {
+        ++mUnresolvedReferences;
+        return nullptr;
+    }
+    if (!mState->resources[index].clippingPath)
+    {
+        if (auto node = TakeDefinition(index, SVGElement::kClipPath, SVGElement::kClipPath))
+            ParseResource(node);
+    }
+    auto clippingPath = mState->resources[index].clippingPath;
+    if (!clippingPath)
+        ++mUnresolvedReferences;
+    return clippingPath;
+}
+
+XMLNode* SVGDocumentImpl::FindUseTarget(boost::string_view id)
+{
+    auto index = mState->resourceIndex.Find(id);
+    if (index == SVGResourceIndex::kNotFound)
+        return nullptr;
+    const auto& resource = mState->resources[index];
+    if (resource.useTarget || !resource.definition)
+        return resource.useTarget;
+
+    // Like in document order, only children of <defs> other than gradients,
+    // clipping paths and style sheets can be referenced.
+    auto parent = resource.definition->parent;
+    if (!parent || parent->type != XMLNodeType::kElement || ClassifyElement(parent) != SVGElement::kDefs)
+        return nullptr;
+    switch (ClassifyElement(resource.definition))
+    {
+    case SVGElement::kLinearGradient:
+    case SVGElement::kRadialGradient:
+    case SVGElement::kClipPath:
+    case SVGElement::kStyle:
+        return nullptr;
+    default:
+        return resource.definition;
+    }
 }
 
 float SVGDocumentImpl::RelativeLength(LengthType lengthType) const
@@ -126,14 +562,14 @@ float SVGDocumentImpl::RelativeLength(LengthType lengthType) const
     return relLength;
 }
 
-float SVGDocumentImpl::ParseLengthFromAttr(XMLNode* node, const char* attrName, LengthType lengthType, float fallback)
+float SVGDocumentImpl::ParseLengthFromAttr(const SVGAttributeSet& attributes, SVGAttribute attribute, LengthType lengthType, float fallback)
 {
-    auto attr = node->first_attribute(attrName);
-    if (!attr)
+    auto value = attributes.Get(attribute);
+    if (value.empty())
         return fallback;
 
     float number{};
-    if (!SVGStringParser::ParseLengthOrPercentage(attr->value(), RelativeLength(lengthType), number, true))
+    if (!SVGStringParser::ParseLengthOrPercentage(value, RelativeLength(lengthType), number, true))
         return fallback;
 
     return number;
@@ -141,82 +577,261 @@ float SVGDocumentImpl::ParseLengthFromAttr(XMLNode* node, const char* attrName,
 
 void SVGDocumentImpl::ParseChildren(XMLNode* node)
 {
-    for (auto child = node->first_node(); child != nullptr; child = child->next_sibling())
+    for (auto child = node->firstChild; child != nullptr && mLimitError == ParseErrorCode::kNone; child = child->nextSibling)
     {
         ParseChild(child);
     }
 }
 
-void SVGDocumentImpl::ParseChild(XMLNode* child)
+// Returns true if there is a <symbol> element below node. Iterative, the
+// depth of the tree is not limited.
+static bool HasSymbolDescendant(XMLNode* node)
 {
-    auto fillStyle = mFillStyleStack.top();
-    auto strokeStyle = mStrokeStyleStack.top();
-    std::set<std::string> classNames;
-    auto graphicStyle = ParseGraphic(child, fillStyle, strokeStyle, classNames);
+    auto descendant = node->firstChild;
+    while (descendant)
+    {
+        if (ClassifyElement(descendant) == SVGElement::kSymbol)
+            return true;
+        if (descendant->firstChild)
+        {
+            descendant = descendant->firstChild;
+            continue;
+        }
+        while (descendant != node && !descendant->nextSibling)
+            descendant = descendant->parent;
+        descendant = descendant == node ? nullptr : descendant->nextSibling;
+    }
+    return false;
+}
 
-    // Check if we have a shape rect, circle, ellipse, line, polygon, polyline
-    // or path first.
-    if (auto path = ParseShape(child))
+bool SVGDocumentImpl::ParseResourcesAhead(XMLNode* node, size_t depth)
+{
+    // Nesting beyond the budget fails in the serial parser with
+    // kDepthLimitExceeded. Do not recurse any further but fall back to it.
+    if (depth > mLimits.maxDepth)
+        return false;
+    for (auto child = node->firstChild; child != nullptr; child = child->nextSibling)
     {
-        AddChildToCurrentGroup(std::unique_ptr<Graphic>(new Graphic(graphicStyle, classNames, fillStyle, strokeStyle, std::move(path))));
-        return;
+        auto element = ClassifyElement(child);
+        switch (element)
+        {
+        case SVGElement::kSymbol:
+            // A rendered <symbol> changes the viewBox for all following elements.
+            return false;
+        case SVGElement::kG:
+        case SVGElement::kDefs:
+        {
+            // Containers pass their fill and stroke properties on to the
+            // resources within.
+            auto fillStyle = mState->fillStyleStack.top();
+            auto strokeStyle = mState->strokeStyleStack.top();
+            std::set<std::string> classNames;
+            ParseGraphic(CollectAttributes(child), fillStyle, strokeStyle, classNames);
+
+            bool resolved{true};
+            mState->fillStyleStack.push(fillStyle);
+            mState->strokeStyleStack.push(strokeStyle);
+            if (element == SVGElement::kDefs)
+            {
+                // Referenced content of <defs> may be rendered by <use>. A <use>
+                // renders an empty <symbol> itself, otherwise its children.
+                for (auto resource = child->firstChild; resource != nullptr && resolved; resource = resource->nextSibling)
+                {
+                    bool isEmptySymbol = ClassifyElement(resource) == SVGElement::kSymbol && !resource->firstChild;
+                    resolved = !isEmptySymbol && !HasSymbolDescendant(resource);
+                }
+                if (resolved)
+                    ParseResources(child);
+            }
+            else
+                resolved = ParseResourcesAhead(child, depth + 1);
+            mState->fillStyleStack.pop();
+            mState->strokeStyleStack.pop();
+            if (!resolved)
+                return false;
+            break;
+        }
+        case SVGElement::kStyle:
+        case SVGElement::kLinearGradient:
+        case SVGElement::kRadialGradient:
+        case SVGElement::kClipPath:
+            ParseResource(child);
+            break;
+        default:
+            break;
+        }
     }
+    return true;
+}
 
-    // Look at all elements that are no shapes.
-    std::string elementName = child->name();
-    if (elementName == "g")
+SVGDocumentImpl::ContainerType SVGDocumentImpl::OpenContainer(XMLNode* child)
+{
+    return OpenContainer(ClassifyElement(child), CollectAttributes(child));
+}
+
+SVGDocumentImpl::ContainerType SVGDocumentImpl::OpenContainer(SVGElement element, const SVGAttributeSet& attributes)
+{
+    ContainerType containerType{ContainerType::kNone};
+    switch (element)
     {
-        mFillStyleStack.push(fillStyle);
-        mStrokeStyleStack.push(strokeStyle);
+    case SVGElement::kG:
+        containerType = ContainerType::kGroup;
+        break;
+    case SVGElement::kDefs:
+        containerType = ContainerType::kDefs;
+        break;
+    case SVGElement::kSymbol:
+        containerType = ContainerType::kSymbol;
+        break;
+    default:
+        return containerType;
+    }
+    EnterLevel();
 
-        auto group = std::unique_ptr<Group>(new Group(graphicStyle, classNames));
-        auto tempGroupPtr = group.get();
-        AddChildToCurrentGroup(std::move(group));
-        mGroupStack.push(tempGroupPtr);
+    auto fillStyle = mState->fillStyleStack.top();
+    auto strokeStyle = mState->strokeStyleStack.top();
+    std::set<std::string> classNames;
+    auto graphicStyle = ParseGraphic(attributes, fillStyle, strokeStyle, classNames);
 
-        ParseChildren(child);
+    switch (containerType)
+    {
+    case ContainerType::kGroup:
+    {
+        mState->fillStyleStack.push(fillStyle);
+        mState->strokeStyleStack.push(strokeStyle);
 
-        mGroupStack.pop();
-        mFillStyleStack.pop();
-        mStrokeStyleStack.pop();
+        auto group = mArena.New<Group>(graphicStyle, CopyClassNames(mArena, classNames));
+        AddChildToCurrentGroup(group);
+        mState->groupStack.push(group);
+        break;
     }
-    else if (elementName == "defs")
+    case ContainerType::kDefs:
+        mState->fillStyleStack.push(fillStyle);
+        mState->strokeStyleStack.push(strokeStyle);
+        break;
+    case ContainerType::kSymbol:
     {
-        mFillStyleStack.push(fillStyle);
-        mStrokeStyleStack.push(strokeStyle);
+        // FIXME: Do not render <symbol> outside of <defs> section.
+        // FIXME: Remove support for symbol ASAP.
+        auto viewBox = attributes.Get(SVGAttribute::kViewBox);
+        if (!viewBox.empty())
+        {
+            std::vector<float> numberList;
+            if (SVGStringParser::ParseListOfNumbers(viewBox, numberList) && numberList.size() == 4)
+                graphicStyle.transform = AffineTransform{1, 0, 0, 1, -numberList[0], -numberList[1]};
+            {
+                mViewBox = {{numberList[0], numberList[1], numberList[2], numberList[3]}};
+            }
+        }
 
-        ParseResources(child);
+        auto group = mArena.New<Group>(graphicStyle, CopyClassNames(mArena, classNames));
+        mState->groupStack.push(group);
+        AddChildToCurrentGroup(group);
+        break;
+    }
+    default:
+        break;
+    }
+    return containerType;
+}
 
-        mFillStyleStack.pop();
-        mStrokeStyleStack.pop();
+void SVGDocumentImpl::CloseContainer(ContainerType containerType)
+{
+    if (containerType != ContainerType::kNone)
+        LeaveLevel();
+    switch (containerType)
+    {
+    case ContainerType::kGroup:
+        mState->groupStack.pop();
+        mState->fillStyleStack.pop();
+        mState->strokeStyleStack.pop();
+        break;
+    case ContainerType::kDefs:
+        mState->fillStyleStack.pop();
+        mState->strokeStyleStack.pop();
+        break;
+    case ContainerType::kSymbol:
+        mState->groupStack.pop();
+        break;
+    default:
+        break;
     }
-    else if (elementName == "image")
+}
+
+void SVGDocumentImpl::ParseChild(XMLNode* child)
+{
+    if (mLimitError != ParseErrorCode::kNone)
+        return;
+
+    auto element = ClassifyElement(child);
+    auto attributes = CollectAttributes(child);
+    auto containerType = OpenContainer(element, attributes);
+    if (containerType != ContainerType::kNone)
+    {
+        if (containerType == ContainerType::kDefs)
+            ParseResources(child);
+        else
+            ParseChildren(child);
+        CloseContainer(containerType);
+        return;
+    }
+
+    auto fillStyle = mState->fillStyleStack.top();
+    auto strokeStyle = mState->strokeStyleStack.top();
+    std::set<std::string> classNames;
+    auto graphicStyle = ParseGraphic(attributes, fillStyle, strokeStyle, classNames);
+
+    // Check if we have a shape rect, circle, ellipse, line, polygon, polyline
+    // or path first.
+    ShapeGeometry geometry;
+    if (ParseShapeGeometry(element, attributes, geometry))
     {
-        std::unique_ptr<ImageData> imageData;
-        auto hrefAttr = child->first_attribute("xlink:href");
-        if (hrefAttr)
+        Graphic* graphic{};
+        if (mLazyGeometry)
+            graphic = mArena.New<Graphic>(graphicStyle, CopyClassNames(mArena, classNames), fillStyle, strokeStyle, geometry);
+        else
+        {
+            size_t segmentCount{};
+            auto pathData = RecordShapePath(geometry, &segmentCount);
+            if (!AddPathSegments(segmentCount))
+                return;
+            graphic = mArena.New<Graphic>(graphicStyle, CopyClassNames(mArena, classNames), fillStyle, strokeStyle, pathData);
+        }
+        ResolveStaticStyle(*graphic);
+        AddChildToCurrentGroup(graphic);
+        return;
+    }
+
+    // Look at all elements that are no shapes.
+    if (element == SVGElement::kImage)
+    {
+        // The document renderer provides the dimensions of the image.
+        ImageData* imageData{};
+        std::string base64;
+        ImageEncoding encoding{};
+        auto dataURL = attributes.Get(SVGAttribute::kXlinkHref);
+        if (!dataURL.empty() && mRenderer)
         {
-            std::string dataURL = hrefAttr->value();
-            ImageEncoding encoding{};
             size_t base64Offset{};
-            if (dataURL.find("data:image/png;base64,") == 0)
+            if (dataURL.starts_with("data:image/png;base64,"))
             {
                 encoding = ImageEncoding::kPNG;
                 base64Offset = 22;
             }
-            else if (dataURL.find("data:image/jpg;base64,") == 0)
+            else if (dataURL.starts_with("data:image/jpg;base64,"))
             {
                 encoding = ImageEncoding::kJPEG;
                 base64Offset = 22;
             }
-            else if (dataURL.find("data:image/jpeg;base64,") == 0)
+            else if (dataURL.starts_with("data:image/jpeg;base64,"))
             {
                 encoding = ImageEncoding::kJPEG;
                 base64Offset = 23;
             }
             else
                 return;
-            imageData = mRenderer->CreateImageData(dataURL.substr(base64Offset), encoding);
+            base64 = dataURL.substr(base64Offset).to_string();
+            imageData = mRenderer->AllocateImageData(base64, encoding, mArena);
         }
 
         if (imageData)
@@ -224,16 +839,16 @@ void SVGDocumentImpl::ParseChild(XMLNode* child)
             float imageWidth = imageData->Width();
             float imageHeight = imageData->Height();
 
-            Rect clipArea{ParseLengthFromAttr(child, "x", LengthType::kHorrizontal),
-                ParseLengthFromAttr(child, "y", LengthType::kVertical),
-                ParseLengthFromAttr(child, "width", LengthType::kHorrizontal, imageWidth),
-                ParseLengthFromAttr(child, "height", LengthType::kVertical, imageHeight)};
+            Rect clipArea{ParseLengthFromAttr(attributes, SVGAttribute::kX, LengthType::kHorrizontal),
+                ParseLengthFromAttr(attributes, SVGAttribute::kY, LengthType::kVertical),
+                ParseLengthFromAttr(attributes, SVGAttribute::kWidth, LengthType::kHorrizontal, imageWidth),
+                ParseLengthFromAttr(attributes, SVGAttribute::kHeight, LengthType::kVertical, imageHeight)};
 
-            std::string align;
-            std::string meetOrSlice;
-            std::vector<std::string> attrStringValues;
-            auto preserveAspectRatioAttr = child->first_attribute("preserveAspectRatio");
-            if (preserveAspectRatioAttr && SVGStringParser::ParseListOfStrings(preserveAspectRatioAttr->value(), attrStringValues)
+            boost::string_view align;
+            boost::string_view meetOrSlice;
+            std::vector<boost::string_view> attrStringValues;
+            auto preserveAspectRatio = attributes.Get(SVGAttribute::kPreserveAspectRatio);
+            if (!preserveAspectRatio.empty() && SVGStringParser::ParseListOfStrings(preserveAspectRatio, attrStringValues)
                 && attrStringValues.size() >= 1 && attrStringValues.size() <= 2)
             {
                 align = attrStringValues[0];
@@ -306,188 +921,280 @@ void SVGDocumentImpl::ParseChild(XMLNode* child)
             // Do not render 0-sized elements.
             if (imageWidth && imageHeight && clipArea.width && clipArea.height && fillArea.width && fillArea.height)
             {
-                auto image = std::unique_ptr<Image>(new Image(graphicStyle, classNames, std::move(imageData), clipArea, fillArea));
-                AddChildToCurrentGroup(std::move(image));
+                AddChildToCurrentGroup(
+                    mArena.New<Image>(graphicStyle, CopyClassNames(mArena, classNames), mArena.CopyString(base64), encoding, imageData, clipArea, fillArea));
             }
         }
     }
-    else if (elementName == "use")
+    else if (element == SVGElement::kUse)
     {
-        auto href = child->first_attribute("xlink:href");
-        if (!href)
+        auto href = attributes.Get(SVGAttribute::kXlinkHref);
+        if (href.empty() || href[0] != '#')
             return;
 
-        if (href->value()[0] != '#')
+        auto useTarget = FindUseTarget(href.substr(1));
+        if (!useTarget)
+        {
+            ++mUnresolvedReferences;
             return;
+        }
 
-        auto resourceIt = mResourceIDs.find((href->value() + 1));
-        if (resourceIt == mResourceIDs.end())
+        AffineTransform transform{1, 0, 0, 1, ParseLengthFromAttr(attributes, SVGAttribute::kX, LengthType::kHorrizontal),
+            ParseLengthFromAttr(attributes, SVGAttribute::kY, LengthType::kVertical)};
+        if (graphicStyle.transform)
+            transform.Concat(*graphicStyle.transform);
+        graphicStyle.transform = transform;
+
+        auto content = InstantiateUseTarget(useTarget, fillStyle, strokeStyle);
+        if (!content)
             return;
+        AddChildToCurrentGroup(mArena.New<Instance>(graphicStyle, CopyClassNames(mArena, classNames), content));
+    }
+    else if (element == SVGElement::kStyle ||
+             element == SVGElement::kLinearGradient ||
+             element == SVGElement::kRadialGradient ||
+             element == SVGElement::kClipPath)
+        ParseResource(child, element, attributes);
+}
 
-        mFillStyleStack.push(fillStyle);
-        mStrokeStyleStack.push(strokeStyle);
+// Maximum number of differently styled instances cached per <use> target.
+static const size_t kMaxUseInstances = 8;
 
-        auto transform = mRenderer->CreateTransform(
-            1, 0, 0, 1, ParseLengthFromAttr(child, "x", LengthType::kHorrizontal), ParseLengthFromAttr(child, "y", LengthType::kVertical));
-        if (graphicStyle.transform)
-            transform->Concat(*graphicStyle.transform);
-        graphicStyle.transform = std::move(transform);
+static bool IsSameFloat(float a, float b) { return a == b || (std::isnan(a) && std::isnan(b)); }
 
-        auto group = std::unique_ptr<Group>(new Group(graphicStyle, classNames));
-        auto tempGroupPtr = group.get();
-        AddChildToCurrentGroup(std::move(group));
-        mGroupStack.push(tempGroupPtr);
+static bool IsSameColor(const ColorImpl& a, const ColorImpl& b)
+{
+    if (a.which() != b.which())
+        return false;
+    if (a.type() == typeid(Color))
+        return boost::get<Color>(a) == boost::get<Color>(b);
+    if (a.type() == typeid(Variable))
+        return boost::get<Variable>(a) == boost::get<Variable>(b);
+    return true;
+}
 
-        if(resourceIt->second->first_node() == 0)
-            ParseChild(resourceIt->second);
-        else
-            ParseChildren(resourceIt->second);
+static bool IsSameGradient(const GradientImpl& a, const GradientImpl& b)
+{
+    if (a.type != b.type || a.method != b.method || a.transform != b.transform || !IsSameFloat(a.x1, b.x1)
+        || !IsSameFloat(a.y1, b.y1) || !IsSameFloat(a.x2, b.x2) || !IsSameFloat(a.y2, b.y2) || !IsSameFloat(a.cx, b.cx)
+        || !IsSameFloat(a.cy, b.cy) || !IsSameFloat(a.fx, b.fx) || !IsSameFloat(a.fy, b.fy) || !IsSameFloat(a.r, b.r)
+        || a.internalColorStops.size() != b.internalColorStops.size())
+        return false;
+    for (size_t i = 0; i < a.internalColorStops.size(); ++i)
+    {
+        const auto& stopA = a.internalColorStops[i];
+        const auto& stopB = b.internalColorStops[i];
+        if (std::get<0>(stopA) != std::get<0>(stopB) || !IsSameColor(std::get<1>(stopA), std::get<1>(stopB))
+            || std::get<2>(stopA) != std::get<2>(stopB))
+            return false;
+    }
+    return true;
+}
+
+static bool IsSamePaint(const PaintImpl& a, const PaintImpl& b)
+{
+    if (a.which() != b.which())
+        return false;
+    if (a.type() == typeid(Color))
+        return boost::get<Color>(a) == boost::get<Color>(b);
+    if (a.type() == typeid(Variable))
+        return boost::get<Variable>(a) == boost::get<Variable>(b);
+    if (a.type() == typeid(GradientImpl))
+        return IsSameGradient(boost::get<GradientImpl>(a), boost::get<GradientImpl>(b));
+    return true;
+}
+
+// Compares the properties that children inherit while parsing.
+static bool IsSameInheritedStyle(const FillStyleImpl& fillA, const StrokeStyleImpl& strokeA, const FillStyleImpl& fillB,
+    const StrokeStyleImpl& strokeB)
+{
+    return fillA.hasFill == fillB.hasFill && fillA.fillRule == fillB.fillRule && fillA.fillOpacity == fillB.fillOpacity
+        && fillA.visibility == fillB.visibility && fillA.clipRule == fillB.clipRule && IsSameColor(fillA.color, fillB.color)
+        && IsSamePaint(fillA.internalPaint, fillB.internalPaint) && strokeA.hasStroke == strokeB.hasStroke
+        && strokeA.strokeOpacity == strokeB.strokeOpacity && strokeA.lineWidth == strokeB.lineWidth
+        && strokeA.lineCap == strokeB.lineCap && strokeA.lineJoin == strokeB.lineJoin && strokeA.miterLimit == strokeB.miterLimit
+        && strokeA.dashArray == strokeB.dashArray && strokeA.dashOffset == strokeB.dashOffset
+        && IsSamePaint(strokeA.internalPaint, strokeB.internalPaint);
+}
 
-        mGroupStack.pop();
-        mFillStyleStack.pop();
-        mStrokeStyleStack.pop();
+const SVGDocumentImpl::Group* SVGDocumentImpl::InstantiateUseTarget(
+    XMLNode* useTarget, const FillStyleImpl& fillStyle, const StrokeStyleImpl& strokeStyle)
+{
+    // The content only depends on the inherited style and the viewBox for
+    // relative lengths. Parse it once per distinct combination.
+    auto& instances = mState->useInstances[useTarget];
+    for (const auto& instance : instances)
+    {
+        if (instance.viewBox == mViewBox && IsSameInheritedStyle(instance.fillStyle, instance.strokeStyle, fillStyle, strokeStyle))
+            return AddUseExpansions(1 + instance.useExpansions) ? instance.content : nullptr;
     }
-    else if (elementName == "symbol")
+
+    if (std::find(mState->useTargetStack.begin(), mState->useTargetStack.end(), useTarget) != mState->useTargetStack.end())
     {
-        // FIXME: Do not render <symbol> outside of <defs> section.
-        // FIXME: Remove support for symbol ASAP.
-        auto attr = child->first_attribute("viewBox");
-        if (attr)
-        {
-            std::vector<float> numberList;
-            if (SVGStringParser::ParseListOfNumbers(std::string(attr->value()), numberList) && numberList.size() == 4)
-                graphicStyle.transform = mRenderer->CreateTransform(1, 0, 0, 1, -numberList[0], -numberList[1]);
-            {
-                mViewBox = {{numberList[0], numberList[1], numberList[2], numberList[3]}};
-            }
-        }
+        SetLimitError(ParseErrorCode::kReferenceCycle);
+        return nullptr;
+    }
+    if (!AddUseExpansions(1))
+        return nullptr;
+
+    UseInstance instance{mViewBox, fillStyle, strokeStyle, nullptr, mUseExpansions};
 
-        auto group = std::unique_ptr<Group>(new Group(graphicStyle, classNames));
-        mGroupStack.push(group.get());
-        AddChildToCurrentGroup(std::move(group));
+    mState->useTargetStack.push_back(useTarget);
+    EnterLevel();
+    mState->fillStyleStack.push(fillStyle);
+    mState->strokeStyleStack.push(strokeStyle);
 
-        ParseChildren(child);
+    GraphicStyleImpl graphicStyle{};
+    std::set<std::string> classNames;
+    auto content = mArena.New<Group>(graphicStyle, CopyClassNames(mArena, classNames));
+    mState->groupStack.push(content);
 
-        mGroupStack.pop();
+    if (!useTarget->firstChild)
+        ParseChild(useTarget);
+    else
+        ParseChildren(useTarget);
+
+    mState->groupStack.pop();
+    mState->fillStyleStack.pop();
+    mState->strokeStyleStack.pop();
+    LeaveLevel();
+    mState->useTargetStack.pop_back();
+
+    if (mLimitError != ParseErrorCode::kNone)
+        return nullptr;
+    instance.useExpansions = mUseExpansions - instance.useExpansions;
+
+    // Parsing may have added other targets and invalidated instances. Targets
+    // used with many different styles are not worth the linear lookup.
+    auto& cachedInstances = mState->useInstances[useTarget];
+    if (cachedInstances.size() < kMaxUseInstances)
+    {
+        instance.content = content;
+        cachedInstances.push_back(instance);
     }
-    else if (elementName == "style" ||
-             elementName == "linearGradient" ||
-             elementName == "radialGradient" ||
-             elementName == "clipPath")
-        ParseResource(child);
+    return content;
 }
 
 void SVGDocumentImpl::ParseResources(XMLNode* node)
 {
-    for (auto child = node->first_node(); child != nullptr; child = child->next_sibling())
+    for (auto child = node->firstChild; child != nullptr; child = child->nextSibling)
     {
         ParseResource(child);
     }
 }
 
-void SVGDocumentImpl::ParseResource(XMLNode* child)
+void SVGDocumentImpl::ParseResource(XMLNode* child) { ParseResource(child, ClassifyElement(child), CollectAttributes(child)); }
+
+void SVGDocumentImpl::ParseResource(XMLNode* child, SVGElement element, const SVGAttributeSet& attributes)
 {
-    auto fillStyle = mFillStyleStack.top();
-    auto strokeStyle = mStrokeStyleStack.top();
+    auto fillStyle = mState->fillStyleStack.top();
+    auto strokeStyle = mState->strokeStyleStack.top();
     std::set<std::string> classNames;
-    auto graphicStyle = ParseGraphic(child, fillStyle, strokeStyle, classNames);
+    auto graphicStyle = ParseGraphic(attributes, fillStyle, strokeStyle, classNames);
 
-    std::string elementName = child->name();
-    if (elementName == "linearGradient" || elementName == "radialGradient")
+    if (element == SVGElement::kLinearGradient || element == SVGElement::kRadialGradient)
     {
-        mFillStyleStack.push(fillStyle);
-        mStrokeStyleStack.push(strokeStyle);
+        mState->fillStyleStack.push(fillStyle);
+        mState->strokeStyleStack.push(strokeStyle);
 
-        ParseGradient(child);
+        ParseGradient(child, element);
 
-        mFillStyleStack.pop();
-        mStrokeStyleStack.pop();
+        mState->fillStyleStack.pop();
+        mState->strokeStyleStack.pop();
     }
-    else if (elementName == "style")
+    else if (element == SVGElement::kStyle)
         ParseStyle(child);
-    else if (elementName == "clipPath")
+    else if (element == SVGElement::kClipPath)
     {
-        auto id = child->first_attribute("id");
-        if (!id)
+        auto id = attributes.Get(SVGAttribute::kId);
+        if (id.empty())
             return;
 
-        mFillStyleStack.push(fillStyle);
-        mStrokeStyleStack.push(strokeStyle);
+        mState->fillStyleStack.push(fillStyle);
+        mState->strokeStyleStack.push(strokeStyle);
 
         // SVG only allows shapes (and <use> elements referencing shapes) as children of
         // <clipPath>. Ignore all other elements.
         bool hasClipContent{false};
-        for (auto clipPathChild = child->first_node(); clipPathChild != nullptr; clipPathChild = clipPathChild->next_sibling())
+        for (auto clipPathChild = child->firstChild; clipPathChild != nullptr; clipPathChild = clipPathChild->nextSibling)
         {
             // WebKit and Blink allow the clipping path if there is at least one valid basic shape child.
-            if (auto path = ParseShape(clipPathChild))
+            auto clipPathChildAttributes = CollectAttributes(clipPathChild);
+            if (auto path = ParseShape(ClassifyElement(clipPathChild), clipPathChildAttributes))
             {
-                std::unique_ptr<Transform> transform;
-                if (auto transformAttr = clipPathChild->first_attribute("transform"))
-                {
-                    auto transformHandler = [&]() {
-                        SVG_ASSERT(mRenderer != nullptr);
-                        return mRenderer->CreateTransform();
-                    };
-                    transform = SVGStringParser::ParseTransform(transformAttr->value(), transformHandler);
-                }
-                auto fillStyleChild = mFillStyleStack.top();
-                auto strokeStyleChild = mStrokeStyleStack.top();
+                boost::optional<AffineTransform> transform;
+                auto transformString = clipPathChildAttributes.Get(SVGAttribute::kTransform);
+                AffineTransform matrix;
+                if (!transformString.empty() && SVGStringParser::ParseTransform(transformString, matrix))
+                    transform = matrix;
+                auto fillStyleChild = mState->fillStyleStack.top();
+                auto strokeStyleChild = mState->strokeStyleStack.top();
                 std::set<std::string> classNames;
-                ParseGraphic(child, fillStyleChild, strokeStyleChild, classNames);
-                mClippingPaths[id->value()] = std::make_shared<ClippingPath>(true, fillStyleChild.clipRule, std::move(path), std::move(transform));
+                ParseGraphic(attributes, fillStyleChild, strokeStyleChild, classNames);
+                AddResource(id).clippingPath = mArena.New<ClippingPathImpl>(true, fillStyleChild.clipRule, path, transform);
                 hasClipContent = true;
                 break;
             }
         }
         if (!hasClipContent)
-            mClippingPaths[id->value()] = std::make_shared<ClippingPath>(false, WindingRule::kNonZero, nullptr, nullptr);
-        mFillStyleStack.pop();
-        mStrokeStyleStack.pop();
+            AddResource(id).clippingPath = mArena.New<ClippingPathImpl>();
+        mState->fillStyleStack.pop();
+        mState->strokeStyleStack.pop();
     }
     else
     {
-        auto id = child->first_attribute("id");
-        if (!id)
+        auto id = attributes.Get(SVGAttribute::kId);
+        if (id.empty())
             return;
 
-        mResourceIDs[id->value()] = child;
+        AddResource(id).useTarget = child;
     }
 }
 
-std::unique_ptr<Path> SVGDocumentImpl::ParseShape(XMLNode* child)
+// Clipping paths are shared between elements and record their path in the
+// arena. Rendering replays it into a clipping path of the renderer.
+const SVGPathData* SVGDocumentImpl::ParseShape(SVGElement element, const SVGAttributeSet& attributes)
 {
-    std::string elementName = child->name();
-    if (elementName == "rect")
-    {
-        float x = ParseLengthFromAttr(child, "x", LengthType::kHorrizontal);
-        float y = ParseLengthFromAttr(child, "y", LengthType::kVertical);
+    ShapeGeometry geometry;
+    if (!ParseShapeGeometry(element, attributes, geometry))
+        return nullptr;
+    size_t segmentCount{};
+    auto path = RecordShapePath(geometry, &segmentCount);
+    if (!AddPathSegments(segmentCount))
+        return nullptr;
+    return path;
+}
 
-        float width = ParseLengthFromAttr(child, "width", LengthType::kHorrizontal);
-        float height = ParseLengthFromAttr(child, "height", LengthType::kVertical);
+bool SVGDocumentImpl::ParseShapeGeometry(SVGElement element, const SVGAttributeSet& attributes, ShapeGeometry& geometry)
+{
+    auto& values = geometry.values;
+    if (element == SVGElement::kRect)
+    {
+        float width = ParseLengthFromAttr(attributes, SVGAttribute::kWidth, LengthType::kHorrizontal);
+        float height = ParseLengthFromAttr(attributes, SVGAttribute::kHeight, LengthType::kVertical);
 
-        bool hasRx = HasAttr(child, "rx");
-        bool hasRy = HasAttr(child, "ry");
+        bool hasRx = attributes.Has(SVGAttribute::kRx);
+        bool hasRy = attributes.Has(SVGAttribute::kRy);
 
         float rx{};
         float ry{};
         if (hasRx && hasRy)
         {
-            rx = ParseLengthFromAttr(child, "rx", LengthType::kHorrizontal);
-            ry = ParseLengthFromAttr(child, "ry", LengthType::kVertical);
+            rx = ParseLengthFromAttr(attributes, SVGAttribute::kRx, LengthType::kHorrizontal);
+            ry = ParseLengthFromAttr(attributes, SVGAttribute::kRy, LengthType::kVertical);
         }
         else if (hasRx)
         {
             // the svg spec says that rect elements that specify a rx but not a ry
             // should use the rx value for ry
-            rx = ParseLengthFromAttr(child, "rx", LengthType::kHorrizontal);
+            rx = ParseLengthFromAttr(attributes, SVGAttribute::kRx, LengthType::kHorrizontal);
             ry = rx;
         }
         else if (hasRy)
         {
             // the svg spec says that rect elements that specify a ry but not a rx
             // should use the ry value for rx
-            ry = ParseLengthFromAttr(child, "ry", LengthType::kVertical);
+            ry = ParseLengthFromAttr(attributes, SVGAttribute::kRy, LengthType::kVertical);
             rx = ry;
         }
         else
@@ -496,216 +1203,235 @@ std::unique_ptr<Path> SVGDocumentImpl::ParseShape(XMLNode* child)
             ry = 0;
         }
 
-        rx = std::min(rx, width / 2.0f);
-        ry = std::min(ry, height / 2.0f);
+        values = {{ParseLengthFromAttr(attributes, SVGAttribute::kX, LengthType::kHorrizontal),
+            ParseLengthFromAttr(attributes, SVGAttribute::kY, LengthType::kVertical), width, height, std::min(rx, width / 2.0f),
+            std::min(ry, height / 2.0f)}};
+    }
+    else if (element == SVGElement::kEllipse || element == SVGElement::kCircle)
+    {
+        float rx{}, ry{};
 
-        auto path = mRenderer->CreatePath();
-        if (rx == 0 && ry == 0)
+        if (element == SVGElement::kEllipse)
         {
-            path->Rect(x, y, width, height);
+            rx = ParseLengthFromAttr(attributes, SVGAttribute::kRx, LengthType::kHorrizontal);
+            ry = ParseLengthFromAttr(attributes, SVGAttribute::kRy, LengthType::kVertical);
         }
         else
         {
-            SVG_ASSERT(rx == ry);
-            path->RoundedRect(x, y, width, height, std::max(rx, ry));
+            rx = ParseLengthFromAttr(attributes, SVGAttribute::kR, LengthType::kDiagonal);
+            ry = rx;
         }
-        return path;
+
+        values = {{ParseLengthFromAttr(attributes, SVGAttribute::kCx, LengthType::kHorrizontal),
+            ParseLengthFromAttr(attributes, SVGAttribute::kCy, LengthType::kVertical), rx, ry}};
     }
-    else if (elementName == "ellipse" || elementName == "circle")
+    else if (element == SVGElement::kPolygon || element == SVGElement::kPolyline)
     {
-        float rx{}, ry{};
+        // Only a missing attribute drops the shape. An empty one draws an empty path.
+        if (!attributes.Has(SVGAttribute::kPoints))
+            return false;
+        geometry.data = attributes.Get(SVGAttribute::kPoints);
+    }
+    else if (element == SVGElement::kPath)
+    {
+        // Only a missing attribute drops the shape. An empty one draws an empty path.
+        if (!attributes.Has(SVGAttribute::kD))
+            return false;
+        geometry.data = attributes.Get(SVGAttribute::kD);
+    }
+    else if (element == SVGElement::kLine)
+    {
+        values = {{ParseLengthFromAttr(attributes, SVGAttribute::kX1, LengthType::kHorrizontal),
+            ParseLengthFromAttr(attributes, SVGAttribute::kY1, LengthType::kVertical),
+            ParseLengthFromAttr(attributes, SVGAttribute::kX2, LengthType::kHorrizontal),
+            ParseLengthFromAttr(attributes, SVGAttribute::kY2, LengthType::kVertical)}};
+    }
+    else
+        return false;
+
+    geometry.element = element;
+    return true;
+}
 
-        if (elementName == "ellipse")
+const SVGPathData* SVGDocumentImpl::RecordShapePath(const ShapeGeometry& geometry, size_t* segmentCount)
+{
+    auto& pathRecorder = mState->pathRecorder;
+    pathRecorder.Clear();
+    AddShapeToPath(geometry, pathRecorder, segmentCount);
+    return pathRecorder.Create(mArena);
+}
+
+void SVGDocumentImpl::AddShapeToPath(const ShapeGeometry& geometry, Path& path, size_t* segmentCount) const
+{
+    const auto& values = geometry.values;
+    // Basic shapes count with the segments of their outline.
+    size_t segments{4};
+    switch (geometry.element)
+    {
+    case SVGElement::kRect:
+    {
+        float rx = values[4];
+        float ry = values[5];
+        if (rx == 0 && ry == 0)
         {
-            rx = ParseLengthFromAttr(child, "rx", LengthType::kHorrizontal);
-            ry = ParseLengthFromAttr(child, "ry", LengthType::kVertical);
+            path.Rect(values[0], values[1], values[2], values[3]);
         }
         else
         {
-            rx = ParseLengthFromAttr(child, "r", LengthType::kDiagonal);
-            ry = rx;
+            SVG_ASSERT(rx == ry);
+            path.RoundedRect(values[0], values[1], values[2], values[3], std::max(rx, ry));
+            segments = 8;
         }
-
-        float cx = ParseLengthFromAttr(child, "cx", LengthType::kHorrizontal);
-        float cy = ParseLengthFromAttr(child, "cy", LengthType::kVertical);
-
-        auto path = mRenderer->CreatePath();
-        path->Ellipse(cx, cy, rx, ry);
-
-        return path;
+        break;
     }
-    else if (elementName == "polygon" || elementName == "polyline")
+    case SVGElement::kEllipse:
+    case SVGElement::kCircle:
+        path.Ellipse(values[0], values[1], values[2], values[3]);
+        break;
+    case SVGElement::kPolygon:
+    case SVGElement::kPolyline:
     {
-        auto attr = child->first_attribute("points");
-        if (!attr)
-            return nullptr;
         // This does not follow the spec which requires at least one space or comma between
         // coordinate pairs. However, Blink and WebKit do it the same way.
-        std::vector<float> numberList;
-        SVGStringParser::ParseListOfNumbers(attr->value(), numberList);
+        // Reuse the capacity of the parse state. Lazy geometry is created
+        // after parsing ended.
+        std::vector<float> localNumberList;
+        auto& numberList = mState ? mState->numberList : localNumberList;
+        numberList.clear();
+        SVGStringParser::ParseListOfNumbers(geometry.data, numberList);
         size_t size = numberList.size();
-        auto path = mRenderer->CreatePath();
         if (size > 1)
         {
             if (size % 2 == 1)
                 --size;
             size_t i{};
-            path->MoveTo(numberList[i], numberList[i + 1]);
+            path.MoveTo(numberList[i], numberList[i + 1]);
             i += 2;
             for (; i < size; i += 2)
-                path->LineTo(numberList[i], numberList[i + 1]);
-            if (elementName == "polygon")
-                path->ClosePath();
+                path.LineTo(numberList[i], numberList[i + 1]);
+            if (geometry.element == SVGElement::kPolygon)
+                path.ClosePath();
         }
-
-        return path;
+        segments = size / 2 + 1;
+        break;
     }
-    else if (elementName == "path")
+    case SVGElement::kPath:
     {
-        auto attr = child->first_attribute("d");
-        if (!attr)
-            return nullptr;
-
-        auto path = mRenderer->CreatePath();
-        SVGStringParser::ParsePathString(attr->value(), *path);
-
-        return path;
+        // Stop early if the path alone exceeds the remaining budget.
+        size_t maxSegments = mPathSegments < mLimits.maxPathSegments ? mLimits.maxPathSegments - mPathSegments : 0;
+        segments = 0;
+        SVGStringParser::ParsePathString(geometry.data, path, segments, segmentCount ? maxSegments : std::numeric_limits<size_t>::max());
+        break;
     }
-    else if (elementName == "line")
-    {
-        auto path = mRenderer->CreatePath();
-        path->MoveTo(ParseLengthFromAttr(child, "x1", LengthType::kHorrizontal), ParseLengthFromAttr(child, "y1", LengthType::kVertical));
-        path->LineTo(ParseLengthFromAttr(child, "x2", LengthType::kHorrizontal), ParseLengthFromAttr(child, "y2", LengthType::kVertical));
-
-        return path;
+    case SVGElement::kLine:
+        path.MoveTo(values[0], values[1]);
+        path.LineTo(values[2], values[3]);
+        segments = 2;
+        break;
+    default:
+        SVG_ASSERT_MSG(false, "Unknown shape");
+        break;
     }
-    return nullptr;
+    if (segmentCount)
+        *segmentCount = segments;
 }
 
 GraphicStyleImpl SVGDocumentImpl::ParseGraphic(
-    XMLNode* node, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle, std::set<std::string>& classNames)
+    const SVGAttributeSet& attributes, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle, std::set<std::string>& classNames)
 {
-    std::vector<PropertySet> propertySets;
-    propertySets.push_back(ParsePresentationAttributes(node));
-    ParseStyleAttr(node, propertySets, classNames);
-
+    // Presentation attributes first. Values from the style attribute override them.
     GraphicStyleImpl graphicStyle{};
-    for (const auto& propertySet : propertySets)
-    {
-        ParseGraphicsProperties(graphicStyle, propertySet);
-        ParseFillProperties(fillStyle, propertySet);
-        ParseStrokeProperties(strokeStyle, propertySet);
-    }
+    ParseGraphicsProperties(graphicStyle, attributes);
+    ParseFillProperties(fillStyle, attributes);
+    ParseStrokeProperties(strokeStyle, attributes);
+    ParseStyleAttr(attributes, graphicStyle, fillStyle, strokeStyle, classNames);
 
-    auto attr = node->first_attribute("transform");
-    if (attr)
-    {
-        auto transformHandler = [&]() {
-            SVG_ASSERT(mRenderer != nullptr);
-            return mRenderer->CreateTransform();
-        };
-        graphicStyle.transform = SVGStringParser::ParseTransform(attr->value(), transformHandler);
-    }
+    auto transformString = attributes.Get(SVGAttribute::kTransform);
+    AffineTransform transform;
+    if (!transformString.empty() && SVGStringParser::ParseTransform(transformString, transform))
+        graphicStyle.transform = transform;
 
     return graphicStyle;
 }
 
-PropertySet SVGDocumentImpl::ParsePresentationAttributes(XMLNode* node)
-{
-    PropertySet propertySet;
-    auto attributeHandler = [&](const std::string& propertyName) {
-        auto attr = node->first_attribute(propertyName.c_str());
-        if (attr)
-            propertySet.insert({propertyName, attr->value()});
-    };
-    for (const auto& propertyName : gInheritedPropertyNames)
-        attributeHandler(propertyName);
-    for (const auto& propertyName : gNonInheritedPropertyNames)
-        attributeHandler(propertyName);
-    return propertySet;
-}
-
 void SVGDocumentImpl::ParseFillProperties(FillStyleImpl& fillStyle, const PropertySet& propertySet)
 {
-    auto prop = propertySet.find("fill");
-    auto iterEnd = propertySet.end();
-    if (prop != iterEnd)
+    auto prop = propertySet.Get(SVGAttribute::kFill);
+    if (!prop.empty())
     {
-        auto result = SVGStringParser::ParsePaint(prop->second.c_str(), mGradients, mViewBox, fillStyle.internalPaint);
+        auto result = SVGStringParser::ParsePaint(
+            prop, [this](boost::string_view id) { return FindGradient(id); }, mViewBox, fillStyle.internalPaint);
         if (result == SVGDocumentImpl::Result::kDisabled)
             fillStyle.hasFill = false;
         else if (result == SVGDocumentImpl::Result::kSuccess)
             fillStyle.hasFill = true;
     }
 
-    prop = propertySet.find("fill-opacity");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kFillOpacity);
+    if (!prop.empty())
     {
         float opacity{};
-        if (SVGStringParser::ParseNumber(prop->second.c_str(), opacity))
+        if (SVGStringParser::ParseNumber(prop, opacity))
             fillStyle.fillOpacity = std::max<float>(0.0, std::min<float>(1.0, opacity));
     }
 
-    prop = propertySet.find("fill-rule");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kFillRule);
+    if (!prop.empty())
     {
-        auto fillRuleString = std::string(prop->second.c_str());
-        if (fillRuleString == "evenodd")
+        if (prop == "evenodd")
             fillStyle.fillRule = WindingRule::kEvenOdd;
-        else if (fillRuleString == "nonzero")
+        else if (prop == "nonzero")
             fillStyle.fillRule = WindingRule::kNonZero;
     }
 
     // Other inherited properties
-    prop = propertySet.find("color");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kColor);
+    if (!prop.empty())
     {
         ColorImpl color = Color{{0.0f, 0.0f, 0.0f, 1.0f}};
-        auto result = SVGStringParser::ParseColor(prop->second.c_str(), color, false);
+        auto result = SVGStringParser::ParseColor(prop, color, false);
         if (result == SVGDocumentImpl::Result::kSuccess)
             fillStyle.color = color;
     }
 
-    prop = propertySet.find("visibility");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kVisibility);
+    if (!prop.empty())
     {
-        auto visibilityString = std::string(prop->second.c_str());
-        if (visibilityString == "hidden")
+        if (prop == "hidden")
             fillStyle.visibility = false;
-        else if (visibilityString == "collapse" || visibilityString == "visible")
+        else if (prop == "collapse" || prop == "visible")
             fillStyle.visibility = true;
     }
 
-    prop = propertySet.find("clip-rule");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kClipRule);
+    if (!prop.empty())
     {
-        if (std::string(prop->second.c_str()) == "evenodd")
+        if (prop == "evenodd")
             fillStyle.clipRule = WindingRule::kEvenOdd;
-        else if (std::string(prop->second.c_str()) == "nonzero")
+        else if (prop == "nonzero")
             fillStyle.clipRule = WindingRule::kNonZero;
     }
 }
 
 void SVGDocumentImpl::ParseStrokeProperties(StrokeStyleImpl& strokeStyle, const PropertySet& propertySet)
 {
-    auto prop = propertySet.find("stroke");
-    auto iterEnd = propertySet.end();
-    if (prop != iterEnd)
+    auto prop = propertySet.Get(SVGAttribute::kStroke);
+    if (!prop.empty())
     {
-        std::string strokeValue = prop->second;
-        auto result = SVGStringParser::ParsePaint(strokeValue.c_str(), mGradients, mViewBox, strokeStyle.internalPaint);
+        auto result = SVGStringParser::ParsePaint(
+            prop, [this](boost::string_view id) { return FindGradient(id); }, mViewBox, strokeStyle.internalPaint);
         if (result == SVGDocumentImpl::Result::kDisabled)
             strokeStyle.hasStroke = false;
         else if (result == SVGDocumentImpl::Result::kSuccess)
             strokeStyle.hasStroke = true;
     }
 
-    prop = propertySet.find("stroke-width");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeWidth);
+    if (!prop.empty())
     {
         float strokeWidth{};
         // Ignore stroke-width if invalid or negative.
-        if (SVGStringParser::ParseLengthOrPercentage(prop->second, RelativeLength(LengthType::kDiagonal), strokeWidth, true)
+        if (SVGStringParser::ParseLengthOrPercentage(prop, RelativeLength(LengthType::kDiagonal), strokeWidth, true)
             && strokeWidth >= 0)
             strokeStyle.lineWidth = strokeWidth;
         // Disable stroke on a stroke-width of 0.
@@ -713,46 +1439,46 @@ void SVGDocumentImpl::ParseStrokeProperties(StrokeStyleImpl& strokeStyle, const
             strokeStyle.hasStroke = false;
     }
 
-    prop = propertySet.find("stroke-linecap");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeLinecap);
+    if (!prop.empty())
     {
-        if (prop->second == "round")
+        if (prop == "round")
             strokeStyle.lineCap = LineCap::kRound;
-        else if (prop->second == "square")
+        else if (prop == "square")
             strokeStyle.lineCap = LineCap::kSquare;
     }
 
-    prop = propertySet.find("stroke-linejoin");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeLinejoin);
+    if (!prop.empty())
     {
-        if (prop->second == "round")
+        if (prop == "round")
             strokeStyle.lineJoin = LineJoin::kRound;
-        else if (prop->second == "bevel")
+        else if (prop == "bevel")
             strokeStyle.lineJoin = LineJoin::kBevel;
     }
 
-    prop = propertySet.find("stroke-miterlimit");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeMiterlimit);
+    if (!prop.empty())
     {
         float miter{};
         // Miter must be bigger 1. Otherwise ignore.
-        if (SVGStringParser::ParseNumber(prop->second.c_str(), miter) && miter >= 1)
+        if (SVGStringParser::ParseNumber(prop, miter) && miter >= 1)
             strokeStyle.miterLimit = miter;
     }
 
-    prop = propertySet.find("stroke-dashoffset");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeDashoffset);
+    if (!prop.empty())
     {
         float strokeDashoffset{};
-        if (SVGStringParser::ParseLengthOrPercentage(prop->second, RelativeLength(LengthType::kDiagonal), strokeDashoffset, true))
+        if (SVGStringParser::ParseLengthOrPercentage(prop, RelativeLength(LengthType::kDiagonal), strokeDashoffset, true))
             strokeStyle.dashOffset = strokeDashoffset;
     }
 
-    prop = propertySet.find("stroke-dasharray");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeDasharray);
+    if (!prop.empty())
     {
         float diagonal = sqrtf(mViewBox[2] * mViewBox[2] + mViewBox[3] * mViewBox[3]);
-        if (!SVGStringParser::ParseListOfLengthOrPercentage(prop->second.c_str(), diagonal, strokeStyle.dashArray, true))
+        if (!SVGStringParser::ParseListOfLengthOrPercentage(prop, diagonal, strokeStyle.dashArray, true))
             strokeStyle.dashArray.clear();
         for (auto it = strokeStyle.dashArray.begin(); it < strokeStyle.dashArray.end(); ++it)
         {
@@ -764,59 +1490,55 @@ void SVGDocumentImpl::ParseStrokeProperties(StrokeStyleImpl& strokeStyle, const
         }
     }
 
-    prop = propertySet.find("stroke-opacity");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStrokeOpacity);
+    if (!prop.empty())
     {
         float opacity{};
-        if (SVGStringParser::ParseNumber(prop->second.c_str(), opacity))
+        if (SVGStringParser::ParseNumber(prop, opacity))
             strokeStyle.strokeOpacity = std::max<float>(0.0, std::min<float>(1.0, opacity));
     }
 }
 
 void SVGDocumentImpl::ParseGraphicsProperties(GraphicStyleImpl& graphicStyle, const PropertySet& propertySet)
 {
-    auto prop = propertySet.find("opacity");
-    auto iterEnd = propertySet.end();
-    if (prop != iterEnd)
+    auto prop = propertySet.Get(SVGAttribute::kOpacity);
+    if (!prop.empty())
     {
         float opacity{};
-        if (SVGStringParser::ParseNumber(prop->second.c_str(), opacity))
+        if (SVGStringParser::ParseNumber(prop, opacity))
             graphicStyle.opacity = std::max<float>(0.0, std::min<float>(1.0, opacity));
     }
 
-    prop = propertySet.find("clip-path");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kClipPath);
+    if (prop.starts_with("url(#") && prop.ends_with(")"))
     {
         // FIXME: Use proper parser.
         auto urlLength = strlen("url(#");
-        std::string id = prop->second;
-        id = id.substr(urlLength, id.size() - urlLength - 1);
-        auto clippingPathIt = mClippingPaths.find(id);
-        if (clippingPathIt != mClippingPaths.end())
-            graphicStyle.clippingPath = clippingPathIt->second;
+        auto id = prop.substr(urlLength, prop.size() - urlLength - 1);
+        if (auto clippingPath = FindClippingPath(id))
+            graphicStyle.internalClippingPath = clippingPath;
     }
 
-    prop = propertySet.find("display");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kDisplay);
+    if (!prop.empty())
     {
-        std::string displayString = prop->second;
-        if (displayString.compare("none"))
+        if (prop.compare("none"))
             graphicStyle.display = false;
     }
 
-    prop = propertySet.find("stop-opacity");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStopOpacity);
+    if (!prop.empty())
     {
         float opacity{};
-        if (SVGStringParser::ParseNumber(prop->second.c_str(), opacity))
+        if (SVGStringParser::ParseNumber(prop, opacity))
             graphicStyle.stopOpacity = std::max<float>(0.0, std::min<float>(1.0, opacity));
     }
 
-    prop = propertySet.find("stop-color");
-    if (prop != iterEnd)
+    prop = propertySet.Get(SVGAttribute::kStopColor);
+    if (!prop.empty())
     {
         ColorImpl color = Color{{0.0f, 0.0f, 0.0f, 1.0f}};
-        auto result = SVGStringParser::ParseColor(prop->second.c_str(), color, true);
+        auto result = SVGStringParser::ParseColor(prop, color, true);
         if (result == SVGDocumentImpl::Result::kSuccess)
             graphicStyle.stopColor = color;
     }
@@ -824,16 +1546,17 @@ void SVGDocumentImpl::ParseGraphicsProperties(GraphicStyleImpl& graphicStyle, co
 
 float SVGDocumentImpl::ParseColorStop(XMLNode* node, std::vector<ColorStopImpl>& colorStops, float lastOffset)
 {
-    auto fillStyle = mFillStyleStack.top();
-    auto strokeStyle = mStrokeStyleStack.top();
+    auto fillStyle = mState->fillStyleStack.top();
+    auto strokeStyle = mState->strokeStyleStack.top();
     std::set<std::string> classNames;
-    auto graphicStyle = ParseGraphic(node, fillStyle, strokeStyle, classNames);
+    auto attributes = CollectAttributes(node);
+    auto graphicStyle = ParseGraphic(attributes, fillStyle, strokeStyle, classNames);
 
     // * New stops may never appear before previous stops. Use offset of previous stop otherwise.
     // * Stops must be in the range [0.0, 1.0].
-    auto attr = node->first_attribute("offset");
+    auto attr = attributes.Get(SVGAttribute::kOffset);
     float offset{};
-    offset = (attr && SVGStringParser::ParseNumber(attr->value(), offset)) ? offset : lastOffset;
+    offset = (!attr.empty() && SVGStringParser::ParseNumber(attr, offset)) ? offset : lastOffset;
     offset = std::max<float>(lastOffset, offset);
     offset = std::min<float>(1.0, std::max<float>(0.0, offset));
 
@@ -853,14 +1576,14 @@ float SVGDocumentImpl::ParseColorStop(XMLNode* node, std::vector<ColorStopImpl>&
 void SVGDocumentImpl::ParseColorStops(XMLNode* node, GradientImpl& gradient)
 {
     // Return early if we don't have children.
-    if (!node->first_node())
+    if (!node->firstChild)
         return;
     float lastOffset{};
 
     std::vector<ColorStopImpl> colorStops;
-    for (auto child = node->first_node(); child != nullptr; child = child->next_sibling())
+    for (auto child = node->firstChild; child != nullptr; child = child->nextSibling)
     {
-        if (std::string(child->name()) == "stop")
+        if (ClassifyElement(child) == SVGElement::kStop)
             lastOffset = ParseColorStop(child, colorStops, lastOffset);
     }
     // Make sure we always have stops in the range 0% and 100%.
@@ -879,30 +1602,28 @@ void SVGDocumentImpl::ParseColorStops(XMLNode* node, GradientImpl& gradient)
         gradient.internalColorStops = colorStops;
 }
 
-void SVGDocumentImpl::ParseGradient(XMLNode* node)
+void SVGDocumentImpl::ParseGradient(XMLNode* node, SVGElement element)
 {
     GradientImpl gradient{};
+    auto attributes = CollectAttributes(node);
 
-    // SVG allows referencing other gradients. For now, we only look at already parsed
-    // gradients. Since we add the current gradient after successful parsing,
-    // this also avoids circular references.
+    // SVG allows referencing other gradients. Gradients defined later get parsed
+    // on demand. Every definition gets parsed ahead at most once, which also
+    // breaks circular references.
     // https://www.w3.org/TR/SVG11/pservers.html#LinearGradientElementHrefAttribute
-    auto attr = node->first_attribute("xlink:href");
-    if (attr)
+    auto attr = attributes.Get(SVGAttribute::kXlinkHref);
+    if (!attr.empty())
     {
-        std::string href{attr->value()};
         // href starts with a #, ignore it.
-        auto it = mGradients.find(href.substr(1));
-        if (it != mGradients.end())
-            gradient = it->second;
+        if (auto referencedGradient = FindGradient(attr.substr(1)))
+            gradient = *referencedGradient;
     }
 
     ParseColorStops(node, gradient);
 
-    auto nodeName = std::string(node->name());
-    if (nodeName == "linearGradient")
+    if (element == SVGElement::kLinearGradient)
         gradient.type = GradientType::kLinearGradient;
-    else if (nodeName == "radialGradient")
+    else if (element == SVGElement::kRadialGradient)
         gradient.type = GradientType::kRadialGradient;
     else
     {
@@ -917,85 +1638,163 @@ void SVGDocumentImpl::ParseGradient(XMLNode* node)
     if (gradient.type == GradientType::kLinearGradient)
     {
         // https://www.w3.org/TR/SVG11/pservers.html#LinearGradients
-        if (HasAttr(node, "x1"))
-            gradient.x1 = ParseLengthFromAttr(node, "x1", LengthType::kHorrizontal);
-        if (HasAttr(node, "y1"))
-            gradient.y1 = ParseLengthFromAttr(node, "y1", LengthType::kVertical);
-        if (HasAttr(node, "x2"))
-            gradient.x2 = ParseLengthFromAttr(node, "x2", LengthType::kHorrizontal);
-        if (HasAttr(node, "y2"))
-            gradient.y2 = ParseLengthFromAttr(node, "y2", LengthType::kVertical);
+        if (attributes.Has(SVGAttribute::kX1))
+            gradient.x1 = ParseLengthFromAttr(attributes, SVGAttribute::kX1, LengthType::kHorrizontal);
+        if (attributes.Has(SVGAttribute::kY1))
+            gradient.y1 = ParseLengthFromAttr(attributes, SVGAttribute::kY1, LengthType::kVertical);
+        if (attributes.Has(SVGAttribute::kX2))
+            gradient.x2 = ParseLengthFromAttr(attributes, SVGAttribute::kX2, LengthType::kHorrizontal);
+        if (attributes.Has(SVGAttribute::kY2))
+            gradient.y2 = ParseLengthFromAttr(attributes, SVGAttribute::kY2, LengthType::kVertical);
     }
     else
     {
         // https://www.w3.org/TR/SVG11/pservers.html#RadialGradients
-        if (HasAttr(node, "cx"))
-            gradient.cx = ParseLengthFromAttr(node, "cx", LengthType::kHorrizontal);
-        if (HasAttr(node, "cy"))
-            gradient.cy = ParseLengthFromAttr(node, "cy", LengthType::kVertical);
-        if (HasAttr(node, "fx"))
-            gradient.fx = ParseLengthFromAttr(node, "fx", LengthType::kHorrizontal);
-        if (HasAttr(node, "fy"))
-            gradient.fy = ParseLengthFromAttr(node, "fy", LengthType::kVertical);
-        if (HasAttr(node, "r"))
-            gradient.r = ParseLengthFromAttr(node, "r", LengthType::kDiagonal);
-    }
-
-    attr = node->first_attribute("spreadMethod");
-    if (attr)
-    {
-        auto spreadMethodString = std::string(attr->value());
-        if (spreadMethodString == "pad")
+        if (attributes.Has(SVGAttribute::kCx))
+            gradient.cx = ParseLengthFromAttr(attributes, SVGAttribute::kCx, LengthType::kHorrizontal);
+        if (attributes.Has(SVGAttribute::kCy))
+            gradient.cy = ParseLengthFromAttr(attributes, SVGAttribute::kCy, LengthType::kVertical);
+        if (attributes.Has(SVGAttribute::kFx))
+            gradient.fx = ParseLengthFromAttr(attributes, SVGAttribute::kFx, LengthType::kHorrizontal);
+        if (attributes.Has(SVGAttribute::kFy))
+            gradient.fy = ParseLengthFromAttr(attributes, SVGAttribute::kFy, LengthType::kVertical);
+        if (attributes.Has(SVGAttribute::kR))
+            gradient.r = ParseLengthFromAttr(attributes, SVGAttribute::kR, LengthType::kDiagonal);
+    }
+
+    attr = attributes.Get(SVGAttribute::kSpreadMethod);
+    if (!attr.empty())
+    {
+        if (attr == "pad")
             gradient.method = SpreadMethod::kPad;
-        else if (spreadMethodString == "reflect")
+        else if (attr == "reflect")
             gradient.method = SpreadMethod::kReflect;
-        else if (spreadMethodString == "repeat")
+        else if (attr == "repeat")
             gradient.method = SpreadMethod::kRepeat;
     }
-    attr = node->first_attribute("gradientTransform");
-    if (attr)
+    attr = attributes.Get(SVGAttribute::kGradientTransform);
+    if (!attr.empty())
     {
-        auto transformHandler = [&]() {
-            SVG_ASSERT(mRenderer != nullptr);
-            return mRenderer->CreateTransform();
-        };
-        gradient.transform = SVGStringParser::ParseTransform(attr->value(), transformHandler);
+        // An invalid transform drops the one inherited from the referenced gradient.
+        AffineTransform transform;
+        if (SVGStringParser::ParseTransform(attr, transform))
+            gradient.transform = transform;
+        else
+            gradient.transform = boost::none;
     }
 
-    attr = node->first_attribute("id");
-    if (attr)
-        mGradients.insert({attr->value(), gradient});
+    attr = attributes.Get(SVGAttribute::kId);
+    if (!attr.empty())
+    {
+        // The first gradient with an ID wins.
+        auto& resource = AddResource(attr);
+        if (!resource.gradient)
+            resource.gradient = std::make_shared<const GradientImpl>(std::move(gradient));
+    }
 }
 
+// Renderer objects of one Render() call.
+struct SVGDocumentImpl::RenderTarget
+{
+    SVGRenderer& renderer;
+    // Set for the document renderer if its paths get kept in the document.
+    SVGAllocator* allocator;
+    // Clipping paths of renderer by the clipping paths of the document.
+    std::unordered_map<const ClippingPathImpl*, std::shared_ptr<ClippingPath>>& clippingPaths;
+    // Path of the graphic being drawn if paths do not get kept.
+    std::unique_ptr<Path> path;
+    // Decoded images of renderer if it is not the document renderer.
+    SVGImageCacheImpl* imageCache;
+};
+
 void SVGDocumentImpl::Render(const ColorMap& colorMap, float width, float height)
+{
+    if (!mRenderer)
+        return;
+    RenderTarget target{*mRenderer, &mArena, mRendererClippingPaths, nullptr, nullptr};
+    Render(target, colorMap, width, height);
+}
+
+void SVGDocumentImpl::Render(
+    SVGRenderer& renderer, const ColorMap& colorMap, float width, float height, SVGImageCacheImpl* imageCache) const
+{
+    // Everything the call creates is local or in the cache of the caller.
+    // The document only gets read.
+    std::unordered_map<const ClippingPathImpl*, std::shared_ptr<ClippingPath>> clippingPaths;
+    RenderTarget target{renderer, nullptr, clippingPaths, nullptr, imageCache};
+    Render(target, colorMap, width, height);
+}
+
+void SVGDocumentImpl::Render(RenderTarget& target, const ColorMap& colorMap, float width, float height) const
 {
     SVG_ASSERT(mGroup);
     if (!mGroup)
         return;
 
+    auto& renderer = target.renderer;
+
     float scale = width / mViewBox[2];
     if (scale > height / mViewBox[3])
         scale = height / mViewBox[3];
 
     GraphicStyleImpl graphicStyle{};
-    graphicStyle.transform = mRenderer->CreateTransform();
-    graphicStyle.transform->Translate(-1 * mViewBox[0], -1 * mViewBox[1]);
-    graphicStyle.transform->Scale(scale, scale);
+    AffineTransform transform;
+    transform.Translate(-1 * mViewBox[0], -1 * mViewBox[1]);
+    transform.Scale(scale, scale);
+    graphicStyle.transform = transform;
 
-    mRenderer->Save(graphicStyle);
+    renderer.Save(graphicStyle);
 
-    TraverseTree(colorMap, mGroup.get());
+    // Walk the render nodes linearly, starting with the root group. Entering
+    // a group or instance saves the range to continue with afterwards.
+    struct Range
+    {
+        std::uint32_t next;
+        std::uint32_t end;
+    };
+    std::vector<Range> ranges;
+    std::uint32_t index{};
+    std::uint32_t end = mRenderNodes.empty() ? 0 : mRenderNodes.front().next;
+    while (true)
+    {
+        if (index == end)
+        {
+            if (ranges.empty())
+                break;
+            renderer.Restore();
+            index = ranges.back().next;
+            end = ranges.back().end;
+            ranges.pop_back();
+            continue;
+        }
+        const auto& node = mRenderNodes[index];
+        if (node.culled)
+            index = node.next;
+        else if (node.type == ElementType::kGroup || node.type == ElementType::kInstance)
+        {
+            GraphicStyle storage;
+            renderer.Save(TargetStyle(target, node.element->graphicStyle, storage));
+            ranges.push_back({node.next, end});
+            index = node.childBegin;
+            end = node.childEnd;
+        }
+        else
+        {
+            DrawElement(target, colorMap, node);
+            index = node.next;
+        }
+    }
 
-    mRenderer->Restore();
+    renderer.Restore();
 }
 
-void SVGDocumentImpl::AddChildToCurrentGroup(std::unique_ptr<Element> element)
+void SVGDocumentImpl::AddChildToCurrentGroup(Element* element)
 {
-    SVG_ASSERT(!mGroupStack.empty());
-    if (mGroupStack.empty())
+    SVG_ASSERT(!mState->groupStack.empty());
+    if (mState->groupStack.empty())
         return;
 
-    mGroupStack.top()->children.push_back(std::move(element));
+    mState->groupStack.top()->AppendChild(element);
 }
 
 static void ResolveColorImpl(const ColorMap& colorMap, const ColorImpl& colorImpl, Color& color)
@@ -1056,67 +1855,226 @@ static void ResolvePaintImpl(const ColorMap& colorMap, const PaintImpl& internal
         SVG_ASSERT_MSG(false, "Unhandled PaintImpl type");
 }
 
-void SVGDocumentImpl::TraverseTree(const ColorMap& colorMap, const Element* element)
+// Whether a paint resolves to the same value for every color map.
+static bool IsStaticPaint(const PaintImpl& paint, const ColorImpl& currentColor)
+{
+    if (paint.type() == typeid(Variable))
+        return false;
+    if (paint.type() == typeid(ColorKeys))
+        return currentColor.type() != typeid(Variable);
+    if (paint.type() == typeid(GradientImpl))
+    {
+        for (const auto& colorStop : boost::get<GradientImpl>(paint).internalColorStops)
+        {
+            if (std::get<1>(colorStop).type() == typeid(Variable))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Resolves the paints of a graphic for the renderer.
+static void ResolveStyles(const ColorMap& colorMap, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle)
+{
+    // If we habe a CSS var() function we need to replace the placeholder with
+    // an actual color from our externally provided color map here.
+    Color color{{0.0f, 0.0f, 0.0f, 1.0f}};
+    ResolveColorImpl(colorMap, fillStyle.color, color);
+    ResolvePaintImpl(colorMap, fillStyle.internalPaint, color, fillStyle.paint);
+    ResolvePaintImpl(colorMap, strokeStyle.internalPaint, color, strokeStyle.paint);
+}
+
+ClassNames SVGDocumentImpl::CopyClassNames(SVGArena& arena, const std::set<std::string>& classNames)
+{
+    ClassNames result;
+    if (classNames.empty())
+        return result;
+    auto names = static_cast<boost::string_view*>(arena.Allocate(sizeof(boost::string_view) * classNames.size(), alignof(boost::string_view)));
+    for (const auto& className : classNames)
+        names[result.count++] = arena.CopyString(className);
+    result.names = names;
+    return result;
+}
+
+void SVGDocumentImpl::ResolveStaticStyle(Graphic& graphic)
+{
+#ifndef STYLE_SUPPORT
+    // Without style sheets, only color map entries change the style of a
+    // graphic while rendering.
+    if (IsStaticPaint(graphic.fillStyle.internalPaint, graphic.fillStyle.color)
+        && IsStaticPaint(graphic.strokeStyle.internalPaint, graphic.fillStyle.color))
+    {
+        ResolveStyles(ColorMap{}, graphic.fillStyle, graphic.strokeStyle);
+        graphic.resolvedStyle = true;
+    }
+#else
+    (void)graphic;
+#endif
+}
+
+void SVGDocumentImpl::FlattenTree()
 {
-    SVG_ASSERT(element);
-    if (!element)
+    mRenderNodes.clear();
+    if (!mGroup)
         return;
 
+    // Instances get the range of their content once the document tree is
+    // done. Content shared by several instances gets flattened once and may
+    // contain further instances.
+    std::vector<std::uint32_t> instances;
+    AppendRenderNode(mGroup, instances);
+    std::unordered_map<const Group*, std::pair<std::uint32_t, std::uint32_t>> contentRanges;
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        auto index = instances[i];
+        auto content = static_cast<const Instance*>(mRenderNodes[index].element)->content;
+        auto range = contentRanges.find(content);
+        if (range == contentRanges.end())
+        {
+            auto begin = static_cast<std::uint32_t>(mRenderNodes.size());
+            AppendRenderNodes(content, instances);
+            range = contentRanges.emplace(content, std::make_pair(begin, static_cast<std::uint32_t>(mRenderNodes.size()))).first;
+        }
+        mRenderNodes[index].childBegin = range->second.first;
+        mRenderNodes[index].childEnd = range->second.second;
+    }
+}
+
+void SVGDocumentImpl::AppendRenderNode(Element* element, std::vector<std::uint32_t>& instances)
+{
+    auto index = static_cast<std::uint32_t>(mRenderNodes.size());
+    auto clippingPath = element->graphicStyle.internalClippingPath;
+    bool culled = clippingPath && !clippingPath->hasClipContent;
+    mRenderNodes.push_back({element->type, culled, element->resolvedStyle, 0, index + 1, index + 1, element});
+    if (!culled && element->type == ElementType::kGroup)
+        AppendRenderNodes(static_cast<const Group*>(element), instances);
+    else if (!culled && element->type == ElementType::kInstance)
+        instances.push_back(index);
+
+    auto& node = mRenderNodes[index];
+    node.next = static_cast<std::uint32_t>(mRenderNodes.size());
+    if (node.type == ElementType::kGroup)
+        node.childEnd = node.next;
+}
+
+void SVGDocumentImpl::AppendRenderNodes(const Group* group, std::vector<std::uint32_t>& instances)
+{
+    for (auto child = group->firstChild; child != nullptr; child = child->nextSibling)
+        AppendRenderNode(child, instances);
+}
+
+const GraphicStyle& SVGDocumentImpl::TargetStyle(RenderTarget& target, const GraphicStyleImpl& graphicStyle, GraphicStyle& storage) const
+{
+    auto clippingPath = graphicStyle.internalClippingPath;
+    if (!clippingPath || !clippingPath->path)
+        return graphicStyle;
+
+    auto& targetClippingPath = target.clippingPaths[clippingPath];
+    if (!targetClippingPath)
+    {
+        std::shared_ptr<Path> path = target.renderer.CreatePath();
+        clippingPath->path->Replay(*path);
+        targetClippingPath = std::make_shared<ClippingPath>(clippingPath->hasClipContent, clippingPath->clipRule, path, clippingPath->transform);
+    }
+    storage = graphicStyle;
+    storage.clippingPath = targetClippingPath;
+    return storage;
+}
+
+const Path& SVGDocumentImpl::TargetPath(RenderTarget& target, const Graphic& graphic) const
+{
+    Path* path{};
+    if (!target.allocator)
+    {
+        target.path = target.renderer.CreatePath();
+        path = target.path.get();
+    }
+    else if (graphic.path)
+        return *graphic.path;
+    else
+        path = graphic.path = target.renderer.AllocatePath(*target.allocator);
+
+    if (graphic.pathData)
+        graphic.pathData->Replay(*path);
+    else
+        AddShapeToPath(graphic.geometry, *path, nullptr);
+    return *path;
+}
+
+void SVGDocumentImpl::DrawElement(RenderTarget& target, const ColorMap& colorMap, const RenderNode& node) const
+{
+    const auto element = node.element;
+    GraphicStyle storage;
+    if (node.resolvedStyle)
+    {
+        const auto graphic = static_cast<const Graphic*>(element);
+        target.renderer.DrawPath(TargetPath(target, *graphic), TargetStyle(target, graphic->graphicStyle, storage),
+            graphic->fillStyle, graphic->strokeStyle);
+        return;
+    }
+
     // Inheritance doesn't work for override styles. Since override styles
     // are deprecated, we are not going to fix this nor is this expected by
     // (still existing) clients.
     auto graphicStyle = element->graphicStyle;
     FillStyleImpl fillStyle{};
     StrokeStyleImpl strokeStyle{};
-    // Do not draw element if an applied clipPath has no content.
-    if (graphicStyle.clippingPath && !graphicStyle.clippingPath->hasClipContent)
-        return;
-    switch (element->Type())
+    switch (element->type)
     {
     case ElementType::kGraphic:
     {
         const auto graphic = static_cast<const Graphic*>(element);
-        // TODO: Since we keep the original fill, stroke and color property values
-        // we should be able to do w/o a copy.
         fillStyle = graphic->fillStyle;
         strokeStyle = graphic->strokeStyle;
         ApplyCSSStyle(graphic->classNames, graphicStyle, fillStyle, strokeStyle);
-        // If we habe a CSS var() function we need to replace the placeholder with
-        // an actual color from our externally provided color map here.
-        Color color{{0.0f, 0.0f, 0.0f, 1.0f}};
-        ResolveColorImpl(colorMap, fillStyle.color, color);
-        ResolvePaintImpl(colorMap, fillStyle.internalPaint, color, fillStyle.paint);
-        ResolvePaintImpl(colorMap, strokeStyle.internalPaint, color, strokeStyle.paint);
-        mRenderer->DrawPath(*(graphic->path.get()), graphicStyle, fillStyle, strokeStyle);
+        ResolveStyles(colorMap, fillStyle, strokeStyle);
+        target.renderer.DrawPath(TargetPath(target, *graphic), TargetStyle(target, graphicStyle, storage), fillStyle, strokeStyle);
         break;
     }
     case ElementType::kImage:
     {
         const auto image = static_cast<const Image*>(element);
         ApplyCSSStyle(image->classNames, graphicStyle, fillStyle, strokeStyle);
-        mRenderer->DrawImage(*(image->imageData.get()), graphicStyle, image->clipArea, image->fillArea);
-        break;
-    }
-    case ElementType::kGroup:
-    {
-        const auto group = static_cast<const Group*>(element);
-        ApplyCSSStyle(group->classNames, graphicStyle, fillStyle, strokeStyle);
-        mRenderer->Save(group->graphicStyle);
-        for (const auto& child : group->children)
-            TraverseTree(colorMap, child.get());
-        mRenderer->Restore();
+        // Images of the document renderer do not change after parsing.
+        const ImageData* imageData = &target.renderer == mRenderer.get() ? image->imageData : nullptr;
+        std::unique_ptr<ImageData> targetImageData;
+        if (!imageData && target.imageCache)
+            imageData = target.imageCache->Get(target.renderer, image->base64, image->encoding);
+        else if (!imageData)
+        {
+            targetImageData = target.renderer.CreateImageData(image->base64.to_string(), image->encoding);
+            imageData = targetImageData.get();
+        }
+        if (imageData)
+            target.renderer.DrawImage(*imageData, TargetStyle(target, graphicStyle, storage), image->clipArea, image->fillArea);
         break;
     }
     default:
-        SVG_ASSERT_MSG(false, "Unknown element type");
+        SVG_ASSERT_MSG(false, "Not a drawable element type");
+    }
+}
+
+const ImageData* SVGImageCacheImpl::Get(SVGRenderer& renderer, boost::string_view base64, ImageEncoding encoding)
+{
+    auto hash = boost::hash_range(base64.begin(), base64.end());
+    auto range = mImages.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second.encoding == encoding && it->second.base64 == base64)
+            return it->second.imageData.get();
     }
+    // Images that fail to decode get cached as well.
+    auto source = base64.to_string();
+    auto imageData = renderer.CreateImageData(source, encoding);
+    return mImages.emplace(hash, Entry{std::move(source), encoding, std::move(imageData)})->second.imageData.get();
 }
 
 #ifndef STYLE_SUPPORT
 // Deprecated style support
 void SVGDocumentImpl::ApplyCSSStyle(
-    const std::set<std::string>&, GraphicStyleImpl&, FillStyleImpl&, StrokeStyleImpl&) {}
-void SVGDocumentImpl::ParseStyleAttr(XMLNode*, std::vector<PropertySet>&, std::set<std::string>&) {}
+    const ClassNames&, GraphicStyleImpl&, FillStyleImpl&, StrokeStyleImpl&) const {}
+void SVGDocumentImpl::ParseStyleAttr(
+    const SVGAttributeSet&, GraphicStyleImpl&, FillStyleImpl&, StrokeStyleImpl&, std::set<std::string>&) {}
 void SVGDocumentImpl::ParseStyle(XMLNode*) {}
 #endif
 
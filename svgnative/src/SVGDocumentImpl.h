@@ -12,27 +12,33 @@ governing permissions and limitations under the License.
 
 #pragma once
 
+#include "SVGArena.h"
+#include "SVGAttributes.h"
+#include "SVGDocument.h"
+#include "SVGElements.h"
+#include "SVGPathData.h"
 #include "SVGRenderer.h"
+#include "SVGResourceIndex.h"
+#include "XMLTree.h"
 #ifdef STYLE_SUPPORT
 #include "StyleSheet/Document.h"
 #include "StyleSheet/Parser.h"
 #endif
 
 #include <array>
-#include <boost/property_tree/detail/xml_parser_read_rapidxml.hpp>
+#include <cstdint>
 #include <map>
 #include <set>
 #include <stack>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace SVGNative
 {
-using XMLNode = boost::property_tree::detail::rapidxml::xml_node<>;
-using XMLDocument = boost::property_tree::detail::rapidxml::xml_document<>;
-
 struct GradientImpl;
+class SVGImageCacheImpl;
 
 // At this point we just support 'currentColor'
 enum class ColorKeys
@@ -44,11 +50,8 @@ using Variable = std::pair<std::string, Color>;
 using ColorImpl = boost::variant<Color, Variable, ColorKeys>;
 using PaintImpl = boost::variant<Color, GradientImpl, Variable, ColorKeys>;
 using ColorStopImpl = std::tuple<float, ColorImpl, float>;
-#ifdef STYLE_SUPPORT
-using PropertySet = StyleSheet::CssPropertySet;
-#else
-using PropertySet = std::map<std::string, std::string>;
-#endif
+// Presentation attributes or properties of a CSS declaration block.
+using PropertySet = SVGAttributeSet;
 
 struct GradientImpl : public Gradient
 {
@@ -70,14 +73,65 @@ struct StrokeStyleImpl : public StrokeStyle
     PaintImpl internalPaint = Color{{0.0f, 0.0f, 0.0f, 1.0f}};
 };
 
+// Renderer independent clipping path, allocated in the arena of the document.
+// The ClippingPath of a renderer gets created from it at draw time.
+struct ClippingPathImpl
+{
+    ClippingPathImpl() = default;
+    ClippingPathImpl(bool aHasClipContent, WindingRule aClipRule, const SVGPathData* aPath, boost::optional<AffineTransform> aTransform)
+        : hasClipContent{aHasClipContent}
+        , clipRule{aClipRule}
+        , path{aPath}
+        , transform{aTransform}
+    {
+    }
+
+    bool hasClipContent{};
+    WindingRule clipRule{WindingRule::kNonZero};
+    // nullptr if there is no clip content.
+    const SVGPathData* path{};
+    boost::optional<AffineTransform> transform;
+};
+
 struct GraphicStyleImpl : public GraphicStyle
 {
+    // Replaces GraphicStyle::clippingPath, which stays empty in the document.
+    const ClippingPathImpl* internalClippingPath{};
+
     // Other non-inherited properties
     bool display{true};
     float stopOpacity{1.0f};
     ColorImpl stopColor = Color{{0.0f, 0.0f, 0.0f, 1.0f}};
 };
 
+/**
+ * Class names of an element, copied to the arena of the document. Only
+ * documents with CSS style support have any.
+ */
+struct ClassNames
+{
+    const boost::string_view* begin() const { return names; }
+    const boost::string_view* end() const { return names + count; }
+    size_t size() const { return count; }
+
+    const boost::string_view* names{};
+    size_t count{};
+};
+
+/**
+ * Geometry of a shape with all lengths resolved. Documents with lazy geometry
+ * keep it and create paths from it on first use only.
+ */
+struct ShapeGeometry
+{
+    SVGElement element{SVGElement::kUnknown};
+    // rect: x, y, width, height, rx, ry. ellipse and circle: cx, cy, rx, ry.
+    // line: x1, y1, x2, y2.
+    std::array<float, 6> values{};
+    // Value of the points or d attribute. References the document source.
+    boost::string_view data;
+};
+
 class SVGDocumentImpl
 {
 public:
@@ -85,74 +139,227 @@ public:
     {
         kImage,
         kGraphic,
-        kGroup
+        kGroup,
+        kInstance
     };
 
+    // Elements, their paths and images are allocated in the arena of the
+    // document and do not own each other. The arena destroys them with the
+    // destructor of their concrete type. Elements do not depend on a renderer.
+    // Paths and images of the document renderer get added on first use.
     struct Element
     {
-        Element(GraphicStyleImpl& aGraphicStyle, std::set<std::string>& aClasses)
-            : graphicStyle{aGraphicStyle}
+        Element(ElementType aType, GraphicStyleImpl& aGraphicStyle, const ClassNames& aClasses)
+            : type{aType}
+            , graphicStyle{aGraphicStyle}
             , classNames{aClasses}
         {
         }
 
-        virtual ~Element() = default;
-
+        ElementType type;
+        // Set for graphics whose paints do not depend on the color map and
+        // got resolved in place by ResolveStaticStyle().
+        bool resolvedStyle{};
         GraphicStyleImpl graphicStyle;
-        std::set<std::string> classNames;
-        virtual ElementType Type() const = 0;
+        ClassNames classNames;
+        Element* nextSibling{};
     };
 
     struct Image : public Element
     {
-        Image(GraphicStyleImpl& aGraphicStyle, std::set<std::string>& aClasses, std::unique_ptr<ImageData> aImageData,
-            const Rect& aClipArea, const Rect& aFillArea)
-            : Element(aGraphicStyle, aClasses)
-            , imageData{std::move(aImageData)}
+        Image(GraphicStyleImpl& aGraphicStyle, const ClassNames& aClasses, boost::string_view aBase64, ImageEncoding aEncoding,
+            ImageData* aImageData, const Rect& aClipArea, const Rect& aFillArea)
+            : Element(ElementType::kImage, aGraphicStyle, aClasses)
+            , base64{aBase64}
+            , encoding{aEncoding}
+            , imageData{aImageData}
             , clipArea{aClipArea}
             , fillArea{aFillArea}
         {
         }
 
-        std::unique_ptr<ImageData> imageData;
+        // Encoded image in the arena. Other renderers than the document
+        // renderer decode it for drawing.
+        boost::string_view base64;
+        ImageEncoding encoding;
+        // Decoded by the document renderer. nullptr if the document has none.
+        ImageData* imageData;
         Rect clipArea;
         Rect fillArea;
-        ElementType Type() const override { return ElementType::kImage; }
     };
 
     struct Group : public Element
     {
-        Group(GraphicStyleImpl& aGraphicStyle, std::set<std::string>& aClasses)
-            : Element(aGraphicStyle, aClasses)
+        Group(GraphicStyleImpl& aGraphicStyle, const ClassNames& aClasses)
+            : Element(ElementType::kGroup, aGraphicStyle, aClasses)
+        {
+        }
+
+        // Appends the siblings first to last.
+        void AppendChildren(Element* first, Element* last)
+        {
+            if (lastChild)
+                lastChild->nextSibling = first;
+            else
+                firstChild = first;
+            lastChild = last;
+        }
+        void AppendChild(Element* child) { AppendChildren(child, child); }
+
+        Element* firstChild{};
+        Element* lastChild{};
+    };
+
+    // Content of a <use> element. The content may be shared with other <use>
+    // elements that reference the same element with the same inherited style.
+    struct Instance : public Element
+    {
+        Instance(GraphicStyleImpl& aGraphicStyle, const ClassNames& aClasses, const Group* aContent)
+            : Element(ElementType::kInstance, aGraphicStyle, aClasses)
+            , content{aContent}
         {
         }
 
-        std::vector<std::unique_ptr<Element>> children;
-        ElementType Type() const override { return ElementType::kGroup; }
+        const Group* content;
     };
 
     struct Graphic : public Element
     {
-        Graphic(GraphicStyleImpl& aGraphicStyle, std::set<std::string>& aClasses, FillStyleImpl& aFillStyle, StrokeStyleImpl& aStrokeStyle,
-            std::unique_ptr<Path> aPath)
-            : Element(aGraphicStyle, aClasses)
+        Graphic(GraphicStyleImpl& aGraphicStyle, const ClassNames& aClasses, FillStyleImpl& aFillStyle, StrokeStyleImpl& aStrokeStyle,
+            const SVGPathData* aPathData)
+            : Element(ElementType::kGraphic, aGraphicStyle, aClasses)
+            , fillStyle{aFillStyle}
+            , strokeStyle{aStrokeStyle}
+            , pathData{aPathData}
+        {
+        }
+
+        Graphic(GraphicStyleImpl& aGraphicStyle, const ClassNames& aClasses, FillStyleImpl& aFillStyle, StrokeStyleImpl& aStrokeStyle,
+            const ShapeGeometry& aGeometry)
+            : Element(ElementType::kGraphic, aGraphicStyle, aClasses)
             , fillStyle{aFillStyle}
             , strokeStyle{aStrokeStyle}
-            , path{std::move(aPath)}
+            , geometry{aGeometry}
         {
         }
 
         FillStyleImpl fillStyle;
         StrokeStyleImpl strokeStyle;
-        std::unique_ptr<Path> path;
+        // nullptr if the document has lazy geometry. Paths get created from
+        // geometry then.
+        const SVGPathData* pathData{};
+        ShapeGeometry geometry;
+        // Path of the document renderer. Created on first use by Render()
+        // without renderer argument.
+        mutable Path* path{};
+    };
 
-        ElementType Type() const override { return ElementType::kGraphic; }
+    /**
+     * Node of the flattened render tree. Nodes are stored in pre-order, so the
+     * descendants of a group directly follow it. The content of <use>
+     * elements is stored once per shared content group, after the document
+     * tree. Nodes hold everything the traversal reads. Styles and paths stay
+     * with the element and are only read for nodes that get drawn.
+     */
+    struct RenderNode
+    {
+        ElementType type;
+        // The element and its descendants do not get drawn because an
+        // applied clipPath has no content.
+        bool culled;
+        // The styles of the element get drawn without copies.
+        bool resolvedStyle;
+        // Index of the next sibling.
+        std::uint32_t next;
+        // Children of groups and content of instances.
+        std::uint32_t childBegin;
+        std::uint32_t childEnd;
+        const Element* element;
     };
 
-    SVGDocumentImpl(std::shared_ptr<SVGRenderer> renderer);
-    ~SVGDocumentImpl() {}
+    /**
+     * Scratch state that is only needed while parsing. Documents parsed with an
+     * SVGParserContext borrow it from the context and leave its capacity to
+     * the next document.
+     */
+    struct ParseState;
+
+    // Creates its own parse state if parseState is nullptr.
+    SVGDocumentImpl(std::shared_ptr<SVGRenderer> renderer, ParseState* parseState = nullptr);
+    ~SVGDocumentImpl();
+
+    void TraverseSVGTree(XMLNode* rootNode);
+
+    /**
+     * Like TraverseSVGTree() but parses the children of the root element on up
+     * to threadCount threads. All resources get parsed in a pre-pass first, so
+     * references resolve independently of definition order. Each thread has
+     * its own style stacks and the subtrees get spliced back in document order.
+     * Falls back to TraverseSVGTree() if there is nothing to parallelize.
+     */
+    void TraverseSVGTreeParallel(XMLNode* rootNode, unsigned threadCount);
+
+    /**
+     * Element handlers shared by TraverseSVGTree() and the incremental
+     * SVGDocumentBuilder. Container elements get opened and closed around
+     * their children. All other elements get parsed as complete subtrees.
+     */
+    enum class ContainerType
+    {
+        kNone,
+        kGroup,
+        kDefs,
+        kSymbol
+    };
 
-    void TraverseSVGTree();
+    bool ParseSVGRoot(XMLNode* rootNode);
+    // Applies viewBox or x, y, width and height of the root element. Does not allocate.
+    static void ParseViewBox(const SVGAttributeSet& attributes, std::array<float, 4>& viewBox);
+    ContainerType OpenContainer(XMLNode* node);
+    void CloseContainer(ContainerType containerType);
+    void ParseChild(XMLNode* node);
+    void ParseResource(XMLNode* node);
+    void ClearResources();
+    // Ends parsing. Flattens the element tree for rendering. The parse state
+    // gets released or handed back to the context.
+    void FinishParsing();
+
+    /**
+     * Budgets are checked while parsing. Once one is exceeded, LimitError()
+     * is set and all further elements get skipped.
+     */
+    void SetLimits(const ParseLimits& limits) { mLimits = limits; }
+    ParseErrorCode LimitError() const { return mLimitError; }
+
+    /**
+     * The incremental SVGDocumentBuilder parses elements before the rest of
+     * the document is known. Elements that reference a gradient, clipping
+     * path or <use> target which did not arrive yet get rewound to a
+     * checkpoint taken before them and deferred. ParseDeferredElements()
+     * parses them again at their original position once all definitions
+     * are known, so references resolve independently of definition order.
+     */
+    struct Checkpoint
+    {
+        Group* group;
+        Element* lastChild;
+        std::array<float, 4> viewBox;
+        size_t depth;
+        size_t useExpansions;
+        size_t pathSegments;
+        size_t unresolvedReferences;
+    };
+    Checkpoint CreateCheckpoint() const;
+    bool HasUnresolvedReferencesSince(const Checkpoint& checkpoint) const
+    {
+        return mUnresolvedReferences != checkpoint.unresolvedReferences;
+    }
+    // Removes all elements added since checkpoint and restores the budgets.
+    void Rewind(const Checkpoint& checkpoint);
+    // Rewinds to checkpoint and keeps node for ParseDeferredElements(). The
+    // node must stay valid until then.
+    void DeferElement(const Checkpoint& checkpoint, XMLNode* node, bool isResource);
+    void ParseDeferredElements();
 
     enum class Result
     {
@@ -172,71 +379,226 @@ public:
     void AddCustomCSS(const StyleSheet::CssDocument* cssDocument);
     void ClearCustomCSS();
 #endif
+    // Renders to the document renderer, if there is one. Keeps the renderer
+    // objects it creates for later calls.
     void Render(const ColorMap& colorMap, float width, float height);
+    // Does not modify the document and may be called from several threads at
+    // once, also while Render() without renderer argument runs.
+    // Images get taken from imageCache if passed, otherwise decoded per call.
+    void Render(SVGRenderer& renderer, const ColorMap& colorMap, float width, float height,
+        SVGImageCacheImpl* imageCache = nullptr) const;
+
+    // Resolves the paints of a new graphic in place unless they depend on the
+    // color map. Called wherever graphics get created.
+    static void ResolveStaticStyle(Graphic& graphic);
+    // Copies the class names collected while parsing an element to arena.
+    static ClassNames CopyClassNames(SVGArena& arena, const std::set<std::string>& classNames);
 
-    XMLDocument mXMLDocument;
     std::array<float, 4> mViewBox;
     std::shared_ptr<SVGRenderer> mRenderer;
 
+    // Lazy geometry: shapes reference mSource and get their Path on first use.
+    bool mLazyGeometry{false};
+    std::vector<char> mSource;
+
 private:
-    bool HasAttr(XMLNode* node, const char* attrName);
-    float ParseLengthFromAttr(XMLNode* child, const char* attrName, LengthType lengthType = LengthType::kHorrizontal, float fallback = 0);
+    friend class SVGDocumentSerializer;
+
+    float ParseLengthFromAttr(
+        const SVGAttributeSet& attributes, SVGAttribute attribute, LengthType lengthType = LengthType::kHorrizontal, float fallback = 0);
     float RelativeLength(LengthType lengthType) const;
 
     float ParseColorStop(XMLNode* node, std::vector<SVGNative::ColorStopImpl>& colorStops, float lastOffset);
     void ParseColorStops(XMLNode* node, SVGNative::GradientImpl& gradient);
-    void ParseGradient(XMLNode* gradient);
+    void ParseGradient(XMLNode* gradient, SVGElement element);
 
     void ParseResources(XMLNode* node);
-    void ParseResource(XMLNode* node);
-
     void ParseChildren(XMLNode* node);
-    void ParseChild(XMLNode* node);
-
-    std::unique_ptr<Path> ParseShape(XMLNode* node);
-
-    GraphicStyleImpl ParseGraphic(XMLNode* node, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle, std::set<std::string>& classNames);
+    // Parses the resources below node, which is nested depth levels deep.
+    // Returns false if the document has to be parsed serially.
+    bool ParseResourcesAhead(XMLNode* node, size_t depth);
+
+    struct Resource;
+    void IndexResources(XMLNode* rootNode);
+    Resource& AddResource(boost::string_view id);
+    const GradientImpl* FindGradient(boost::string_view id);
+    const ClippingPathImpl* FindClippingPath(boost::string_view id);
+    XMLNode* FindUseTarget(boost::string_view id);
+    XMLNode* TakeDefinition(std::uint32_t index, SVGElement element, SVGElement alternativeElement);
+    const Group* InstantiateUseTarget(XMLNode* useTarget, const FillStyleImpl& fillStyle, const StrokeStyleImpl& strokeStyle);
+
+    ContainerType OpenContainer(SVGElement element, const SVGAttributeSet& attributes);
+    void ParseResource(XMLNode* node, SVGElement element, const SVGAttributeSet& attributes);
+
+    const SVGPathData* ParseShape(SVGElement element, const SVGAttributeSet& attributes);
+    bool ParseShapeGeometry(SVGElement element, const SVGAttributeSet& attributes, ShapeGeometry& geometry);
+    // Records the path in the arena of the document.
+    const SVGPathData* RecordShapePath(const ShapeGeometry& geometry, size_t* segmentCount);
+    void AddShapeToPath(const ShapeGeometry& geometry, Path& path, size_t* segmentCount) const;
+
+    bool EnterLevel();
+    void LeaveLevel() { --mDepth; }
+    bool AddPathSegments(size_t count);
+    bool AddUseExpansions(size_t count);
+    void SetLimitError(ParseErrorCode code);
+
+    GraphicStyleImpl ParseGraphic(
+        const SVGAttributeSet& attributes, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle, std::set<std::string>& classNames);
     void ParseFillProperties(FillStyleImpl& fillStyle, const PropertySet& propertySet);
     void ParseStrokeProperties(StrokeStyleImpl& strokeStyle, const PropertySet& propertySet);
     void ParseGraphicsProperties(GraphicStyleImpl& graphicsStyle, const PropertySet& propertySet);
 
-    PropertySet ParsePresentationAttributes(XMLNode* node);
-
-    void TraverseTree(const ColorMap& colorMap, const Element*);
-
-    void ApplyCSSStyle(
-        const std::set<std::string>& classNames, GraphicStyleImpl& graphicStyle, FillStyleImpl& fillStyle, StrokeStyleImpl& strokeStyle);
-    void ParseStyleAttr(XMLNode* node, std::vector<PropertySet>& propertySets, std::set<std::string>& classNames);
+    void FlattenTree();
+    void AppendRenderNode(Element* element, std::vector<std::uint32_t>& instances);
+    void AppendRenderNodes(const Group* group, std::vector<std::uint32_t>& instances);
+
+    struct RenderTarget;
+    void Render(RenderTarget& target, const ColorMap& colorMap, float width, float height) const;
+    // The style with the clipping path of the renderer of target.
+    const GraphicStyle& TargetStyle(RenderTarget& target, const GraphicStyleImpl& graphicStyle, GraphicStyle& storage) const;
+    const Path& TargetPath(RenderTarget& target, const Graphic& graphic) const;
+    void DrawElement(RenderTarget& target, const ColorMap& colorMap, const RenderNode& node) const;
+
+    void ApplyCSSStyle(const ClassNames& classNames, GraphicStyleImpl& graphicStyle, FillStyleImpl& fillStyle,
+        StrokeStyleImpl& strokeStyle) const;
+    void ParseStyleAttr(const SVGAttributeSet& attributes, GraphicStyleImpl& graphicStyle, FillStyleImpl& fillStyle,
+        StrokeStyleImpl& strokeStyle, std::set<std::string>& classNames);
     void ParseStyle(XMLNode* child);
 
-    void AddChildToCurrentGroup(std::unique_ptr<Element> element);
+    void AddChildToCurrentGroup(Element* element);
 
 private:
-    // All stroke and fill CSS properties are so called
-    // inherited CSS properties. Ancestors can define the
-    // stroke properties for desandents. Decendants override
-    // specifies from ancestors.
-    // We need to keep the stack of settings in based on DOM
-    // hiearchy.
-    std::stack<StrokeStyleImpl> mStrokeStyleStack;
-    std::stack<FillStyleImpl> mFillStyleStack;
-
 #ifdef STYLE_SUPPORT
     const StyleSheet::CssDocument* mOverrideStyle{};
     StyleSheet::CssDocument mCSSInfo;
     StyleSheet::CssDocument mCustomCSSInfo;
 #endif
 
-    std::map<std::string, GradientImpl> mGradients;
-    std::map<std::string, XMLNode*> mResourceIDs;
-    std::map<std::string, std::shared_ptr<ClippingPath>> mClippingPaths;
+    // Resources by the index of their ID in ParseState::resourceIndex. Gradients,
+    // clipping paths and <use> targets have separate slots, IDs are not
+    // necessarily unique.
+    struct Resource
+    {
+        // First element with the ID. Known ahead of parsing it if the whole
+        // XML tree is available. Allows references before the definition.
+        XMLNode* definition{};
+        XMLNode* useTarget{};
+        std::shared_ptr<const GradientImpl> gradient;
+        const ClippingPathImpl* clippingPath{};
+    };
+
+    // Parsed content of <use> targets for reuse by <use> elements with the
+    // same inherited style.
+    struct UseInstance
+    {
+        std::array<float, 4> viewBox;
+        FillStyleImpl fillStyle;
+        StrokeStyleImpl strokeStyle;
+        const Group* content;
+        // <use> expansions within content.
+        size_t useExpansions;
+    };
+
+    // Element deferred by DeferElement() with the state to parse it in.
+    // Children get parsed into placeholder, which gets replaced by its
+    // children afterwards. Resources have no placeholder.
+    struct DeferredElement
+    {
+        XMLNode* node;
+        Group* placeholder;
+        Group* parent;
+        FillStyleImpl fillStyle;
+        StrokeStyleImpl strokeStyle;
+        std::array<float, 4> viewBox;
+        size_t depth;
+    };
 
-    std::stack<Group*> mGroupStack;
-    std::unique_ptr<Group> mGroup;
+    std::unique_ptr<ParseState> mOwnedParseState;
+    // nullptr once parsing ended.
+    ParseState* mState{};
+
+    ParseLimits mLimits;
+    ParseErrorCode mLimitError{ParseErrorCode::kNone};
+    size_t mDepth{};
+    size_t mUseExpansions{};
+    size_t mPathSegments{};
+    // References to gradients, clipping paths and <use> targets that did not resolve.
+    size_t mUnresolvedReferences{};
+
+    // Owns all elements. Declared after mRenderer, paths and images get
+    // destroyed while the renderer is still alive.
+    SVGArena mArena;
+    Group* mGroup{};
+    // Built from mGroup once parsing ended. The root group is the first node.
+    std::vector<RenderNode> mRenderNodes;
+    // Clipping paths of the document renderer by the renderer independent
+    // clipping path. Created on first use by Render() without renderer argument.
+    std::unordered_map<const ClippingPathImpl*, std::shared_ptr<ClippingPath>> mRendererClippingPaths;
 
 #if DEBUG
     std::string mTitle;
 #endif
 };
 
+struct SVGDocumentImpl::ParseState
+{
+    // Clears all state but keeps the capacity.
+    void Reset();
+
+    // All stroke and fill CSS properties are so called
+    // inherited CSS properties. Ancestors can define the
+    // stroke properties for desandents. Decendants override
+    // specifies from ancestors.
+    // We need to keep the stack of settings in based on DOM
+    // hiearchy.
+    std::stack<StrokeStyleImpl, std::vector<StrokeStyleImpl>> strokeStyleStack;
+    std::stack<FillStyleImpl, std::vector<FillStyleImpl>> fillStyleStack;
+    std::stack<Group*, std::vector<Group*>> groupStack;
+
+    SVGResourceIndex resourceIndex;
+    std::vector<Resource> resources;
+    std::unordered_map<XMLNode*, std::vector<UseInstance>> useInstances;
+    // Targets of the <use> elements currently being expanded.
+    std::vector<XMLNode*> useTargetStack;
+    // Elements of SVGDocumentBuilder waiting for definitions, in document order.
+    std::vector<DeferredElement> deferredElements;
+
+    // Points of the polygon or polyline being parsed.
+    std::vector<float> numberList;
+    // Segments of the shape being parsed.
+    SVGPathRecorder pathRecorder;
+};
+
+/**
+ * Images of an SVGImageCache by their base64 source.
+ */
+class SVGImageCacheImpl
+{
+public:
+    // Decodes the image with renderer on first use. nullptr if the image
+    // could not be decoded.
+    const ImageData* Get(SVGRenderer& renderer, boost::string_view base64, ImageEncoding encoding);
+    void Clear() { mImages.clear(); }
+
+private:
+    struct Entry
+    {
+        std::string base64;
+        ImageEncoding encoding;
+        std::unique_ptr<ImageData> imageData;
+    };
+
+    // Sources with the same hash share a bucket.
+    std::unordered_multimap<size_t, Entry> mImages;
+};
+
+/**
+ * Memory that an SVGParserContext keeps between documents.
+ */
+struct SVGParserContextImpl
+{
+    XMLDocument xmlDocument;
+    SVGDocumentImpl::ParseState parseState;
+};
+
 } // namespace SVGNative
@@ -0,0 +1,863 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGDocumentSerializer.h"
+#include "SVGDocumentImpl.h"
+
+#include <cstring>
+#include <map>
+
+namespace SVGNative
+{
+constexpr std::uint32_t SVGDocumentSerializer::kVersion;
+
+namespace
+{
+constexpr char kMagic[4] = {'S', 'V', 'G', 'B'};
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::uint32_t kNoIndex = 0xFFFFFFFF;
+// Nesting limit for groups to keep the stack bounded on corrupted data.
+constexpr size_t kMaxGroupDepth = 1024;
+
+enum class PaintType : std::uint8_t
+{
+    kColor,
+    kGradient,
+    kVariable,
+    kColorKey
+};
+
+class BinaryWriter
+{
+public:
+    void Write(const void* data, size_t size) { mBuffer.append(static_cast<const char*>(data), size); }
+    void WriteUInt8(std::uint8_t value) { Write(&value, sizeof(value)); }
+    void WriteUInt32(std::uint32_t value) { Write(&value, sizeof(value)); }
+    void WriteFloat(float value) { Write(&value, sizeof(value)); }
+    void WriteFloats(const float* values, size_t count) { Write(values, count * sizeof(float)); }
+    void WriteBool(bool value) { WriteUInt8(value ? 1 : 0); }
+
+    std::string& Buffer() { return mBuffer; }
+
+private:
+    std::string mBuffer;
+};
+
+// Stores identical records only once and returns the index of the record.
+class InternTable
+{
+public:
+    std::uint32_t Intern(std::string&& record)
+    {
+        auto result = mIndices.insert({std::move(record), static_cast<std::uint32_t>(mRecords.size())});
+        if (result.second)
+            mRecords.push_back(&result.first->first);
+        return result.first->second;
+    }
+
+    void WriteTo(BinaryWriter& writer) const
+    {
+        writer.WriteUInt32(static_cast<std::uint32_t>(mRecords.size()));
+        for (const auto record : mRecords)
+            writer.Write(record->data(), record->size());
+    }
+
+private:
+    std::map<std::string, std::uint32_t> mIndices;
+    std::vector<const std::string*> mRecords;
+};
+
+class DocumentWriter
+{
+public:
+    void Write(const std::array<float, 4>& viewBox, const SVGDocumentImpl::Group& root, std::vector<char>& binary)
+    {
+        BinaryWriter tree;
+        WriteElement(tree, root);
+
+        BinaryWriter writer;
+        writer.Write(kMagic, sizeof(kMagic));
+        writer.WriteUInt32(SVGDocumentSerializer::kVersion);
+        writer.WriteUInt32(kByteOrderMark);
+        writer.WriteFloats(viewBox.data(), viewBox.size());
+        // Tables only reference tables written before them.
+        mStrings.WriteTo(writer);
+        mPaths.WriteTo(writer);
+        mTransforms.WriteTo(writer);
+        mGradients.WriteTo(writer);
+        mClippingPaths.WriteTo(writer);
+        mFillStyles.WriteTo(writer);
+        mStrokeStyles.WriteTo(writer);
+        mGraphicStyles.WriteTo(writer);
+        mImages.WriteTo(writer);
+        writer.Write(tree.Buffer().data(), tree.Buffer().size());
+
+        binary.assign(writer.Buffer().begin(), writer.Buffer().end());
+    }
+
+private:
+    std::uint32_t InternString(boost::string_view string)
+    {
+        BinaryWriter writer;
+        writer.WriteUInt32(static_cast<std::uint32_t>(string.size()));
+        writer.Write(string.data(), string.size());
+        return mStrings.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternPath(const SVGPathData* pathData)
+    {
+        if (!pathData)
+            return kNoIndex;
+        BinaryWriter writer;
+        writer.WriteUInt32(static_cast<std::uint32_t>(pathData->VerbCount()));
+        writer.WriteUInt32(static_cast<std::uint32_t>(pathData->PointCount()));
+        writer.Write(pathData->Verbs(), pathData->VerbCount());
+        writer.WriteFloats(pathData->Points(), pathData->PointCount());
+        return mPaths.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternTransform(const boost::optional<AffineTransform>& transform)
+    {
+        if (!transform)
+            return kNoIndex;
+        const auto& matrix = *transform;
+        BinaryWriter writer;
+        for (float value : {matrix.a, matrix.b, matrix.c, matrix.d, matrix.e, matrix.f})
+            writer.WriteFloat(value);
+        return mTransforms.Intern(std::move(writer.Buffer()));
+    }
+
+    void WriteColor(BinaryWriter& writer, const Color& color) { writer.WriteFloats(color.data(), color.size()); }
+
+    void WriteVariable(BinaryWriter& writer, const Variable& variable)
+    {
+        writer.WriteUInt32(InternString(variable.first));
+        WriteColor(writer, variable.second);
+    }
+
+    void WriteColorImpl(BinaryWriter& writer, const ColorImpl& color)
+    {
+        if (color.type() == typeid(Variable))
+        {
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kVariable));
+            WriteVariable(writer, boost::get<Variable>(color));
+        }
+        else if (color.type() == typeid(ColorKeys))
+        {
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kColorKey));
+            writer.WriteUInt8(static_cast<std::uint8_t>(boost::get<ColorKeys>(color)));
+        }
+        else
+        {
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kColor));
+            WriteColor(writer, boost::get<Color>(color));
+        }
+    }
+
+    void WritePaintImpl(BinaryWriter& writer, const PaintImpl& paint)
+    {
+        if (paint.type() == typeid(GradientImpl))
+        {
+            auto index = InternGradient(boost::get<GradientImpl>(paint));
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kGradient));
+            writer.WriteUInt32(index);
+        }
+        else if (paint.type() == typeid(Variable))
+        {
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kVariable));
+            WriteVariable(writer, boost::get<Variable>(paint));
+        }
+        else if (paint.type() == typeid(ColorKeys))
+        {
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kColorKey));
+            writer.WriteUInt8(static_cast<std::uint8_t>(boost::get<ColorKeys>(paint)));
+        }
+        else
+        {
+            writer.WriteUInt8(static_cast<std::uint8_t>(PaintType::kColor));
+            WriteColor(writer, boost::get<Color>(paint));
+        }
+    }
+
+    std::uint32_t InternGradient(const GradientImpl& gradient)
+    {
+        BinaryWriter writer;
+        writer.WriteUInt8(static_cast<std::uint8_t>(gradient.type));
+        writer.WriteUInt8(static_cast<std::uint8_t>(gradient.method));
+        for (float value : {gradient.x1, gradient.y1, gradient.x2, gradient.y2, gradient.cx, gradient.cy, gradient.fx, gradient.fy, gradient.r})
+            writer.WriteFloat(value);
+        writer.WriteUInt32(InternTransform(gradient.transform));
+        writer.WriteUInt32(static_cast<std::uint32_t>(gradient.internalColorStops.size()));
+        for (const auto& colorStop : gradient.internalColorStops)
+        {
+            writer.WriteFloat(std::get<0>(colorStop));
+            WriteColorImpl(writer, std::get<1>(colorStop));
+            writer.WriteFloat(std::get<2>(colorStop));
+        }
+        return mGradients.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternClippingPath(const ClippingPathImpl* clippingPath)
+    {
+        if (!clippingPath)
+            return kNoIndex;
+        BinaryWriter writer;
+        writer.WriteBool(clippingPath->hasClipContent);
+        writer.WriteUInt8(static_cast<std::uint8_t>(clippingPath->clipRule));
+        writer.WriteUInt32(clippingPath->path ? InternPath(clippingPath->path) : kNoIndex);
+        writer.WriteUInt32(InternTransform(clippingPath->transform));
+        return mClippingPaths.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternFillStyle(const FillStyleImpl& fillStyle)
+    {
+        BinaryWriter writer;
+        writer.WriteBool(fillStyle.hasFill);
+        writer.WriteUInt8(static_cast<std::uint8_t>(fillStyle.fillRule));
+        writer.WriteFloat(fillStyle.fillOpacity);
+        WritePaintImpl(writer, fillStyle.internalPaint);
+        writer.WriteBool(fillStyle.visibility);
+        WriteColorImpl(writer, fillStyle.color);
+        writer.WriteUInt8(static_cast<std::uint8_t>(fillStyle.clipRule));
+        return mFillStyles.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternStrokeStyle(const StrokeStyleImpl& strokeStyle)
+    {
+        BinaryWriter writer;
+        writer.WriteBool(strokeStyle.hasStroke);
+        writer.WriteFloat(strokeStyle.strokeOpacity);
+        writer.WriteFloat(strokeStyle.lineWidth);
+        writer.WriteUInt8(static_cast<std::uint8_t>(strokeStyle.lineCap));
+        writer.WriteUInt8(static_cast<std::uint8_t>(strokeStyle.lineJoin));
+        writer.WriteFloat(strokeStyle.miterLimit);
+        writer.WriteUInt32(static_cast<std::uint32_t>(strokeStyle.dashArray.size()));
+        writer.WriteFloats(strokeStyle.dashArray.data(), strokeStyle.dashArray.size());
+        writer.WriteFloat(strokeStyle.dashOffset);
+        WritePaintImpl(writer, strokeStyle.internalPaint);
+        return mStrokeStyles.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternGraphicStyle(const GraphicStyleImpl& graphicStyle)
+    {
+        BinaryWriter writer;
+        writer.WriteFloat(graphicStyle.opacity);
+        writer.WriteUInt32(InternTransform(graphicStyle.transform));
+        writer.WriteUInt32(InternClippingPath(graphicStyle.internalClippingPath));
+        writer.WriteBool(graphicStyle.display);
+        writer.WriteFloat(graphicStyle.stopOpacity);
+        WriteColorImpl(writer, graphicStyle.stopColor);
+        return mGraphicStyles.Intern(std::move(writer.Buffer()));
+    }
+
+    std::uint32_t InternImage(const SVGDocumentImpl::Image& image)
+    {
+        BinaryWriter writer;
+        writer.WriteUInt8(static_cast<std::uint8_t>(image.encoding));
+        writer.WriteUInt32(InternString(image.base64));
+        return mImages.Intern(std::move(writer.Buffer()));
+    }
+
+    void WriteElement(BinaryWriter& writer, const SVGDocumentImpl::Element& element)
+    {
+        // Instances get expanded to groups.
+        auto type = element.type == SVGDocumentImpl::ElementType::kInstance ? SVGDocumentImpl::ElementType::kGroup : element.type;
+        writer.WriteUInt8(static_cast<std::uint8_t>(type));
+        writer.WriteUInt32(InternGraphicStyle(element.graphicStyle));
+        writer.WriteUInt32(static_cast<std::uint32_t>(element.classNames.size()));
+        for (const auto& className : element.classNames)
+            writer.WriteUInt32(InternString(className));
+
+        switch (element.type)
+        {
+        case SVGDocumentImpl::ElementType::kGraphic:
+        {
+            const auto& graphic = static_cast<const SVGDocumentImpl::Graphic&>(element);
+            writer.WriteUInt32(InternFillStyle(graphic.fillStyle));
+            writer.WriteUInt32(InternStrokeStyle(graphic.strokeStyle));
+            writer.WriteUInt32(InternPath(graphic.pathData));
+            break;
+        }
+        case SVGDocumentImpl::ElementType::kImage:
+        {
+            const auto& image = static_cast<const SVGDocumentImpl::Image&>(element);
+            writer.WriteUInt32(InternImage(image));
+            for (const auto& rect : {image.clipArea, image.fillArea})
+            {
+                for (float value : {rect.x, rect.y, rect.width, rect.height})
+                    writer.WriteFloat(value);
+            }
+            break;
+        }
+        case SVGDocumentImpl::ElementType::kGroup:
+            WriteChildren(writer, static_cast<const SVGDocumentImpl::Group&>(element));
+            break;
+        case SVGDocumentImpl::ElementType::kInstance:
+            WriteChildren(writer, *static_cast<const SVGDocumentImpl::Instance&>(element).content);
+            break;
+        default:
+            SVG_ASSERT_MSG(false, "Unknown element type");
+        }
+    }
+
+    void WriteChildren(BinaryWriter& writer, const SVGDocumentImpl::Group& group)
+    {
+        std::uint32_t childCount{};
+        for (auto child = group.firstChild; child != nullptr; child = child->nextSibling)
+            ++childCount;
+        writer.WriteUInt32(childCount);
+        for (auto child = group.firstChild; child != nullptr; child = child->nextSibling)
+            WriteElement(writer, *child);
+    }
+
+    InternTable mStrings;
+    InternTable mPaths;
+    InternTable mTransforms;
+    InternTable mGradients;
+    InternTable mClippingPaths;
+    InternTable mFillStyles;
+    InternTable mStrokeStyles;
+    InternTable mGraphicStyles;
+    InternTable mImages;
+};
+
+// Bounds-checked reads. Once a read fails, all following reads fail and return 0.
+class BinaryReader
+{
+public:
+    BinaryReader(const char* data, size_t size)
+        : mPos{data}
+        , mEnd{data + size}
+    {
+    }
+
+    bool Read(void* out, size_t size)
+    {
+        if (mFailed || static_cast<size_t>(mEnd - mPos) < size)
+        {
+            mFailed = true;
+            memset(out, 0, size);
+            return false;
+        }
+        memcpy(out, mPos, size);
+        mPos += size;
+        return true;
+    }
+
+    const char* ReadBytes(size_t size)
+    {
+        if (mFailed || static_cast<size_t>(mEnd - mPos) < size)
+        {
+            mFailed = true;
+            return nullptr;
+        }
+        auto bytes = mPos;
+        mPos += size;
+        return bytes;
+    }
+
+    std::uint8_t ReadUInt8()
+    {
+        std::uint8_t value{};
+        Read(&value, sizeof(value));
+        return value;
+    }
+
+    std::uint32_t ReadUInt32()
+    {
+        std::uint32_t value{};
+        Read(&value, sizeof(value));
+        return value;
+    }
+
+    float ReadFloat()
+    {
+        float value{};
+        Read(&value, sizeof(value));
+        return value;
+    }
+
+    bool ReadBool() { return ReadUInt8() != 0; }
+
+    // Reads the number of following items. Fails if the remaining data can not
+    // hold that many items of at least itemSize bytes each.
+    std::uint32_t ReadCount(size_t itemSize)
+    {
+        auto count = ReadUInt32();
+        if (!mFailed && count > static_cast<size_t>(mEnd - mPos) / itemSize)
+            mFailed = true;
+        return mFailed ? 0 : count;
+    }
+
+    template <typename Enum>
+    Enum ReadEnum(Enum last)
+    {
+        auto value = ReadUInt8();
+        if (value > static_cast<std::uint8_t>(last))
+            mFailed = true;
+        return mFailed ? Enum{} : static_cast<Enum>(value);
+    }
+
+    void Fail() { mFailed = true; }
+    bool Failed() const { return mFailed; }
+    bool AtEnd() const { return mPos == mEnd; }
+
+private:
+    const char* mPos{};
+    const char* mEnd{};
+    bool mFailed{};
+};
+
+class DocumentReader
+{
+public:
+    DocumentReader(const char* data, size_t size, std::shared_ptr<SVGRenderer> renderer, SVGArena& arena)
+        : mReader{data, size}
+        , mRenderer{renderer}
+        , mArena(arena)
+    {
+    }
+
+    bool Read(std::array<float, 4>& viewBox, SVGDocumentImpl::Group& root)
+    {
+        char magic[sizeof(kMagic)]{};
+        mReader.Read(magic, sizeof(magic));
+        if (memcmp(magic, kMagic, sizeof(kMagic)) != 0 || mReader.ReadUInt32() != SVGDocumentSerializer::kVersion
+            || mReader.ReadUInt32() != kByteOrderMark)
+            return false;
+        for (auto& value : viewBox)
+            value = mReader.ReadFloat();
+
+        ReadStrings();
+        ReadPaths();
+        ReadTransforms();
+        ReadGradients();
+        ReadClippingPaths();
+        ReadFillStyles();
+        ReadStrokeStyles();
+        ReadGraphicStyles();
+        ReadImages();
+        if (mReader.Failed())
+            return false;
+
+        // The root element is always a group.
+        if (mReader.ReadEnum(SVGDocumentImpl::ElementType::kGroup) != SVGDocumentImpl::ElementType::kGroup)
+            return false;
+        ReadElementStyle(root.graphicStyle, root.classNames);
+        ReadGroupChildren(root, 0);
+        return !mReader.Failed() && mReader.AtEnd();
+    }
+
+private:
+    // Checks index against the size of table. kNoIndex is only valid if optional.
+    bool IsValidIndex(std::uint32_t index, size_t tableSize, bool optional = false)
+    {
+        if (index < tableSize || (optional && index == kNoIndex))
+            return true;
+        mReader.Fail();
+        return false;
+    }
+
+    void ReadStrings()
+    {
+        auto count = mReader.ReadCount(sizeof(std::uint32_t));
+        mStrings.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            auto size = mReader.ReadUInt32();
+            if (auto bytes = mReader.ReadBytes(size))
+                mStrings.emplace_back(bytes, size);
+        }
+    }
+
+    void ReadPaths()
+    {
+        auto count = mReader.ReadCount(2 * sizeof(std::uint32_t));
+        mPaths.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            auto verbCount = mReader.ReadUInt32();
+            auto pointCount = mReader.ReadUInt32();
+            auto verbs = mReader.ReadBytes(verbCount);
+            auto points = mReader.ReadBytes(static_cast<size_t>(pointCount) * sizeof(float));
+            if (mReader.Failed())
+                return;
+            // Validate once so that replaying the path can not fail.
+            size_t expectedPointCount{};
+            for (std::uint32_t j = 0; j < verbCount; ++j)
+            {
+                if (static_cast<std::uint8_t>(verbs[j]) > static_cast<std::uint8_t>(PathVerb::kClosePath))
+                {
+                    mReader.Fail();
+                    return;
+                }
+                expectedPointCount += PathVerbPointCount(static_cast<PathVerb>(verbs[j]));
+            }
+            if (expectedPointCount != pointCount)
+            {
+                mReader.Fail();
+                return;
+            }
+            // Paths are shared by all graphics that reference them.
+            mPaths.push_back(
+                SVGPathData::Create(mArena, reinterpret_cast<const PathVerb*>(verbs), verbCount, points, pointCount));
+        }
+    }
+
+    void ReadTransforms()
+    {
+        auto count = mReader.ReadCount(6 * sizeof(float));
+        mTransforms.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            float m[6];
+            for (auto& value : m)
+                value = mReader.ReadFloat();
+            mTransforms.push_back({m[0], m[1], m[2], m[3], m[4], m[5]});
+        }
+    }
+
+    void ReadColor(Color& color)
+    {
+        for (auto& value : color)
+            value = mReader.ReadFloat();
+    }
+
+    bool ReadVariable(Variable& variable)
+    {
+        auto index = mReader.ReadUInt32();
+        if (!IsValidIndex(index, mStrings.size()))
+            return false;
+        variable.first = mStrings[index];
+        ReadColor(variable.second);
+        return true;
+    }
+
+    void ReadColorImpl(ColorImpl& color)
+    {
+        switch (mReader.ReadEnum(PaintType::kColorKey))
+        {
+        case PaintType::kColor:
+        {
+            Color value{};
+            ReadColor(value);
+            color = value;
+            break;
+        }
+        case PaintType::kVariable:
+        {
+            Variable variable;
+            if (ReadVariable(variable))
+                color = variable;
+            break;
+        }
+        case PaintType::kColorKey:
+            color = mReader.ReadEnum(ColorKeys::kCurrentColor);
+            break;
+        case PaintType::kGradient:
+        default:
+            mReader.Fail();
+            break;
+        }
+    }
+
+    void ReadPaintImpl(PaintImpl& paint)
+    {
+        switch (mReader.ReadEnum(PaintType::kColorKey))
+        {
+        case PaintType::kColor:
+        {
+            Color value{};
+            ReadColor(value);
+            paint = value;
+            break;
+        }
+        case PaintType::kGradient:
+        {
+            auto index = mReader.ReadUInt32();
+            if (IsValidIndex(index, mGradients.size()))
+                paint = mGradients[index];
+            break;
+        }
+        case PaintType::kVariable:
+        {
+            Variable variable;
+            if (ReadVariable(variable))
+                paint = variable;
+            break;
+        }
+        case PaintType::kColorKey:
+            paint = mReader.ReadEnum(ColorKeys::kCurrentColor);
+            break;
+        default:
+            mReader.Fail();
+            break;
+        }
+    }
+
+    boost::optional<AffineTransform> ReadTransformIndex()
+    {
+        auto index = mReader.ReadUInt32();
+        if (!IsValidIndex(index, mTransforms.size(), true) || index == kNoIndex)
+            return boost::none;
+        return mTransforms[index];
+    }
+
+    void ReadGradients()
+    {
+        auto count = mReader.ReadCount(2 + 9 * sizeof(float) + 2 * sizeof(std::uint32_t));
+        mGradients.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            GradientImpl gradient{};
+            gradient.type = mReader.ReadEnum(GradientType::kRadialGradient);
+            gradient.method = mReader.ReadEnum(SpreadMethod::kRepeat);
+            for (auto value : {&gradient.x1, &gradient.y1, &gradient.x2, &gradient.y2, &gradient.cx, &gradient.cy, &gradient.fx,
+                     &gradient.fy, &gradient.r})
+                *value = mReader.ReadFloat();
+            gradient.transform = ReadTransformIndex();
+            auto stopCount = mReader.ReadCount(2 * sizeof(float) + 1);
+            gradient.internalColorStops.reserve(stopCount);
+            for (std::uint32_t j = 0; j < stopCount && !mReader.Failed(); ++j)
+            {
+                float offset = mReader.ReadFloat();
+                ColorImpl color = Color{{0.0f, 0.0f, 0.0f, 1.0f}};
+                ReadColorImpl(color);
+                float opacity = mReader.ReadFloat();
+                gradient.internalColorStops.push_back(std::make_tuple(offset, color, opacity));
+            }
+            mGradients.push_back(std::move(gradient));
+        }
+    }
+
+    void ReadClippingPaths()
+    {
+        auto count = mReader.ReadCount(2 + 2 * sizeof(std::uint32_t));
+        mClippingPaths.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            bool hasClipContent = mReader.ReadBool();
+            auto clipRule = mReader.ReadEnum(WindingRule::kEvenOdd);
+            const SVGPathData* path{};
+            auto pathIndex = mReader.ReadUInt32();
+            if (IsValidIndex(pathIndex, mPaths.size(), true) && pathIndex != kNoIndex)
+                path = mPaths[pathIndex];
+            auto transform = ReadTransformIndex();
+            mClippingPaths.push_back(mArena.New<ClippingPathImpl>(hasClipContent, clipRule, path, transform));
+        }
+    }
+
+    void ReadFillStyles()
+    {
+        auto count = mReader.ReadCount(12);
+        mFillStyles.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            FillStyleImpl fillStyle{};
+            fillStyle.hasFill = mReader.ReadBool();
+            fillStyle.fillRule = mReader.ReadEnum(WindingRule::kEvenOdd);
+            fillStyle.fillOpacity = mReader.ReadFloat();
+            ReadPaintImpl(fillStyle.internalPaint);
+            fillStyle.visibility = mReader.ReadBool();
+            ReadColorImpl(fillStyle.color);
+            fillStyle.clipRule = mReader.ReadEnum(WindingRule::kEvenOdd);
+            mFillStyles.push_back(std::move(fillStyle));
+        }
+    }
+
+    void ReadStrokeStyles()
+    {
+        auto count = mReader.ReadCount(27);
+        mStrokeStyles.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            StrokeStyleImpl strokeStyle{};
+            strokeStyle.hasStroke = mReader.ReadBool();
+            strokeStyle.strokeOpacity = mReader.ReadFloat();
+            strokeStyle.lineWidth = mReader.ReadFloat();
+            strokeStyle.lineCap = mReader.ReadEnum(LineCap::kSquare);
+            strokeStyle.lineJoin = mReader.ReadEnum(LineJoin::kBevel);
+            strokeStyle.miterLimit = mReader.ReadFloat();
+            auto dashCount = mReader.ReadCount(sizeof(float));
+            strokeStyle.dashArray.resize(dashCount);
+            for (auto& dash : strokeStyle.dashArray)
+                dash = mReader.ReadFloat();
+            strokeStyle.dashOffset = mReader.ReadFloat();
+            ReadPaintImpl(strokeStyle.internalPaint);
+            mStrokeStyles.push_back(std::move(strokeStyle));
+        }
+    }
+
+    void ReadGraphicStyles()
+    {
+        auto count = mReader.ReadCount(2 * sizeof(float) + 2 * sizeof(std::uint32_t) + 2);
+        mGraphicStyles.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            GraphicStyleImpl graphicStyle{};
+            graphicStyle.opacity = mReader.ReadFloat();
+            graphicStyle.transform = ReadTransformIndex();
+            auto clipIndex = mReader.ReadUInt32();
+            if (IsValidIndex(clipIndex, mClippingPaths.size(), true) && clipIndex != kNoIndex)
+                graphicStyle.internalClippingPath = mClippingPaths[clipIndex];
+            graphicStyle.display = mReader.ReadBool();
+            graphicStyle.stopOpacity = mReader.ReadFloat();
+            ReadColorImpl(graphicStyle.stopColor);
+            mGraphicStyles.push_back(std::move(graphicStyle));
+        }
+    }
+
+    void ReadImages()
+    {
+        auto count = mReader.ReadCount(1 + sizeof(std::uint32_t));
+        mImages.reserve(count);
+        for (std::uint32_t i = 0; i < count && !mReader.Failed(); ++i)
+        {
+            auto encoding = mReader.ReadEnum(ImageEncoding::kJPEG);
+            auto index = mReader.ReadUInt32();
+            if (IsValidIndex(index, mStrings.size()))
+                mImages.push_back({index, encoding});
+        }
+    }
+
+    void ReadElementStyle(GraphicStyleImpl& graphicStyle, ClassNames& classNames)
+    {
+        auto index = mReader.ReadUInt32();
+        if (IsValidIndex(index, mGraphicStyles.size()))
+            graphicStyle = mGraphicStyles[index];
+        auto classCount = mReader.ReadCount(sizeof(std::uint32_t));
+        std::set<std::string> classNameSet;
+        for (std::uint32_t i = 0; i < classCount && !mReader.Failed(); ++i)
+        {
+            index = mReader.ReadUInt32();
+            if (IsValidIndex(index, mStrings.size()))
+                classNameSet.insert(mStrings[index]);
+        }
+        classNames = SVGDocumentImpl::CopyClassNames(mArena, classNameSet);
+    }
+
+    SVGDocumentImpl::Element* ReadElement(size_t depth)
+    {
+        auto type = mReader.ReadEnum(SVGDocumentImpl::ElementType::kGroup);
+        GraphicStyleImpl graphicStyle{};
+        ClassNames classNames;
+        ReadElementStyle(graphicStyle, classNames);
+        if (mReader.Failed())
+            return nullptr;
+
+        switch (type)
+        {
+        case SVGDocumentImpl::ElementType::kGraphic:
+        {
+            auto fillIndex = mReader.ReadUInt32();
+            auto strokeIndex = mReader.ReadUInt32();
+            auto pathIndex = mReader.ReadUInt32();
+            if (!IsValidIndex(fillIndex, mFillStyles.size()) || !IsValidIndex(strokeIndex, mStrokeStyles.size())
+                || !IsValidIndex(pathIndex, mPaths.size()))
+                return nullptr;
+            auto graphic = mArena.New<SVGDocumentImpl::Graphic>(
+                graphicStyle, classNames, mFillStyles[fillIndex], mStrokeStyles[strokeIndex], mPaths[pathIndex]);
+            SVGDocumentImpl::ResolveStaticStyle(*graphic);
+            return graphic;
+        }
+        case SVGDocumentImpl::ElementType::kImage:
+        {
+            auto imageIndex = mReader.ReadUInt32();
+            Rect areas[2];
+            for (auto& rect : areas)
+            {
+                for (auto value : {&rect.x, &rect.y, &rect.width, &rect.height})
+                    *value = mReader.ReadFloat();
+            }
+            if (!IsValidIndex(imageIndex, mImages.size()))
+                return nullptr;
+            const auto& image = mImages[imageIndex];
+            const auto& base64 = mStrings[image.first];
+            ImageData* imageData{};
+            if (mRenderer)
+            {
+                // Skip images the renderer can not decode, just like the parser does.
+                imageData = mRenderer->AllocateImageData(base64, image.second, mArena);
+                if (!imageData)
+                    return nullptr;
+            }
+            return mArena.New<SVGDocumentImpl::Image>(
+                graphicStyle, classNames, mArena.CopyString(base64), image.second, imageData, areas[0], areas[1]);
+        }
+        case SVGDocumentImpl::ElementType::kGroup:
+        {
+            if (depth >= kMaxGroupDepth)
+            {
+                mReader.Fail();
+                return nullptr;
+            }
+            auto group = mArena.New<SVGDocumentImpl::Group>(graphicStyle, classNames);
+            ReadGroupChildren(*group, depth + 1);
+            return group;
+        }
+        default:
+            mReader.Fail();
+            return nullptr;
+        }
+    }
+
+    void ReadGroupChildren(SVGDocumentImpl::Group& group, size_t depth)
+    {
+        auto childCount = mReader.ReadCount(1 + 2 * sizeof(std::uint32_t));
+        for (std::uint32_t i = 0; i < childCount && !mReader.Failed(); ++i)
+        {
+            if (auto child = ReadElement(depth))
+                group.AppendChild(child);
+        }
+    }
+
+    BinaryReader mReader;
+    std::shared_ptr<SVGRenderer> mRenderer;
+    SVGArena& mArena;
+
+    std::vector<std::string> mStrings;
+    std::vector<const SVGPathData*> mPaths;
+    std::vector<AffineTransform> mTransforms;
+    std::vector<GradientImpl> mGradients;
+    std::vector<const ClippingPathImpl*> mClippingPaths;
+    std::vector<FillStyleImpl> mFillStyles;
+    std::vector<StrokeStyleImpl> mStrokeStyles;
+    std::vector<GraphicStyleImpl> mGraphicStyles;
+    std::vector<std::pair<std::uint32_t, ImageEncoding>> mImages;
+};
+} // namespace
+
+bool SVGDocumentSerializer::Serialize(const SVGDocumentImpl& document, std::vector<char>& binary)
+{
+    SVG_ASSERT(document.mGroup);
+    if (!document.mGroup)
+        return false;
+
+    DocumentWriter writer;
+    writer.Write(document.mViewBox, *document.mGroup, binary);
+    return true;
+}
+
+std::unique_ptr<SVGDocumentImpl> SVGDocumentSerializer::Deserialize(const char* data, size_t size, std::shared_ptr<SVGRenderer> renderer)
+{
+    if (!data)
+        return nullptr;
+
+    auto document = std::unique_ptr<SVGDocumentImpl>(new SVGDocumentImpl(renderer));
+    DocumentReader reader{data, size, renderer, document->mArena};
+    if (!reader.Read(document->mViewBox, *document->mGroup))
+        return nullptr;
+    document->FinishParsing();
+    return document;
+}
+
+} // namespace SVGNative
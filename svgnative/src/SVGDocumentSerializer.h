@@ -0,0 +1,55 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "Config.h"
+#include "SVGRenderer.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SVGNative
+{
+class SVGDocumentImpl;
+
+/**
+ * Writes and reads the compact binary representation of a parsed document.
+ *
+ * The format starts with a header (magic, version, byte order) followed by
+ * the view box and tables of strings, paths, transforms, gradients, clipping
+ * paths, fill, stroke and graphic styles and images. Identical table entries
+ * are stored once. The element tree follows in pre-order and references
+ * table entries by index. Multi-byte values use the byte order of the
+ * writing machine. Blobs of a different version or byte order get rejected.
+ */
+class SVGDocumentSerializer
+{
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    /**
+     * @param document Document to write. Documents with lazy geometry can not be written.
+     * @param binary Receives the binary representation.
+     */
+    static bool Serialize(const SVGDocumentImpl& document, std::vector<char>& binary);
+
+    /**
+     * Rebuilds a document from its binary representation. Images get decoded
+     * with renderer if there is one. No XML or number parsing is involved.
+     * @return nullptr if data is no valid binary document of the current version.
+     */
+    static std::unique_ptr<SVGDocumentImpl> Deserialize(const char* data, size_t size, std::shared_ptr<SVGRenderer> renderer);
+};
+
+} // namespace SVGNative
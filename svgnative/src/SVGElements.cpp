@@ -0,0 +1,80 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGElements.h"
+
+#include <cstring>
+
+namespace SVGNative
+{
+namespace
+{
+// name has the same size as literal at this point.
+template <size_t N>
+inline SVGElement Match(const char* name, const char (&literal)[N], SVGElement element)
+{
+    return memcmp(name, literal, N - 1) == 0 ? element : SVGElement::kUnknown;
+}
+} // namespace
+
+SVGElement ClassifySVGElement(const char* name, size_t size)
+{
+    switch (size)
+    {
+    case 1:
+        return name[0] == 'g' ? SVGElement::kG : SVGElement::kUnknown;
+    case 3:
+        if (name[0] == 's')
+            return Match(name, "svg", SVGElement::kSvg);
+        return Match(name, "use", SVGElement::kUse);
+    case 4:
+        switch (name[0])
+        {
+        case 'd':
+            return Match(name, "defs", SVGElement::kDefs);
+        case 'l':
+            return Match(name, "line", SVGElement::kLine);
+        case 'p':
+            return Match(name, "path", SVGElement::kPath);
+        case 'r':
+            return Match(name, "rect", SVGElement::kRect);
+        case 's':
+            return Match(name, "stop", SVGElement::kStop);
+        default:
+            return SVGElement::kUnknown;
+        }
+    case 5:
+        if (name[0] == 'i')
+            return Match(name, "image", SVGElement::kImage);
+        return Match(name, "style", SVGElement::kStyle);
+    case 6:
+        if (name[0] == 'c')
+            return Match(name, "circle", SVGElement::kCircle);
+        return Match(name, "symbol", SVGElement::kSymbol);
+    case 7:
+        if (name[0] == 'e')
+            return Match(name, "ellipse", SVGElement::kEllipse);
+        return Match(name, "polygon", SVGElement::kPolygon);
+    case 8:
+        if (name[0] == 'c')
+            return Match(name, "clipPath", SVGElement::kClipPath);
+        return Match(name, "polyline", SVGElement::kPolyline);
+    case 14:
+        if (name[0] == 'l')
+            return Match(name, "linearGradient", SVGElement::kLinearGradient);
+        return Match(name, "radialGradient", SVGElement::kRadialGradient);
+    default:
+        return SVGElement::kUnknown;
+    }
+}
+
+} // namespace SVGNative
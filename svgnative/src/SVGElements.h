@@ -0,0 +1,54 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SVGNative
+{
+/**
+ * All elements the parser understands.
+ */
+enum class SVGElement : std::uint8_t
+{
+    kCircle,
+    kClipPath,
+    kDefs,
+    kEllipse,
+    kG,
+    kImage,
+    kLine,
+    kLinearGradient,
+    kPath,
+    kPolygon,
+    kPolyline,
+    kRadialGradient,
+    kRect,
+    kStop,
+    kStyle,
+    kSvg,
+    kSymbol,
+    kUse,
+
+    kUnknown
+};
+
+/**
+ * Maps an element name to its SVGElement. Switches on the name length and
+ * the first characters, so at most one full string comparison is needed.
+ * @return SVGElement::kUnknown for all names the parser does not handle.
+ */
+SVGElement ClassifySVGElement(const char* name, size_t size);
+
+} // namespace SVGNative
@@ -0,0 +1,569 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGNumberParser.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace SVGNative
+{
+namespace SVGNumberParser
+{
+namespace
+{
+constexpr int kMantissaBits = 23;
+constexpr int kMinExponent = -127;
+constexpr int kInfinitePower = 0xFF;
+
+// Decimal exponents outside of this range always give 0 or infinity for
+// mantissas of up to 19 digits.
+constexpr int kSmallestPowerOfTen = -65;
+constexpr int kLargestPowerOfTen = 38;
+
+// Halfway points between two floats have at most 113 significant digits.
+// Digits after that only matter for being non-zero.
+constexpr int kMaxExactDigits = 128;
+
+// 128 bit approximations of 5^q, normalized so that the most significant bit
+// is set, for q in [kSmallestPowerOfTen, kLargestPowerOfTen]. High word first.
+const std::uint64_t gPowersOfFive[2 * (kLargestPowerOfTen - kSmallestPowerOfTen + 1)] = {
+    0x86ccbb52ea94baea, 0x98e947129fc2b4e9, // 5^-65
+    0xa87fea27a539e9a5, 0x3f2398d747b36224, // 5^-64
+    0xd29fe4b18e88640e, 0x8eec7f0d19a03aad, // 5^-63
+    0x83a3eeeef9153e89, 0x1953cf68300424ac, // 5^-62
+    0xa48ceaaab75a8e2b, 0x5fa8c3423c052dd7, // 5^-61
+    0xcdb02555653131b6, 0x3792f412cb06794d, // 5^-60
+    0x808e17555f3ebf11, 0xe2bbd88bbee40bd0, // 5^-59
+    0xa0b19d2ab70e6ed6, 0x5b6aceaeae9d0ec4, // 5^-58
+    0xc8de047564d20a8b, 0xf245825a5a445275, // 5^-57
+    0xfb158592be068d2e, 0xeed6e2f0f0d56712, // 5^-56
+    0x9ced737bb6c4183d, 0x55464dd69685606b, // 5^-55
+    0xc428d05aa4751e4c, 0xaa97e14c3c26b886, // 5^-54
+    0xf53304714d9265df, 0xd53dd99f4b3066a8, // 5^-53
+    0x993fe2c6d07b7fab, 0xe546a8038efe4029, // 5^-52
+    0xbf8fdb78849a5f96, 0xde98520472bdd033, // 5^-51
+    0xef73d256a5c0f77c, 0x963e66858f6d4440, // 5^-50
+    0x95a8637627989aad, 0xdde7001379a44aa8, // 5^-49
+    0xbb127c53b17ec159, 0x5560c018580d5d52, // 5^-48
+    0xe9d71b689dde71af, 0xaab8f01e6e10b4a6, // 5^-47
+    0x9226712162ab070d, 0xcab3961304ca70e8, // 5^-46
+    0xb6b00d69bb55c8d1, 0x3d607b97c5fd0d22, // 5^-45
+    0xe45c10c42a2b3b05, 0x8cb89a7db77c506a, // 5^-44
+    0x8eb98a7a9a5b04e3, 0x77f3608e92adb242, // 5^-43
+    0xb267ed1940f1c61c, 0x55f038b237591ed3, // 5^-42
+    0xdf01e85f912e37a3, 0x6b6c46dec52f6688, // 5^-41
+    0x8b61313bbabce2c6, 0x2323ac4b3b3da015, // 5^-40
+    0xae397d8aa96c1b77, 0xabec975e0a0d081a, // 5^-39
+    0xd9c7dced53c72255, 0x96e7bd358c904a21, // 5^-38
+    0x881cea14545c7575, 0x7e50d64177da2e54, // 5^-37
+    0xaa242499697392d2, 0xdde50bd1d5d0b9e9, // 5^-36
+    0xd4ad2dbfc3d07787, 0x955e4ec64b44e864, // 5^-35
+    0x84ec3c97da624ab4, 0xbd5af13bef0b113e, // 5^-34
+    0xa6274bbdd0fadd61, 0xecb1ad8aeacdd58e, // 5^-33
+    0xcfb11ead453994ba, 0x67de18eda5814af2, // 5^-32
+    0x81ceb32c4b43fcf4, 0x80eacf948770ced7, // 5^-31
+    0xa2425ff75e14fc31, 0xa1258379a94d028d, // 5^-30
+    0xcad2f7f5359a3b3e, 0x096ee45813a04330, // 5^-29
+    0xfd87b5f28300ca0d, 0x8bca9d6e188853fc, // 5^-28
+    0x9e74d1b791e07e48, 0x775ea264cf55347e, // 5^-27
+    0xc612062576589dda, 0x95364afe032a819e, // 5^-26
+    0xf79687aed3eec551, 0x3a83ddbd83f52205, // 5^-25
+    0x9abe14cd44753b52, 0xc4926a9672793543, // 5^-24
+    0xc16d9a0095928a27, 0x75b7053c0f178294, // 5^-23
+    0xf1c90080baf72cb1, 0x5324c68b12dd6339, // 5^-22
+    0x971da05074da7bee, 0xd3f6fc16ebca5e04, // 5^-21
+    0xbce5086492111aea, 0x88f4bb1ca6bcf585, // 5^-20
+    0xec1e4a7db69561a5, 0x2b31e9e3d06c32e6, // 5^-19
+    0x9392ee8e921d5d07, 0x3aff322e62439fd0, // 5^-18
+    0xb877aa3236a4b449, 0x09befeb9fad487c3, // 5^-17
+    0xe69594bec44de15b, 0x4c2ebe687989a9b4, // 5^-16
+    0x901d7cf73ab0acd9, 0x0f9d37014bf60a11, // 5^-15
+    0xb424dc35095cd80f, 0x538484c19ef38c95, // 5^-14
+    0xe12e13424bb40e13, 0x2865a5f206b06fba, // 5^-13
+    0x8cbccc096f5088cb, 0xf93f87b7442e45d4, // 5^-12
+    0xafebff0bcb24aafe, 0xf78f69a51539d749, // 5^-11
+    0xdbe6fecebdedd5be, 0xb573440e5a884d1c, // 5^-10
+    0x89705f4136b4a597, 0x31680a88f8953031, // 5^-9
+    0xabcc77118461cefc, 0xfdc20d2b36ba7c3e, // 5^-8
+    0xd6bf94d5e57a42bc, 0x3d32907604691b4d, // 5^-7
+    0x8637bd05af6c69b5, 0xa63f9a49c2c1b110, // 5^-6
+    0xa7c5ac471b478423, 0x0fcf80dc33721d54, // 5^-5
+    0xd1b71758e219652b, 0xd3c36113404ea4a9, // 5^-4
+    0x83126e978d4fdf3b, 0x645a1cac083126ea, // 5^-3
+    0xa3d70a3d70a3d70a, 0x3d70a3d70a3d70a4, // 5^-2
+    0xcccccccccccccccc, 0xcccccccccccccccd, // 5^-1
+    0x8000000000000000, 0x0000000000000000, // 5^0
+    0xa000000000000000, 0x0000000000000000, // 5^1
+    0xc800000000000000, 0x0000000000000000, // 5^2
+    0xfa00000000000000, 0x0000000000000000, // 5^3
+    0x9c40000000000000, 0x0000000000000000, // 5^4
+    0xc350000000000000, 0x0000000000000000, // 5^5
+    0xf424000000000000, 0x0000000000000000, // 5^6
+    0x9896800000000000, 0x0000000000000000, // 5^7
+    0xbebc200000000000, 0x0000000000000000, // 5^8
+    0xee6b280000000000, 0x0000000000000000, // 5^9
+    0x9502f90000000000, 0x0000000000000000, // 5^10
+    0xba43b74000000000, 0x0000000000000000, // 5^11
+    0xe8d4a51000000000, 0x0000000000000000, // 5^12
+    0x9184e72a00000000, 0x0000000000000000, // 5^13
+    0xb5e620f480000000, 0x0000000000000000, // 5^14
+    0xe35fa931a0000000, 0x0000000000000000, // 5^15
+    0x8e1bc9bf04000000, 0x0000000000000000, // 5^16
+    0xb1a2bc2ec5000000, 0x0000000000000000, // 5^17
+    0xde0b6b3a76400000, 0x0000000000000000, // 5^18
+    0x8ac7230489e80000, 0x0000000000000000, // 5^19
+    0xad78ebc5ac620000, 0x0000000000000000, // 5^20
+    0xd8d726b7177a8000, 0x0000000000000000, // 5^21
+    0x878678326eac9000, 0x0000000000000000, // 5^22
+    0xa968163f0a57b400, 0x0000000000000000, // 5^23
+    0xd3c21bcecceda100, 0x0000000000000000, // 5^24
+    0x84595161401484a0, 0x0000000000000000, // 5^25
+    0xa56fa5b99019a5c8, 0x0000000000000000, // 5^26
+    0xcecb8f27f4200f3a, 0x0000000000000000, // 5^27
+    0x813f3978f8940984, 0x4000000000000000, // 5^28
+    0xa18f07d736b90be5, 0x5000000000000000, // 5^29
+    0xc9f2c9cd04674ede, 0xa400000000000000, // 5^30
+    0xfc6f7c4045812296, 0x4d00000000000000, // 5^31
+    0x9dc5ada82b70b59d, 0xf020000000000000, // 5^32
+    0xc5371912364ce305, 0x6c28000000000000, // 5^33
+    0xf684df56c3e01bc6, 0xc732000000000000, // 5^34
+    0x9a130b963a6c115c, 0x3c7f400000000000, // 5^35
+    0xc097ce7bc90715b3, 0x4b9f100000000000, // 5^36
+    0xf0bdc21abb48db20, 0x1e86d40000000000, // 5^37
+    0x96769950b50d88f4, 0x1314448000000000, // 5^38
+};
+
+struct UInt128
+{
+    std::uint64_t high;
+    std::uint64_t low;
+};
+
+inline UInt128 FullMultiplication(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    // __extension__ silences -Wpedantic.
+    __extension__ using UInt128Native = unsigned __int128;
+    UInt128Native product = static_cast<UInt128Native>(a) * b;
+    return {static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+    std::uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+    std::uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    std::uint64_t lowLow = aLow * bLow;
+    std::uint64_t highLow = aHigh * bLow;
+    std::uint64_t lowHigh = aLow * bHigh;
+    std::uint64_t highHigh = aHigh * bHigh;
+    std::uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+    return {highHigh + (highLow >> 32) + (middle >> 32), (middle << 32) | (lowLow & 0xFFFFFFFF)};
+#endif
+}
+
+inline int LeadingZeros(std::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int count{};
+    while (!(value & (std::uint64_t(1) << 63)))
+    {
+        value <<= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline float MakeFloat(bool negative, std::uint32_t power2, std::uint32_t mantissa)
+{
+    std::uint32_t bits = mantissa | (power2 << kMantissaBits) | (static_cast<std::uint32_t>(negative) << 31);
+    float number;
+    memcpy(&number, &bits, sizeof(number));
+    return number;
+}
+
+struct AdjustedMantissa
+{
+    std::uint64_t mantissa;
+    std::int32_t power2;
+
+    bool operator==(const AdjustedMantissa& other) const { return mantissa == other.mantissa && power2 == other.power2; }
+};
+
+// Eisel-Lemire: w * 10^q rounded to a float, see "Number Parsing at a
+// Gigabyte per Second" (Lemire 2021) and "Fast Number Parsing Without
+// Fallback" (Mushtak, Lemire 2023). Exact for all w of up to 19 digits.
+AdjustedMantissa ComputeFloat(std::int32_t q, std::uint64_t w)
+{
+    if (w == 0 || q < kSmallestPowerOfTen)
+        return {0, 0};
+    if (q > kLargestPowerOfTen)
+        return {0, kInfinitePower};
+
+    int leadingZeros = LeadingZeros(w);
+    w <<= leadingZeros;
+
+    // Only the upper kMantissaBits + 3 bits of the product need to be exact.
+    constexpr std::uint64_t kPrecisionMask = UINT64_C(0xFFFFFFFFFFFFFFFF) >> (kMantissaBits + 3);
+    const auto index = 2 * static_cast<size_t>(q - kSmallestPowerOfTen);
+    UInt128 product = FullMultiplication(w, gPowersOfFive[index]);
+    if ((product.high & kPrecisionMask) == kPrecisionMask)
+    {
+        UInt128 secondProduct = FullMultiplication(w, gPowersOfFive[index + 1]);
+        product.low += secondProduct.high;
+        if (secondProduct.high > product.low)
+            ++product.high;
+    }
+
+    int upperBit = static_cast<int>(product.high >> 63);
+    int shift = upperBit + 64 - kMantissaBits - 3;
+    AdjustedMantissa answer;
+    answer.mantissa = product.high >> shift;
+    // floor(log2(10^q)) + 63 without floating point math.
+    std::int32_t power = (((152170 + 65536) * q) >> 16) + 63;
+    answer.power2 = power + upperBit - leadingZeros - kMinExponent;
+
+    if (answer.power2 <= 0)
+    {
+        // Subnormal or zero.
+        if (-answer.power2 + 1 >= 64)
+            return {0, 0};
+        answer.mantissa >>= -answer.power2 + 1;
+        answer.mantissa += (answer.mantissa & 1);
+        answer.mantissa >>= 1;
+        answer.power2 = (answer.mantissa < (UINT64_C(1) << kMantissaBits)) ? 0 : 1;
+        return answer;
+    }
+
+    // The product is exact and lies exactly between two floats: round to even.
+    // Only possible for small q.
+    if (product.low <= 1 && q >= -17 && q <= 10 && (answer.mantissa & 3) == 1)
+    {
+        if ((answer.mantissa << shift) == product.high)
+            answer.mantissa &= ~UINT64_C(1);
+    }
+
+    answer.mantissa += (answer.mantissa & 1);
+    answer.mantissa >>= 1;
+    if (answer.mantissa >= (UINT64_C(2) << kMantissaBits))
+    {
+        answer.mantissa = UINT64_C(1) << kMantissaBits;
+        ++answer.power2;
+    }
+    answer.mantissa &= ~(UINT64_C(1) << kMantissaBits);
+    if (answer.power2 >= kInfinitePower)
+        return {0, kInfinitePower};
+    return answer;
+}
+
+/**
+ * Unsigned integer of fixed capacity for the exact fallback. Large enough
+ * for kMaxExactDigits digits scaled by the largest power of 2 or 5 that
+ * can occur.
+ */
+class BigInteger
+{
+public:
+    BigInteger() { mWords.fill(0); }
+
+    void MultiplyAdd(std::uint32_t factor, std::uint32_t summand)
+    {
+        std::uint64_t carry = summand;
+        for (size_t i = 0; i < mSize; ++i)
+        {
+            carry += static_cast<std::uint64_t>(mWords[i]) * factor;
+            mWords[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        if (carry)
+            mWords[mSize++] = static_cast<std::uint32_t>(carry);
+    }
+
+    void ShiftLeft(int bits)
+    {
+        const size_t wordShift = static_cast<size_t>(bits / 32);
+        const int bitShift = bits % 32;
+        if (!mSize)
+            return;
+        size_t newSize = mSize + wordShift + 1;
+        for (size_t i = newSize; i-- > 0;)
+        {
+            std::uint64_t word{};
+            if (i >= wordShift && i - wordShift < mSize)
+                word = static_cast<std::uint64_t>(mWords[i - wordShift]) << bitShift;
+            if (bitShift && i >= wordShift + 1 && i - wordShift - 1 < mSize)
+                word |= mWords[i - wordShift - 1] >> (32 - bitShift);
+            mWords[i] = static_cast<std::uint32_t>(word);
+        }
+        mSize = newSize;
+        Trim();
+    }
+
+    // Removes the lowest bits. Returns true if any of them was set.
+    bool ShiftRight(int bits)
+    {
+        const size_t wordShift = static_cast<size_t>(bits / 32);
+        const int bitShift = bits % 32;
+        bool hasRemainder{};
+        for (size_t i = 0; i < wordShift && i < mSize; ++i)
+            hasRemainder |= mWords[i] != 0;
+        if (bitShift && wordShift < mSize)
+            hasRemainder |= (mWords[wordShift] & ((1u << bitShift) - 1)) != 0;
+        for (size_t i = 0; i < mSize; ++i)
+        {
+            std::uint64_t word{};
+            if (i + wordShift < mSize)
+                word = mWords[i + wordShift] >> bitShift;
+            if (bitShift && i + wordShift + 1 < mSize)
+                word |= static_cast<std::uint64_t>(mWords[i + wordShift + 1]) << (32 - bitShift);
+            mWords[i] = static_cast<std::uint32_t>(word);
+        }
+        mSize = mSize > wordShift ? mSize - wordShift : 0;
+        Trim();
+        return hasRemainder;
+    }
+
+    // Requires *this >= other.
+    void Subtract(const BigInteger& other)
+    {
+        std::int64_t borrow{};
+        for (size_t i = 0; i < mSize; ++i)
+        {
+            std::int64_t difference = static_cast<std::int64_t>(mWords[i]) - (i < other.mSize ? other.mWords[i] : 0) - borrow;
+            borrow = difference < 0;
+            mWords[i] = static_cast<std::uint32_t>(difference + (borrow << 32));
+        }
+        Trim();
+    }
+
+    int Compare(const BigInteger& other) const
+    {
+        if (mSize != other.mSize)
+            return mSize < other.mSize ? -1 : 1;
+        for (size_t i = mSize; i-- > 0;)
+        {
+            if (mWords[i] != other.mWords[i])
+                return mWords[i] < other.mWords[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    int BitLength() const
+    {
+        if (!mSize)
+            return 0;
+        return static_cast<int>(mSize * 32) - LeadingZeros(mWords[mSize - 1]) + 32;
+    }
+
+    bool IsZero() const { return mSize == 0; }
+    std::uint64_t Low64() const { return (mSize ? mWords[0] : 0) | (mSize > 1 ? static_cast<std::uint64_t>(mWords[1]) << 32 : 0); }
+
+private:
+    void Trim()
+    {
+        while (mSize && !mWords[mSize - 1])
+            --mSize;
+    }
+
+    // 128 digits are 426 bits, 5^174 has 404 bits and the division below
+    // shifts by up to 27 more bits.
+    std::array<std::uint32_t, 32> mWords;
+    size_t mSize{};
+};
+
+// Rounds (q + fraction) * 2^exponent to the nearest float. hasFraction tells
+// if fraction is in (0, 1), otherwise it is 0. q must be below 2^32.
+float RoundToFloat(bool negative, std::uint64_t q, int exponent, bool hasFraction)
+{
+    const int topBit = 63 - LeadingZeros(q) + exponent;
+    const int lsb = std::max(topBit - kMantissaBits, kMinExponent - kMantissaBits + 1);
+    const int shift = lsb - exponent;
+    std::uint64_t mantissa{};
+    if (shift <= 0)
+        mantissa = q << -shift;
+    else if (shift <= 32)
+    {
+        mantissa = q >> shift;
+        const std::uint64_t remainder = q & ((UINT64_C(1) << shift) - 1);
+        const std::uint64_t half = UINT64_C(1) << (shift - 1);
+        if (remainder > half || (remainder == half && (hasFraction || (mantissa & 1))))
+            ++mantissa;
+    }
+    // Otherwise the value is below half of the smallest subnormal.
+    float number = std::ldexp(static_cast<float>(mantissa), lsb);
+    return negative ? -number : number;
+}
+
+int CountSignificantDigits(const char* integerBegin, const char* integerEnd, const char* fractionBegin, const char* fractionEnd)
+{
+    auto it = integerBegin;
+    while (it != integerEnd && *it == '0')
+        ++it;
+    if (it != integerEnd)
+        return static_cast<int>((integerEnd - it) + (fractionEnd - fractionBegin));
+    it = fractionBegin;
+    while (it != fractionEnd && *it == '0')
+        ++it;
+    return static_cast<int>(fractionEnd - it);
+}
+
+// Keeps the first kMaxMantissaDigits significant digits in mantissa and
+// adjusts exponent accordingly. Returns true if any dropped digit is not 0.
+bool TruncateMantissa(const char* integerBegin, const char* integerEnd, const char* fractionBegin, const char* fractionEnd,
+    std::uint64_t& mantissa, std::int32_t& exponent)
+{
+    mantissa = 0;
+    int digitCount{};
+    bool isTruncated{};
+    for (auto it = integerBegin; it != integerEnd; ++it)
+    {
+        if (!digitCount && *it == '0')
+            continue;
+        if (digitCount < kMaxMantissaDigits)
+        {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*it - '0');
+            ++digitCount;
+        }
+        else
+        {
+            isTruncated |= *it != '0';
+            ++exponent;
+        }
+    }
+    for (auto it = fractionBegin; it != fractionEnd; ++it)
+    {
+        if (digitCount >= kMaxMantissaDigits)
+        {
+            isTruncated |= *it != '0';
+            continue;
+        }
+        --exponent;
+        if (!digitCount && *it == '0')
+            continue;
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*it - '0');
+        ++digitCount;
+    }
+    return isTruncated;
+}
+
+// Exact conversion for the cases where ComputeFloat can not decide the
+// rounding direction because the mantissa was truncated to 19 digits.
+float ComputeFloatExact(bool negative, const char* integerBegin, const char* integerEnd, const char* fractionBegin,
+    const char* fractionEnd, std::int32_t exponent)
+{
+    BigInteger digits;
+    int digitCount{};
+    bool hasMoreDigits{};
+    auto addDigits = [&](const char* begin, const char* end, bool isFraction) {
+        for (auto it = begin; it != end; ++it)
+        {
+            if (!digitCount && *it == '0')
+            {
+                if (isFraction)
+                    --exponent;
+                continue;
+            }
+            if (digitCount < kMaxExactDigits)
+            {
+                digits.MultiplyAdd(10, static_cast<std::uint32_t>(*it - '0'));
+                ++digitCount;
+                if (isFraction)
+                    --exponent;
+            }
+            else
+            {
+                hasMoreDigits |= *it != '0';
+                if (!isFraction)
+                    ++exponent;
+            }
+        }
+    };
+    addDigits(integerBegin, integerEnd, false);
+    addDigits(fractionBegin, fractionEnd, true);
+
+    if (exponent >= 0)
+    {
+        // Callers make sure that the result stays below 10^39.
+        for (std::int32_t i = 0; i < exponent; ++i)
+            digits.MultiplyAdd(10, 0);
+        const int shift = std::max(digits.BitLength() - 27, 0);
+        hasMoreDigits |= digits.ShiftRight(shift);
+        return RoundToFloat(negative, digits.Low64(), shift, hasMoreDigits);
+    }
+
+    // value = digits / 5^-exponent * 2^exponent. Divide with enough
+    // quotient bits for rounding: 2^25 <= quotient < 2^27.
+    BigInteger divisor;
+    divisor.MultiplyAdd(1, 1);
+    for (std::int32_t i = 0; i < -exponent; ++i)
+        divisor.MultiplyAdd(5, 0);
+    const int scale = divisor.BitLength() - digits.BitLength() + 26;
+    if (scale > 0)
+        digits.ShiftLeft(scale);
+    else
+        divisor.ShiftLeft(-scale);
+
+    std::uint64_t quotient{};
+    for (int bit = 26; bit >= 0; --bit)
+    {
+        BigInteger shiftedDivisor = divisor;
+        shiftedDivisor.ShiftLeft(bit);
+        if (digits.Compare(shiftedDivisor) >= 0)
+        {
+            digits.Subtract(shiftedDivisor);
+            quotient |= UINT64_C(1) << bit;
+        }
+    }
+    return RoundToFloat(negative, quotient, exponent - scale, hasMoreDigits || !digits.IsZero());
+}
+
+} // namespace
+
+bool ConvertDecimal(bool negative, std::uint64_t mantissa, const DecimalDigits& digits, float& number)
+{
+    // The value is (mantissa + fraction) * 10^exponent. fraction is 0 unless
+    // the mantissa gets truncated.
+    std::int32_t exponent = digits.scientificExponent - static_cast<std::int32_t>(digits.fractionEnd - digits.fractionBegin);
+    bool isTruncated{};
+    if ((digits.integerEnd - digits.integerBegin) + (digits.fractionEnd - digits.fractionBegin) > kMaxMantissaDigits
+        && CountSignificantDigits(digits.integerBegin, digits.integerEnd, digits.fractionBegin, digits.fractionEnd)
+            > kMaxMantissaDigits)
+    {
+        exponent = digits.scientificExponent;
+        isTruncated = TruncateMantissa(digits.integerBegin, digits.integerEnd, digits.fractionBegin, digits.fractionEnd, mantissa, exponent);
+
+        // The value is in [10^(kMaxMantissaDigits - 1 + exponent), 10^(kMaxMantissaDigits + exponent)).
+        if (kMaxMantissaDigits + exponent > kLargestPowerOfTen + 1)
+            return false;
+        if (kMaxMantissaDigits + exponent < kSmallestPowerOfTen + kMaxMantissaDigits)
+        {
+            // Below half of the smallest subnormal float.
+            number = negative ? -0.0f : 0.0f;
+            return true;
+        }
+    }
+
+    auto answer = ComputeFloat(exponent, mantissa);
+    // With a truncated mantissa the value is between mantissa and
+    // mantissa + 1. Use the result only if both round the same way.
+    if (isTruncated && !(answer == ComputeFloat(exponent, mantissa + 1)))
+        number = ComputeFloatExact(
+            negative, digits.integerBegin, digits.integerEnd, digits.fractionBegin, digits.fractionEnd, digits.scientificExponent);
+    else
+        number = MakeFloat(negative, static_cast<std::uint32_t>(answer.power2), static_cast<std::uint32_t>(answer.mantissa));
+    return std::isfinite(number);
+}
+
+} // namespace SVGNumberParser
+
+} // namespace SVGNative
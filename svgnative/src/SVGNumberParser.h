@@ -0,0 +1,213 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+
+namespace SVGNative
+{
+namespace SVGNumberParser
+{
+// Digits that fit into a std::uint64_t.
+constexpr int kMaxMantissaDigits = 19;
+
+// The single float operation of the fast path is only correctly rounded if
+// float arithmetic does not use a wider intermediate format (x87).
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+constexpr bool kHasFloatFastPath = true;
+#else
+constexpr bool kHasFloatFastPath = false;
+#endif
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64)
+constexpr bool kIsLittleEndian = true;
+#else
+constexpr bool kIsLittleEndian = false;
+#endif
+
+// Reads the 8 characters at pos as one little endian word.
+inline std::uint64_t ReadEightCharacters(const char* pos)
+{
+    std::uint64_t value;
+    memcpy(&value, pos, sizeof(value));
+    return value;
+}
+
+inline bool IsEightDigits(std::uint64_t value)
+{
+    return !(((value + UINT64_C(0x4646464646464646)) | (value - UINT64_C(0x3030303030303030))) & UINT64_C(0x8080808080808080));
+}
+
+// Converts 8 digits at once, see "Number Parsing at a Gigabyte per Second".
+inline std::uint64_t ParseEightDigits(std::uint64_t value)
+{
+    const std::uint64_t mask = UINT64_C(0x000000FF000000FF);
+    const std::uint64_t multiplier1 = UINT64_C(0x000F424000000064); // 100 + (1000000 << 32)
+    const std::uint64_t multiplier2 = UINT64_C(0x0000271000000001); // 1 + (10000 << 32)
+    value -= UINT64_C(0x3030303030303030);
+    value = (value * 10) + (value >> 8);
+    return (((value & mask) * multiplier1) + (((value >> 16) & mask) * multiplier2)) >> 32;
+}
+
+// Adds all digits starting at pos to mantissa. Only worth it for sequences
+// that are likely long, like fractions of coordinates.
+inline void AccumulateManyDigits(const char*& pos, const char* end, std::uint64_t& mantissa)
+{
+    if (kIsLittleEndian)
+    {
+        while (end - pos >= 8)
+        {
+            const std::uint64_t value = ReadEightCharacters(pos);
+            if (!IsEightDigits(value))
+                break;
+            mantissa = mantissa * 100000000 + ParseEightDigits(value);
+            pos += 8;
+        }
+    }
+    while (pos != end && IsDigit(*pos))
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*pos++ - '0');
+}
+
+struct DecimalDigits
+{
+    const char* integerBegin;
+    const char* integerEnd;
+    const char* fractionBegin;
+    const char* fractionEnd;
+    std::int32_t scientificExponent;
+};
+
+/**
+ * Converts (mantissa + fraction) * 10^exponent to the nearest float with the
+ * Eisel-Lemire algorithm. Falls back to exact big integer arithmetic in the
+ * rare cases it can not decide the rounding direction. mantissa holds all
+ * digits if there are no more than kMaxMantissaDigits of them. Otherwise
+ * digits are parsed again.
+ * @return false if the value does not fit into a float.
+ */
+bool ConvertDecimal(bool negative, std::uint64_t mantissa, const DecimalDigits& digits, float& number);
+
+// Implementation of ParseNumber below.
+inline bool ParseNumberAt(const char*& pos, const char* end, float& number)
+{
+    if (pos == end)
+        return false;
+
+    bool negative{};
+    if (*pos == '-' || *pos == '+')
+    {
+        negative = *pos == '-';
+        pos++;
+        if (pos == end)
+            return false;
+    }
+
+    // Accumulate all digits. The mantissa is only meaningful if there are
+    // no more than kMaxMantissaDigits significant digits. This is checked below.
+    std::uint64_t mantissa{};
+    const char* integerBegin = pos;
+    while (pos != end && IsDigit(*pos))
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*pos++ - '0');
+    const char* integerEnd = pos;
+
+    const char* fractionBegin = pos;
+    const char* fractionEnd = pos;
+    if (pos != end && *pos == '.')
+    {
+        pos++;
+        if (pos == end || !IsDigit(*pos))
+            return false;
+        fractionBegin = pos;
+        AccumulateManyDigits(pos, end, mantissa);
+        fractionEnd = pos;
+    }
+    if (integerBegin == integerEnd && fractionBegin == fractionEnd)
+        return false;
+
+    std::int32_t scientificExponent{};
+    if (pos != end && (*pos == 'e' || *pos == 'E'))
+    {
+        pos++;
+        if (pos == end)
+            return false;
+        bool negativeExponent{};
+        if (*pos == '-' || *pos == '+')
+        {
+            negativeExponent = *pos == '-';
+            pos++;
+            if (pos == end)
+                return false;
+        }
+        if (!IsDigit(*pos))
+            return false;
+        while (pos != end && IsDigit(*pos))
+        {
+            // Large enough to turn every mantissa into 0 or infinity.
+            if (scientificExponent < 100000)
+                scientificExponent = scientificExponent * 10 + (*pos - '0');
+            pos++;
+        }
+        if (negativeExponent)
+            scientificExponent = -scientificExponent;
+    }
+
+    const auto digitCount = (integerEnd - integerBegin) + (fractionEnd - fractionBegin);
+    const std::int32_t exponent = scientificExponent - static_cast<std::int32_t>(fractionEnd - fractionBegin);
+    if (kHasFloatFastPath && digitCount <= kMaxMantissaDigits && mantissa <= (UINT64_C(1) << 24) && exponent >= -10
+        && exponent <= 10)
+    {
+        // Both operands are exact floats, so the single rounding of the
+        // operation gives the correct result.
+        static constexpr float kExactPowersOfTen[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+        // Signed conversion is cheaper. The mantissa is small enough.
+        number = static_cast<float>(static_cast<std::int64_t>(mantissa));
+        if (exponent < 0)
+            number /= kExactPowersOfTen[-exponent];
+        else if (exponent > 0)
+            number *= kExactPowersOfTen[exponent];
+        number = negative ? -number : number;
+        return true;
+    }
+
+    return ConvertDecimal(negative, mantissa, {integerBegin, integerEnd, fractionBegin, fractionEnd, scientificExponent}, number);
+}
+
+/**
+ * Parses a number of the SVG number grammar
+ * ([+-]? (digits ("." digits)? | "." digits) ([eE] [+-]? digits)?) starting
+ * at pos and converts it to the nearest float (round half to even).
+ *
+ * Short mantissas with small exponents are converted with a single float
+ * multiplication or division. Everything else goes through ConvertDecimal.
+ *
+ * @param pos Start of the number. Points behind the consumed characters on return.
+ * @return false if there is no valid number at pos or the value does not fit
+ * into a float.
+ */
+inline bool ParseNumber(const char*& pos, const char* end, float& number)
+{
+    // Parse on a local copy. Since the characters may alias pos, the
+    // compiler would have to store every increment otherwise.
+    const char* numberPos = pos;
+    bool isValid = ParseNumberAt(numberPos, end, number);
+    pos = numberPos;
+    return isValid;
+}
+
+} // namespace SVGNumberParser
+
+} // namespace SVGNative
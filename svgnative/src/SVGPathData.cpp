@@ -0,0 +1,144 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGPathData.h"
+
+#include <cstring>
+
+namespace SVGNative
+{
+size_t PathVerbPointCount(PathVerb verb)
+{
+    switch (verb)
+    {
+    case PathVerb::kRoundedRect:
+        return 5;
+    case PathVerb::kRect:
+    case PathVerb::kEllipse:
+    case PathVerb::kCurveToV:
+        return 4;
+    case PathVerb::kMoveTo:
+    case PathVerb::kLineTo:
+        return 2;
+    case PathVerb::kCurveTo:
+        return 6;
+    case PathVerb::kClosePath:
+    default:
+        return 0;
+    }
+}
+
+const SVGPathData* SVGPathData::Create(
+    SVGAllocator& allocator, const PathVerb* verbs, size_t verbCount, const void* points, size_t pointCount)
+{
+    // The header is followed by the points and the verbs.
+    static_assert(alignof(SVGPathData) >= alignof(float), "Points follow the header");
+    auto memory = static_cast<char*>(
+        allocator.Allocate(sizeof(SVGPathData) + pointCount * sizeof(float) + verbCount * sizeof(PathVerb), alignof(SVGPathData)));
+    auto pointBuffer = reinterpret_cast<float*>(memory + sizeof(SVGPathData));
+    auto verbBuffer = reinterpret_cast<PathVerb*>(pointBuffer + pointCount);
+    if (pointCount)
+        memcpy(pointBuffer, points, pointCount * sizeof(float));
+    if (verbCount)
+        memcpy(verbBuffer, verbs, verbCount * sizeof(PathVerb));
+    return new (memory) SVGPathData{verbBuffer, verbCount, pointBuffer, pointCount};
+}
+
+void SVGPathData::Replay(Path& path) const
+{
+    auto p = mPoints;
+    for (size_t i = 0; i < mVerbCount; ++i)
+    {
+        auto verb = mVerbs[i];
+        switch (verb)
+        {
+        case PathVerb::kRect:
+            path.Rect(p[0], p[1], p[2], p[3]);
+            break;
+        case PathVerb::kRoundedRect:
+            path.RoundedRect(p[0], p[1], p[2], p[3], p[4]);
+            break;
+        case PathVerb::kEllipse:
+            path.Ellipse(p[0], p[1], p[2], p[3]);
+            break;
+        case PathVerb::kMoveTo:
+            path.MoveTo(p[0], p[1]);
+            break;
+        case PathVerb::kLineTo:
+            path.LineTo(p[0], p[1]);
+            break;
+        case PathVerb::kCurveTo:
+            path.CurveTo(p[0], p[1], p[2], p[3], p[4], p[5]);
+            break;
+        case PathVerb::kCurveToV:
+            path.CurveToV(p[0], p[1], p[2], p[3]);
+            break;
+        case PathVerb::kClosePath:
+        default:
+            path.ClosePath();
+            break;
+        }
+        p += PathVerbPointCount(verb);
+    }
+}
+
+void SVGPathRecorder::Rect(float x, float y, float width, float height)
+{
+    mVerbs.push_back(PathVerb::kRect);
+    mPoints.insert(mPoints.end(), {x, y, width, height});
+}
+
+void SVGPathRecorder::RoundedRect(float x, float y, float width, float height, float cornerRadius)
+{
+    mVerbs.push_back(PathVerb::kRoundedRect);
+    mPoints.insert(mPoints.end(), {x, y, width, height, cornerRadius});
+}
+
+void SVGPathRecorder::Ellipse(float cx, float cy, float rx, float ry)
+{
+    mVerbs.push_back(PathVerb::kEllipse);
+    mPoints.insert(mPoints.end(), {cx, cy, rx, ry});
+}
+
+void SVGPathRecorder::MoveTo(float x, float y)
+{
+    mVerbs.push_back(PathVerb::kMoveTo);
+    mPoints.insert(mPoints.end(), {x, y});
+}
+
+void SVGPathRecorder::LineTo(float x, float y)
+{
+    mVerbs.push_back(PathVerb::kLineTo);
+    mPoints.insert(mPoints.end(), {x, y});
+}
+
+void SVGPathRecorder::CurveTo(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+    mVerbs.push_back(PathVerb::kCurveTo);
+    mPoints.insert(mPoints.end(), {x1, y1, x2, y2, x3, y3});
+}
+
+void SVGPathRecorder::CurveToV(float x2, float y2, float x3, float y3)
+{
+    mVerbs.push_back(PathVerb::kCurveToV);
+    mPoints.insert(mPoints.end(), {x2, y2, x3, y3});
+}
+
+void SVGPathRecorder::ClosePath() { mVerbs.push_back(PathVerb::kClosePath); }
+
+void SVGPathRecorder::Clear()
+{
+    mVerbs.clear();
+    mPoints.clear();
+}
+
+} // namespace SVGNative
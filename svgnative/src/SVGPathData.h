@@ -0,0 +1,115 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "SVGRenderer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SVGNative
+{
+enum class PathVerb : std::uint8_t
+{
+    kRect,
+    kRoundedRect,
+    kEllipse,
+    kMoveTo,
+    kLineTo,
+    kCurveTo,
+    kCurveToV,
+    kClosePath
+};
+
+/**
+ * @return Number of point values the segment of verb takes.
+ */
+size_t PathVerbPointCount(PathVerb verb);
+
+/**
+ * Renderer independent geometry of a path. Verbs and point values are kept in
+ * two compact buffers and get replayed into the Path of a renderer for
+ * drawing. Does not own the buffers.
+ */
+class SVGPathData
+{
+public:
+    SVGPathData(const PathVerb* verbs, size_t verbCount, const float* points, size_t pointCount)
+        : mVerbs{verbs}
+        , mPoints{points}
+        , mVerbCount{verbCount}
+        , mPointCount{pointCount}
+    {
+    }
+
+    /**
+     * Copies verbs and points into a single allocation of allocator. points
+     * gets copied bytewise and does not need to be aligned.
+     */
+    static const SVGPathData* Create(
+        SVGAllocator& allocator, const PathVerb* verbs, size_t verbCount, const void* points, size_t pointCount);
+
+    const PathVerb* Verbs() const { return mVerbs; }
+    size_t VerbCount() const { return mVerbCount; }
+    const float* Points() const { return mPoints; }
+    size_t PointCount() const { return mPointCount; }
+
+    /**
+     * Adds all segments to path.
+     */
+    void Replay(Path& path) const;
+
+private:
+    const PathVerb* mVerbs;
+    const float* mPoints;
+    size_t mVerbCount;
+    size_t mPointCount;
+};
+
+/**
+ * Path that records its segments as plain data. Shapes get recorded while
+ * parsing and copied to the document with Create().
+ */
+class SVGPathRecorder final : public Path
+{
+public:
+    void Rect(float x, float y, float width, float height) override;
+    void RoundedRect(float x, float y, float width, float height, float cornerRadius) override;
+    void Ellipse(float cx, float cy, float rx, float ry) override;
+
+    void MoveTo(float x, float y) override;
+    void LineTo(float x, float y) override;
+    void CurveTo(float x1, float y1, float x2, float y2, float x3, float y3) override;
+    void CurveToV(float x2, float y2, float x3, float y3) override;
+    void ClosePath() override;
+
+    // Removes all segments but keeps the capacity.
+    void Clear();
+
+    /**
+     * @return View of the recorded segments. Valid until the next change.
+     */
+    SVGPathData Data() const { return {mVerbs.data(), mVerbs.size(), mPoints.data(), mPoints.size()}; }
+
+    const SVGPathData* Create(SVGAllocator& allocator) const
+    {
+        return SVGPathData::Create(allocator, mVerbs.data(), mVerbs.size(), mPoints.data(), mPoints.size());
+    }
+
+private:
+    std::vector<PathVerb> mVerbs;
+    std::vector<float> mPoints;
+};
+
+} // namespace SVGNative
@@ -0,0 +1,90 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "SVGNumberParser.h"
+
+#include <cstddef>
+
+namespace SVGNative
+{
+/**
+ * Cursor over the value of a "d" attribute with the primitives of the path
+ * data grammar. Numbers go to SVGNumberParser directly on raw pointers.
+ */
+class SVGPathDataScanner
+{
+public:
+    SVGPathDataScanner(const char* data, size_t size)
+        : mPos{data}
+        , mEnd{data + size}
+    {
+    }
+
+    bool AtEnd() const { return mPos == mEnd; }
+    char Peek() const { return *mPos; }
+    char Next() { return *mPos++; }
+
+    /**
+     * Skips whitespace.
+     * @return false if the end is reached.
+     */
+    bool SkipWsp()
+    {
+        while (mPos != mEnd && IsWsp(*mPos))
+            mPos++;
+        return mPos != mEnd;
+    }
+
+    /**
+     * Skips whitespace, an optional comma and whitespace.
+     * @return false if the end is reached.
+     */
+    bool SkipWspOrComma()
+    {
+        SkipWsp();
+        if (mPos != mEnd && *mPos == ',')
+        {
+            mPos++;
+            SkipWsp();
+        }
+        return mPos != mEnd;
+    }
+
+    bool ParseNumber(float& number) { return SVGNumberParser::ParseNumber(mPos, mEnd, number); }
+
+    bool ParseCoordinate(float& coord) { return SkipWspOrComma() && ParseNumber(coord); }
+    bool ParseCoordinatePair(float& x, float& y) { return ParseCoordinate(x) && ParseCoordinate(y); }
+
+    /**
+     * Arc flags are single characters and may follow each other without
+     * separator.
+     */
+    bool ParseFlag(bool& flag)
+    {
+        if (!SkipWspOrComma())
+            return false;
+        if (*mPos != '0' && *mPos != '1')
+            return false;
+        flag = *mPos++ == '1';
+        return true;
+    }
+
+private:
+    static bool IsWsp(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    const char* mPos;
+    const char* mEnd;
+};
+
+} // namespace SVGNative
@@ -0,0 +1,309 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGRenderPool.h"
+#include "SVGImageCache.h"
+#include "SVGRenderer.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace SVGNative
+{
+class SVGRenderPoolImpl
+{
+public:
+    SVGRenderPoolImpl(SVGRenderPool::RendererFactory factory, unsigned threadCount);
+    ~SVGRenderPoolImpl();
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(mWorkers.size()); }
+
+    void RenderBatch(const RenderJob* jobs, size_t count, const SVGRenderPool::CompletionCallback& completion,
+        const SVGRenderPool::PrepareCallback& prepare);
+
+private:
+    // Jobs [begin, end) of the batch are left to the worker. The owner takes
+    // jobs from the front, other workers steal from the back.
+    struct Worker
+    {
+        std::mutex mutex;
+        size_t begin{};
+        size_t end{};
+        std::unique_ptr<SVGRenderer> renderer;
+        // Images of renderer. Destroyed before it.
+        SVGImageCache imageCache;
+    };
+
+    void WorkerThread(unsigned workerIndex);
+    void RunBatch(unsigned workerIndex);
+    bool PopJob(Worker& worker, size_t& index);
+    bool StealJobs(unsigned workerIndex);
+    void RunJob(unsigned workerIndex, size_t index);
+
+    SVGRenderPool::RendererFactory mFactory;
+    // Worker 0 is the thread calling RenderBatch().
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::vector<std::thread> mThreads;
+
+    // Serializes batches.
+    std::mutex mBatchMutex;
+
+    // Guards the members below. Threads wait for a new generation and the
+    // caller for mRunningThreads to drop to 0.
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    std::condition_variable mBatchDone;
+    std::uint64_t mGeneration{};
+    unsigned mRunningThreads{};
+    bool mStop{};
+#ifndef SVG_NO_EXCEPTIONS
+    std::exception_ptr mError;
+#endif
+
+    // Batch in progress. Written before the threads get woken up.
+    const RenderJob* mJobs{};
+    const SVGRenderPool::CompletionCallback* mCompletion{};
+    const SVGRenderPool::PrepareCallback* mPrepare{};
+};
+
+SVGRenderPoolImpl::SVGRenderPoolImpl(SVGRenderPool::RendererFactory factory, unsigned threadCount)
+    : mFactory{std::move(factory)}
+{
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    mWorkers.emplace_back(new Worker);
+    for (unsigned i = 1; i < threadCount; ++i)
+    {
+        mWorkers.emplace_back(new Worker);
+#ifndef SVG_NO_EXCEPTIONS
+        // Continue with fewer threads if the system refuses to create more.
+        try
+        {
+            mThreads.emplace_back(&SVGRenderPoolImpl::WorkerThread, this, i);
+        }
+        catch (const std::system_error&)
+        {
+            mWorkers.pop_back();
+            break;
+        }
+#else
+        mThreads.emplace_back(&SVGRenderPoolImpl::WorkerThread, this, i);
+#endif
+    }
+}
+
+SVGRenderPoolImpl::~SVGRenderPoolImpl()
+{
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+        mStop = true;
+    }
+    mWakeUp.notify_all();
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+void SVGRenderPoolImpl::RenderBatch(const RenderJob* jobs, size_t count,
+    const SVGRenderPool::CompletionCallback& completion, const SVGRenderPool::PrepareCallback& prepare)
+{
+    if (count == 0)
+        return;
+
+    std::lock_guard<std::mutex> batchLock{mBatchMutex};
+
+    mJobs = jobs;
+    mCompletion = &completion;
+    mPrepare = &prepare;
+
+    // Even shares, the first workers get one more job each for the rest.
+    size_t workerCount = mWorkers.size();
+    size_t begin{};
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        size_t end = begin + count / workerCount + (i < count % workerCount ? 1 : 0);
+        std::lock_guard<std::mutex> lock{mWorkers[i]->mutex};
+        mWorkers[i]->begin = begin;
+        mWorkers[i]->end = end;
+        begin = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+        mRunningThreads = static_cast<unsigned>(mThreads.size());
+        ++mGeneration;
+    }
+    mWakeUp.notify_all();
+
+    RunBatch(0);
+
+    std::unique_lock<std::mutex> lock{mMutex};
+    mBatchDone.wait(lock, [this] { return mRunningThreads == 0; });
+    mJobs = nullptr;
+    mCompletion = nullptr;
+    mPrepare = nullptr;
+#ifndef SVG_NO_EXCEPTIONS
+    if (mError)
+    {
+        auto error = mError;
+        mError = nullptr;
+        std::rethrow_exception(error);
+    }
+#endif
+}
+
+void SVGRenderPoolImpl::WorkerThread(unsigned workerIndex)
+{
+    std::uint64_t generation{};
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock{mMutex};
+            mWakeUp.wait(lock, [&] { return mStop || mGeneration != generation; });
+            if (mStop)
+                return;
+            generation = mGeneration;
+        }
+
+        RunBatch(workerIndex);
+
+        std::lock_guard<std::mutex> lock{mMutex};
+        if (--mRunningThreads == 0)
+            mBatchDone.notify_one();
+    }
+}
+
+void SVGRenderPoolImpl::RunBatch(unsigned workerIndex)
+{
+    auto& worker = *mWorkers[workerIndex];
+    size_t index{};
+    for (;;)
+    {
+        if (PopJob(worker, index))
+            RunJob(workerIndex, index);
+        else if (!StealJobs(workerIndex))
+            return;
+    }
+}
+
+bool SVGRenderPoolImpl::PopJob(Worker& worker, size_t& index)
+{
+    std::lock_guard<std::mutex> lock{worker.mutex};
+    if (worker.begin == worker.end)
+        return false;
+    index = worker.begin++;
+    return true;
+}
+
+bool SVGRenderPoolImpl::StealJobs(unsigned workerIndex)
+{
+    // Jobs never get added during a batch. Once no worker has jobs left, the
+    // batch only waits for the jobs in progress.
+    auto workerCount = static_cast<unsigned>(mWorkers.size());
+    for (unsigned i = 1; i < workerCount; ++i)
+    {
+        auto& victim = *mWorkers[(workerIndex + i) % workerCount];
+        size_t begin{};
+        size_t end{};
+        {
+            std::lock_guard<std::mutex> lock{victim.mutex};
+            if (victim.begin == victim.end)
+                continue;
+            end = victim.end;
+            victim.end -= (victim.end - victim.begin + 1) / 2;
+            begin = victim.end;
+        }
+        auto& worker = *mWorkers[workerIndex];
+        std::lock_guard<std::mutex> lock{worker.mutex};
+        worker.begin = begin;
+        worker.end = end;
+        return true;
+    }
+    return false;
+}
+
+void SVGRenderPoolImpl::RunJob(unsigned workerIndex, size_t index)
+{
+    static const ColorMap kNoColors;
+
+    auto& worker = *mWorkers[workerIndex];
+    const auto& job = mJobs[index];
+    bool success{};
+#ifndef SVG_NO_EXCEPTIONS
+    try
+#endif
+    {
+        if (!worker.renderer && mFactory)
+            worker.renderer = mFactory(workerIndex);
+        if (job.document && worker.renderer)
+        {
+            if (*mPrepare)
+                (*mPrepare)(index, *worker.renderer);
+            float width = job.width;
+            float height = job.height;
+            if (width <= 0 || height <= 0)
+            {
+                width = static_cast<float>(job.document->Width());
+                height = static_cast<float>(job.document->Height());
+            }
+            job.document->Render(*worker.renderer, job.colorMap ? *job.colorMap : kNoColors, width, height, worker.imageCache);
+            success = true;
+        }
+    }
+#ifndef SVG_NO_EXCEPTIONS
+    catch (...)
+    {
+        success = false;
+    }
+#endif
+
+    if (!*mCompletion)
+        return;
+#ifndef SVG_NO_EXCEPTIONS
+    try
+#endif
+    {
+        (*mCompletion)(index, worker.renderer.get(), success);
+    }
+#ifndef SVG_NO_EXCEPTIONS
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+        if (!mError)
+            mError = std::current_exception();
+    }
+#endif
+}
+
+SVGRenderPool::SVGRenderPool(RendererFactory factory, unsigned threadCount)
+    : mImpl{new SVGRenderPoolImpl(std::move(factory), threadCount)}
+{
+}
+
+SVGRenderPool::~SVGRenderPool() = default;
+
+unsigned SVGRenderPool::ThreadCount() const { return mImpl->ThreadCount(); }
+
+void SVGRenderPool::RenderBatch(
+    const RenderJob* jobs, size_t count, const CompletionCallback& completion, const PrepareCallback& prepare)
+{
+    mImpl->RenderBatch(jobs, count, completion, prepare);
+}
+
+} // namespace SVGNative
@@ -0,0 +1,111 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "SVGResourceIndex.h"
+
+#include <algorithm>
+
+namespace SVGNative
+{
+namespace
+{
+const size_t kInitialSlotCount = 64;
+const size_t kMaxRetainedSlotCount = 4096;
+
+// FNV-1a
+inline std::uint32_t HashID(boost::string_view id)
+{
+    std::uint32_t hash = 2166136261u;
+    for (auto c : id)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+} // namespace
+
+const std::uint32_t SVGResourceIndex::kNotFound;
+
+std::uint32_t SVGResourceIndex::Intern(boost::string_view id)
+{
+    if ((mIDs.size() + 1) * 2 > mSlots.size())
+        Grow();
+
+    auto hash = HashID(id);
+    auto slotIndex = FindSlot(id, hash);
+    auto& slot = mSlots[slotIndex];
+    if (slot.entry)
+        return slot.entry - 1;
+
+    auto index = static_cast<std::uint32_t>(mIDs.size());
+    mIDs.push_back({static_cast<std::uint32_t>(mCharacters.size()), static_cast<std::uint32_t>(id.size())});
+    mCharacters.append(id.data(), id.size());
+    slot = {hash, index + 1};
+    return index;
+}
+
+std::uint32_t SVGResourceIndex::Find(boost::string_view id) const
+{
+    if (mSlots.empty())
+        return kNotFound;
+    const auto& slot = mSlots[FindSlot(id, HashID(id))];
+    return slot.entry ? slot.entry - 1 : kNotFound;
+}
+
+void SVGResourceIndex::Clear()
+{
+    // Keep small tables for the next document. Clearing large ones would cost
+    // more than growing them again.
+    if (mSlots.size() > kMaxRetainedSlotCount)
+        std::vector<Slot>{}.swap(mSlots);
+    else if (!mIDs.empty())
+        std::fill(mSlots.begin(), mSlots.end(), Slot{0, 0});
+    mIDs.clear();
+    mCharacters.clear();
+}
+
+boost::string_view SVGResourceIndex::IDAt(std::uint32_t index) const
+{
+    const auto& id = mIDs[index];
+    return {mCharacters.data() + id.offset, id.size};
+}
+
+// Returns the slot of id or the empty slot where it belongs.
+size_t SVGResourceIndex::FindSlot(boost::string_view id, std::uint32_t hash) const
+{
+    auto mask = mSlots.size() - 1;
+    for (auto slotIndex = hash & mask;; slotIndex = (slotIndex + 1) & mask)
+    {
+        const auto& slot = mSlots[slotIndex];
+        if (!slot.entry || (slot.hash == hash && IDAt(slot.entry - 1) == id))
+            return slotIndex;
+    }
+}
+
+void SVGResourceIndex::Grow()
+{
+    std::vector<Slot> slots(mSlots.empty() ? kInitialSlotCount : mSlots.size() * 2, Slot{0, 0});
+    auto mask = slots.size() - 1;
+    for (const auto& slot : mSlots)
+    {
+        if (!slot.entry)
+            continue;
+        auto slotIndex = slot.hash & mask;
+        while (slots[slotIndex].entry)
+            slotIndex = (slotIndex + 1) & mask;
+        slots[slotIndex] = slot;
+    }
+    mSlots.swap(slots);
+}
+
+} // namespace SVGNative
@@ -0,0 +1,77 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <boost/utility/string_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SVGNative
+{
+/**
+ * Interns the values of id attributes. Every distinct ID gets a dense index
+ * starting at 0 that stays valid until Clear(). Lookups hash the ID once and
+ * compare at most a few strings, independent of the number of IDs.
+ * The IDs are copied, callers do not need to keep them alive.
+ */
+class SVGResourceIndex
+{
+public:
+    static const std::uint32_t kNotFound = 0xFFFFFFFF;
+
+    /**
+     * @return Index of id. id gets added if it is not in the index yet.
+     */
+    std::uint32_t Intern(boost::string_view id);
+
+    /**
+     * @return Index of id or kNotFound.
+     */
+    std::uint32_t Find(boost::string_view id) const;
+
+    size_t Size() const { return mIDs.size(); }
+
+    /**
+     * Removes all IDs. Small tables are kept for reuse.
+     */
+    void Clear();
+
+private:
+    struct Slot
+    {
+        std::uint32_t hash;
+        // Index + 1. 0 marks an empty slot.
+        std::uint32_t entry;
+    };
+
+    struct ID
+    {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    boost::string_view IDAt(std::uint32_t index) const;
+    size_t FindSlot(boost::string_view id, std::uint32_t hash) const;
+    void Grow();
+
+    // Open addressing with linear probing. The size is a power of 2 and at
+    // least twice the number of IDs.
+    std::vector<Slot> mSlots;
+    std::vector<ID> mIDs;
+    // Characters of all IDs, back to back.
+    std::string mCharacters;
+};
+
+} // namespace SVGNative
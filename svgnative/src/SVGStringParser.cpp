@@ -13,6 +13,8 @@ governing permissions and limitations under the License.
 #include "SVGStringParser.h"
 #include "CSSColorKeywords.h"
 #include "SVGDocument.h"
+#include "SVGNumberParser.h"
+#include "SVGPathDataScanner.h"
 #include <algorithm>
 #include <array>
 #include <vector>
@@ -29,7 +31,7 @@ void ArcToCurve(Path& path, float startX, float startY, float radiusX, float rad
 
 namespace SVGStringParser
 {
-using CharIt = std::string::const_iterator;
+using CharIt = const char*;
 
 inline bool isDigit(char c)
 {
@@ -44,6 +46,27 @@ inline bool isHex(char c)
 
 inline bool isWsp(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
 
+inline bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+// Only valid for characters that pass isHex().
+inline std::uint32_t HexValue(char c)
+{
+    if (isDigit(c))
+        return static_cast<std::uint32_t>(c - '0');
+    return static_cast<std::uint32_t>((c | 0x20) - 'a' + 10);
+}
+
+// Compares an ASCII name with a lower case keyword, ignoring case.
+inline bool EqualsIgnoreCase(CharIt name, size_t nameSize, const char* keyword)
+{
+    for (size_t i = 0; i < nameSize; ++i, ++keyword)
+    {
+        if (!*keyword || (name[i] | 0x20) != *keyword)
+            return false;
+    }
+    return !*keyword;
+}
+
 inline bool SkipOptWspOrDelimiter(CharIt& pos, const CharIt& end, bool isAllOptional = true, char delimiter = ',')
 {
     if (!isAllOptional && !isWsp(*pos) && *pos != delimiter)
@@ -51,7 +74,7 @@ inline bool SkipOptWspOrDelimiter(CharIt& pos, const CharIt& end, bool isAllOpti
 
     while (pos != end && isWsp(*pos))
         pos++;
-    if (*pos == delimiter)
+    if (pos != end && *pos == delimiter)
         pos++;
     while (pos != end && isWsp(*pos))
         pos++;
@@ -63,7 +86,7 @@ inline bool SkipOptWspDelimiterOptWsp(CharIt& pos, const CharIt& end, char delim
     bool hasDelimiter{};
     while (pos != end && isWsp(*pos))
         pos++;
-    if (*pos == delimiter)
+    if (pos != end && *pos == delimiter)
     {
         hasDelimiter = true;
         pos++;
@@ -97,123 +120,7 @@ static bool ParseScientificNumber(CharIt& pos, const CharIt& end, float& number)
     if (pos == end)
         return false;
 
-    number = 0;
-
-    float sign{1};
-    float exponent{0};
-    float exponentSign{1};
-
-    if (*pos == '-' || *pos == '+')
-    {
-        if (*pos == '-')
-            sign = -1;
-        pos++;
-        if (pos == end)
-            return false;
-    }
-
-    bool hasNumber{};
-    bool hasFraction{};
-    while (pos != end && isDigit(*pos))
-    {
-        hasNumber = true;
-        number *= 10;
-        number += static_cast<float>(*pos++ - '0');
-    }
-    if (pos == end)
-    {
-        number *= sign;
-        return std::isfinite(number);
-    }
-
-    if (*pos == '.')
-    {
-        pos++;
-        if (pos == end || !isDigit(*pos))
-            return false;
-
-        float division = 10;
-        while (pos != end && isDigit(*pos))
-        {
-            hasFraction = true;
-            number += static_cast<float>(*pos++ - '0') / division;
-            division *= 10;
-        }
-    }
-    if (!hasFraction && !hasNumber)
-        return false;
-
-    if (pos == end || (*pos != 'e' && *pos != 'E'))
-    {
-        number *= sign;
-        return std::isfinite(number);
-    }
-
-    pos++;
-    if (pos == end)
-        return false;
-
-    if (*pos == '-' || *pos == '+')
-    {
-        if (*pos == '-')
-            exponentSign = -1;
-        pos++;
-        if (pos == end)
-            return false;
-    }
-    if (!isDigit(*pos))
-        return false;
-
-    while (pos != end && isDigit(*pos))
-    {
-        exponent *= 10.0f;
-        exponent += static_cast<float>(*pos++ - '0');
-    }
-    if (exponent)
-        number *= pow(10.0f, exponentSign * exponent);
-
-    number *= sign;
-    return std::isfinite(number);
-}
-
-static bool ParseCoordinate(CharIt& pos, const CharIt& end, float& coord)
-{
-    // FIXME: Remove initial SkipOptWspOrDelimiter call. Keep it here to keep
-    // behavior consitent to previous implementation.
-    if (!SkipOptWspOrDelimiter(pos, end))
-        return false;
-    if (!ParseScientificNumber(pos, end, coord))
-        return false;
-    return true;
-}
-
-static bool ParseCoordinatePair(CharIt& pos, const CharIt& end, float& x, float& y)
-{
-    // FIXME: Remove initial SkipOptWspOrDelimiter call. Keep it here to keep
-    // behavior consitent to previous implementation.
-    if (!SkipOptWspOrDelimiter(pos, end))
-        return false;
-    if (!ParseScientificNumber(pos, end, x))
-        return false;
-    if (!SkipOptWspOrDelimiter(pos, end))
-        return false;
-    if (!ParseScientificNumber(pos, end, y))
-        return false;
-    return true;
-}
-
-static bool ParseBool(CharIt& pos, const CharIt& end, bool& boolVal)
-{
-    if (!SkipOptWspOrDelimiter(pos, end))
-        return false;
-    if (*pos == '0')
-        boolVal = false;
-    else if (*pos == '1')
-        boolVal = true;
-    else
-        return false;
-    pos++;
-    return true;
+    return SVGNumberParser::ParseNumber(pos, end, number);
 }
 
 static bool ParseLengthOrPercentage(
@@ -295,7 +202,37 @@ static void ParseListOfNumbers(CharIt& pos, const CharIt& end, std::vector<float
     }
 }
 
-bool ParseLengthOrPercentage(const std::string& lengthString, float relDimensionLength, float& absLengthInUnits, bool useQuirks /*= false*/)
+// Like ParseListOfNumbers() above but into a fixed buffer. Returns more than
+// maxCount if the list is longer.
+static size_t ParseListOfNumbers(CharIt& pos, const CharIt& end, float* numbers, size_t maxCount)
+{
+    float number{};
+    if (!SkipOptWsp(pos, end))
+        return 0;
+    auto temp = pos;
+    if (!ParseScientificNumber(temp, end, number))
+        return 0;
+    pos = temp;
+    size_t count{};
+    numbers[count++] = number;
+    while (pos != end)
+    {
+        temp = pos;
+        if (!SkipOptWspOrDelimiter(temp, end, true))
+            break;
+
+        if (!ParseScientificNumber(temp, end, number))
+            break;
+
+        if (count == maxCount)
+            return maxCount + 1;
+        numbers[count++] = number;
+        pos = temp;
+    }
+    return count;
+}
+
+bool ParseLengthOrPercentage(boost::string_view lengthString, float relDimensionLength, float& absLengthInUnits, bool useQuirks /*= false*/)
 {
     auto pos = lengthString.begin();
     auto end = lengthString.end();
@@ -306,7 +243,7 @@ bool ParseLengthOrPercentage(const std::string& lengthString, float relDimension
     return !SkipOptWsp(pos, end);
 }
 
-bool ParseNumber(const std::string& numberString, float& number)
+bool ParseNumber(boost::string_view numberString, float& number)
 {
     auto pos = numberString.begin();
     auto end = numberString.end();
@@ -318,7 +255,7 @@ bool ParseNumber(const std::string& numberString, float& number)
     return !SkipOptWsp(pos, end);
 }
 
-bool ParseListOfNumbers(const std::string& numberListString, std::vector<float>& numberList, bool isAllOptional /*= true*/)
+bool ParseListOfNumbers(boost::string_view numberListString, std::vector<float>& numberList, bool isAllOptional /*= true*/)
 {
     auto pos = numberListString.begin();
     auto end = numberListString.end();
@@ -331,7 +268,24 @@ bool ParseListOfNumbers(const std::string& numberListString, std::vector<float>&
     return !SkipOptWsp(pos, end);
 }
 
-bool ParseListOfLengthOrPercentage(const std::string& lengthOrPercentageListString, float relDimensionLength,
+bool ParseListOfNumbers(boost::string_view numberListString, float* numbers, size_t count)
+{
+    auto pos = numberListString.begin();
+    auto end = numberListString.end();
+
+    SkipOptWsp(pos, end);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i != 0 && (pos == end || !SkipOptWspOrDelimiter(pos, end)))
+            return false;
+        if (!ParseScientificNumber(pos, end, numbers[i]))
+            return false;
+    }
+
+    return !SkipOptWsp(pos, end);
+}
+
+bool ParseListOfLengthOrPercentage(boost::string_view lengthOrPercentageListString, float relDimensionLength,
     std::vector<float>& numberList, bool isAllOptional /*= true*/)
 {
     auto pos = lengthOrPercentageListString.begin();
@@ -362,7 +316,7 @@ bool ParseListOfLengthOrPercentage(const std::string& lengthOrPercentageListStri
     return !SkipOptWsp(pos, end);
 }
 
-bool ParseListOfStrings(const std::string& stringListString, std::vector<std::string>& stringList)
+bool ParseListOfStrings(boost::string_view stringListString, std::vector<boost::string_view>& stringList)
 {
     auto pos = stringListString.begin();
     auto end = stringListString.end();
@@ -374,17 +328,16 @@ bool ParseListOfStrings(const std::string& stringListString, std::vector<std::st
         auto start = pos;
         while (pos != end && !isWsp(*pos))
             pos++;
-        stringList.push_back({start, pos});
+        stringList.push_back({start, static_cast<size_t>(pos - start)});
         SkipOptWsp(pos, end);
     }
     return true;
 }
 
-void ParsePathString(const std::string& pathString, Path& p)
+void ParsePathString(boost::string_view pathString, Path& p, size_t& segmentCount, size_t maxSegmentCount)
 {
-    auto pos = pathString.begin();
-    auto end = pathString.end();
-    if (!SkipOptWsp(pos, end))
+    SVGPathDataScanner scanner{pathString.data(), pathString.size()};
+    if (!scanner.SkipWsp())
         return;
 
     bool startSet{false};
@@ -398,16 +351,19 @@ void ParsePathString(const std::string& pathString, Path& p)
     float prevCurvePointY{};
     char prev = 'm';
 
-    while (pos != end)
+    while (!scanner.AtEnd())
     {
-        if (!SkipOptWsp(pos, end))
+        if (!scanner.SkipWsp())
+            return;
+        if (++segmentCount > maxSegmentCount)
             return;
-        if (!isDigit(*pos) && *pos != ',' && *pos != '-' && *pos != '.')
-            prev = *pos++;
+        char c = scanner.Peek();
+        if (!isDigit(c) && c != ',' && c != '-' && c != '.')
+            prev = scanner.Next();
         switch (prev)
         {
         case 'M':
-            if (!ParseCoordinatePair(pos, end, currentX, currentY))
+            if (!scanner.ParseCoordinatePair(currentX, currentY))
                 return;
             p.MoveTo(currentX, currentY);
             prevControlX = currentX;
@@ -426,7 +382,7 @@ void ParsePathString(const std::string& pathString, Path& p)
         {
             float newX{};
             float newY{};
-            if (!ParseCoordinatePair(pos, end, newX, newY))
+            if (!scanner.ParseCoordinatePair(newX, newY))
                 return;
             currentX += newX;
             currentY += newY;
@@ -457,7 +413,7 @@ void ParsePathString(const std::string& pathString, Path& p)
 
             break;
         case 'L':
-            if (!ParseCoordinatePair(pos, end, currentX, currentY))
+            if (!scanner.ParseCoordinatePair(currentX, currentY))
                 return;
             p.LineTo(currentX, currentY);
             prevControlX = currentX;
@@ -467,7 +423,7 @@ void ParsePathString(const std::string& pathString, Path& p)
         {
             float newX{};
             float newY{};
-            if (!ParseCoordinatePair(pos, end, newX, newY))
+            if (!scanner.ParseCoordinatePair(newX, newY))
                 return;
             currentX += newX;
             currentY += newY;
@@ -477,7 +433,7 @@ void ParsePathString(const std::string& pathString, Path& p)
             break;
         }
         case 'V':
-            if (!ParseCoordinate(pos, end, currentY))
+            if (!scanner.ParseCoordinate(currentY))
                 return;
             p.LineTo(currentX, currentY);
             prevControlX = currentX;
@@ -486,7 +442,7 @@ void ParsePathString(const std::string& pathString, Path& p)
         case 'v':
         {
             float newY{};
-            if (!ParseCoordinate(pos, end, newY))
+            if (!scanner.ParseCoordinate(newY))
                 return;
             currentY += newY;
             p.LineTo(currentX, currentY);
@@ -495,7 +451,7 @@ void ParsePathString(const std::string& pathString, Path& p)
             break;
         }
         case 'H':
-            if (!ParseCoordinate(pos, end, currentX))
+            if (!scanner.ParseCoordinate(currentX))
                 return;
             p.LineTo(currentX, currentY);
             prevControlX = currentX;
@@ -504,7 +460,7 @@ void ParsePathString(const std::string& pathString, Path& p)
         case 'h':
         {
             float newX{};
-            if (!ParseCoordinate(pos, end, newX))
+            if (!scanner.ParseCoordinate(newX))
                 return;
             currentX += newX;
             p.LineTo(currentX, currentY);
@@ -516,11 +472,11 @@ void ParsePathString(const std::string& pathString, Path& p)
         {
             float fx1{};
             float fy1{};
-            if (!ParseCoordinatePair(pos, end, fx1, fy1))
+            if (!scanner.ParseCoordinatePair(fx1, fy1))
                 return;
-            if (!ParseCoordinatePair(pos, end, prevControlX, prevControlY))
+            if (!scanner.ParseCoordinatePair(prevControlX, prevControlY))
                 return;
-            if (!ParseCoordinatePair(pos, end, currentX, currentY))
+            if (!scanner.ParseCoordinatePair(currentX, currentY))
                 return;
             p.CurveTo(fx1, fy1, prevControlX, prevControlY, currentX, currentY);
             break;
@@ -529,17 +485,17 @@ void ParsePathString(const std::string& pathString, Path& p)
         {
             float fx1{};
             float fy1{};
-            if (!ParseCoordinatePair(pos, end, fx1, fy1))
+            if (!scanner.ParseCoordinatePair(fx1, fy1))
                 return;
             fx1 += currentX;
             fy1 += currentY;
-            if (!ParseCoordinatePair(pos, end, prevControlX, prevControlY))
+            if (!scanner.ParseCoordinatePair(prevControlX, prevControlY))
                 return;
             prevControlX += currentX;
             prevControlY += currentY;
             float newX{};
             float newY{};
-            if (!ParseCoordinatePair(pos, end, newX, newY))
+            if (!scanner.ParseCoordinatePair(newX, newY))
                 return;
             currentX += newX;
             currentY += newY;
@@ -553,9 +509,9 @@ void ParsePathString(const std::string& pathString, Path& p)
             prevControlY = 2 * currentY - prevControlY;
             float tempX{};
             float tempY{};
-            if (!ParseCoordinatePair(pos, end, tempX, tempY))
+            if (!scanner.ParseCoordinatePair(tempX, tempY))
                 return;
-            if (!ParseCoordinatePair(pos, end, currentX, currentY))
+            if (!scanner.ParseCoordinatePair(currentX, currentY))
                 return;
             p.CurveTo(prevControlX, prevControlY, tempX, tempY, currentX, currentY);
             prevControlX = tempX;
@@ -566,13 +522,13 @@ void ParsePathString(const std::string& pathString, Path& p)
         {
             float fx1 = 2 * currentX - prevControlX;
             float fx2 = 2 * currentY - prevControlY;
-            if (!ParseCoordinatePair(pos, end, prevControlX, prevControlY))
+            if (!scanner.ParseCoordinatePair(prevControlX, prevControlY))
                 return;
             prevControlX += currentX;
             prevControlY += currentY;
             float newX{};
             float newY{};
-            if (!ParseCoordinatePair(pos, end, newX, newY))
+            if (!scanner.ParseCoordinatePair(newX, newY))
                 return;
             currentX += newX;
             currentY += newY;
@@ -586,9 +542,9 @@ void ParsePathString(const std::string& pathString, Path& p)
 
             float fx{};
             float fy{};
-            if (!ParseCoordinatePair(pos, end, fx, fy))
+            if (!scanner.ParseCoordinatePair(fx, fy))
                 return;
-            if (!ParseCoordinatePair(pos, end, currentX, currentY))
+            if (!scanner.ParseCoordinatePair(currentX, currentY))
                 return;
             p.CurveToV(fx, fy, currentX, currentY);
 
@@ -603,13 +559,13 @@ void ParsePathString(const std::string& pathString, Path& p)
 
             float fx{};
             float fy{};
-            if (!ParseCoordinatePair(pos, end, fx, fy))
+            if (!scanner.ParseCoordinatePair(fx, fy))
                 return;
             fx += currentX;
             fy += currentY;
             float newX{};
             float newY{};
-            if (!ParseCoordinatePair(pos, end, newX, newY))
+            if (!scanner.ParseCoordinatePair(newX, newY))
                 return;
             currentX += newX;
             currentY += newY;
@@ -626,7 +582,7 @@ void ParsePathString(const std::string& pathString, Path& p)
 
             float nextX{};
             float nextY{};
-            if (!ParseCoordinatePair(pos, end, nextX, nextY))
+            if (!scanner.ParseCoordinatePair(nextX, nextY))
                 return;
 
             // reflect previous control point
@@ -646,7 +602,7 @@ void ParsePathString(const std::string& pathString, Path& p)
 
             float nextX{};
             float nextY{};
-            if (!ParseCoordinatePair(pos, end, nextX, nextY))
+            if (!scanner.ParseCoordinatePair(nextX, nextY))
                 return;
             nextX += currentX;
             nextY += currentY;
@@ -667,18 +623,18 @@ void ParsePathString(const std::string& pathString, Path& p)
         {
             float rx{};
             float ry{};
-            if (!ParseCoordinatePair(pos, end, rx, ry))
+            if (!scanner.ParseCoordinatePair(rx, ry))
                 return;
 
             float angle{};
-            if (!ParseCoordinate(pos, end, angle))
+            if (!scanner.ParseCoordinate(angle))
                 return;
 
             bool flagLarge{};
             bool flagSweep{};
-            if (!ParseBool(pos, end, flagLarge))
+            if (!scanner.ParseFlag(flagLarge))
                 return;
-            if (!ParseBool(pos, end, flagSweep))
+            if (!scanner.ParseFlag(flagSweep))
                 return;
 
             float startX = currentX;
@@ -687,7 +643,7 @@ void ParsePathString(const std::string& pathString, Path& p)
             if (prev == 'A')
             {
                 // absolute
-                if (!ParseCoordinatePair(pos, end, currentX, currentY))
+                if (!scanner.ParseCoordinatePair(currentX, currentY))
                     return;
             }
             else
@@ -695,7 +651,7 @@ void ParsePathString(const std::string& pathString, Path& p)
                 // relative
                 float newX{};
                 float newY{};
-                if (!ParseCoordinatePair(pos, end, newX, newY))
+                if (!scanner.ParseCoordinatePair(newX, newY))
                     return;
                 currentX += newX;
                 currentY += newY;
@@ -714,152 +670,141 @@ void ParsePathString(const std::string& pathString, Path& p)
             if (isalpha(prev))
                 SVG_PARSE_TRACE("parsePathString UNHANDLED: " << prev);
 
-            prev = *pos++;
+            if (scanner.AtEnd())
+                return;
+            prev = scanner.Next();
             break;
         }
         }
     }
 }
 
-std::unique_ptr<Transform> ParseTransform(const std::string& transformString, std::function<std::unique_ptr<Transform>()> createTransform)
+bool ParseTransform(boost::string_view transformString, AffineTransform& matrix)
 {
     // https://www.w3.org/TR/css-transforms-1/#svg-syntax
     auto pos = transformString.begin();
     auto end = transformString.end();
     if (!SkipOptWsp(pos, end))
-        return nullptr;
+        return false;
 
-    auto matrix = createTransform();
+    matrix = {};
+    float numbers[6];
     bool isFirstTransform{true};
     while (pos != end)
     {
         if (!SkipOptWsp(pos, end))
-            return matrix;
+            return true;
         if (!isFirstTransform && *pos == ',')
         {
             if (!SkipOptWspOrDelimiter(pos, end, false))
-                return nullptr;
+                return false;
         }
         auto length = std::distance(pos, end);
-        if (length >= 6 && std::string(pos, pos + 6).compare("matrix") == 0)
+        if (length >= 6 && boost::string_view(pos, 6).compare("matrix") == 0)
         {
             pos += 6;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != '(')
-                return nullptr;
-            std::vector<float> numberList;
-            ParseListOfNumbers(pos, end, numberList);
-            if (numberList.size() != 6 || !SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
+            if (ParseListOfNumbers(pos, end, numbers, 6) != 6 || !SkipOptWsp(pos, end))
+                return false;
             if (*pos++ != ')')
-                return nullptr;
-            auto newMatrix = createTransform();
-            newMatrix->Set(numberList[0], numberList[1], numberList[2], numberList[3], numberList[4], numberList[5]);
-            matrix->Concat(*newMatrix);
+                return false;
+            matrix.Concat({numbers[0], numbers[1], numbers[2], numbers[3], numbers[4], numbers[5]});
         }
-        else if (length >= 9 && std::string(pos, pos + 9).compare("translate") == 0)
+        else if (length >= 9 && boost::string_view(pos, 9).compare("translate") == 0)
         {
             pos += 9;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != '(')
-                return nullptr;
-            std::vector<float> numberList;
-            ParseListOfNumbers(pos, end, numberList);
-            auto size = numberList.size();
+                return false;
+            auto size = ParseListOfNumbers(pos, end, numbers, 6);
             if ((size != 1 && size != 2) || !SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != ')')
-                return nullptr;
-            matrix->Translate(numberList[0], (size == 1 ? 0 : numberList[1]));
+                return false;
+            matrix.Translate(numbers[0], (size == 1 ? 0 : numbers[1]));
         }
-        else if (length >= 5 && std::string(pos, pos + 5).compare("scale") == 0)
+        else if (length >= 5 && boost::string_view(pos, 5).compare("scale") == 0)
         {
             pos += 5;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != '(')
-                return nullptr;
-            std::vector<float> numberList;
-            ParseListOfNumbers(pos, end, numberList);
-            auto size = numberList.size();
+                return false;
+            auto size = ParseListOfNumbers(pos, end, numbers, 6);
             if ((size != 1 && size != 2) || !SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != ')')
-                return nullptr;
-            matrix->Scale(numberList[0], (size == 1 ? numberList[0] : numberList[1]));
+                return false;
+            matrix.Scale(numbers[0], (size == 1 ? numbers[0] : numbers[1]));
         }
-        else if (length >= 6 && std::string(pos, pos + 6).compare("rotate") == 0)
+        else if (length >= 6 && boost::string_view(pos, 6).compare("rotate") == 0)
         {
             pos += 6;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != '(')
-                return nullptr;
-            std::vector<float> numberList;
-            ParseListOfNumbers(pos, end, numberList);
-            auto size = numberList.size();
+                return false;
+            auto size = ParseListOfNumbers(pos, end, numbers, 6);
             if ((size != 1 && size != 3) || !SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != ')')
-                return nullptr;
+                return false;
             if (size == 3)
             {
-                matrix->Translate(numberList[1], numberList[2]);
-                matrix->Rotate(numberList[0]);
-                matrix->Translate(-numberList[1], -numberList[2]);
+                matrix.Translate(numbers[1], numbers[2]);
+                matrix.Rotate(numbers[0]);
+                matrix.Translate(-numbers[1], -numbers[2]);
             }
             else
-                matrix->Rotate(numberList[0]);
+                matrix.Rotate(numbers[0]);
         }
-        else if (length >= 5 && std::string(pos, pos + 5).compare("skewX") == 0)
+        else if (length >= 5 && boost::string_view(pos, 5).compare("skewX") == 0)
         {
             pos += 5;
             float number{};
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != '(')
-                return nullptr;
+                return false;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (!ParseScientificNumber(pos, end, number))
-                return nullptr;
+                return false;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != ')')
-                return nullptr;
-            auto newMatrix = createTransform();
+                return false;
             number *= M_PI / 180.0f;
-            newMatrix->Set(1.0f, 0.0f, tan(number), 1.0f, 0.0f, 0.0f);
-            matrix->Concat(*newMatrix);
+            matrix.Concat({1.0f, 0.0f, static_cast<float>(tan(number)), 1.0f, 0.0f, 0.0f});
         }
-        else if (length >= 5 && std::string(pos, pos + 5).compare("skewY") == 0)
+        else if (length >= 5 && boost::string_view(pos, 5).compare("skewY") == 0)
         {
             pos += 5;
             float number{};
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != '(')
-                return nullptr;
+                return false;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (!ParseScientificNumber(pos, end, number))
-                return nullptr;
+                return false;
             if (!SkipOptWsp(pos, end))
-                return nullptr;
+                return false;
             if (*pos++ != ')')
-                return nullptr;
-            auto newMatrix = createTransform();
+                return false;
             number *= M_PI / 180.0f;
-            newMatrix->Set(1.0f, tan(number), 0.0f, 1.0f, 0.0f, 0.0f);
-            matrix->Concat(*newMatrix);
+            matrix.Concat({1.0f, static_cast<float>(tan(number)), 0.0f, 1.0f, 0.0f, 0.0f});
         }
         else
-            return nullptr;
+            return false;
         isFirstTransform = false;
     }
-    return matrix;
+    return true;
 }
 
 static bool ParseCustomPropertyName(CharIt& pos, const CharIt& end, std::string& customPropertyName)
@@ -889,24 +834,30 @@ static bool ParseColor(CharIt& pos, const CharIt& end, ColorImpl& paint, bool su
     Color color{{0.0f, 0.0f, 0.0f, 1.0f}};
     if (*pos == '#')
     {
+        // #RGB, #RGBA, #RRGGBB or #RRGGBBAA
         auto start = ++pos;
+        std::uint32_t hex{};
         while (pos != end && isHex(*pos))
+        {
+            if (pos - start < 8)
+                hex = (hex << 4) | HexValue(*pos);
             pos++;
-        std::string hexString(start, pos);
-        auto num = stoi(hexString, nullptr, 16);
-        if (hexString.size() == 3)
+        }
+        auto digits = pos - start;
+        if (digits == 3 || digits == 4)
         {
-            // Hex color with 3 characters: #FF0 -> #FFFF00
-            color[0] = (num / 0x100) / 15.0f;
-            color[1] = ((num / 0x10) % 0x10) / 15.0f;
-            color[2] = (num % 0x10) / 15.0f;
+            // Hex color with 3 or 4 characters: #FF0 -> #FFFF00
+            if (digits == 3)
+                hex = (hex << 4) | 0xF;
+            for (size_t i = 0; i < 4; ++i)
+                color[i] = ((hex >> (12 - 4 * i)) & 0xF) / 15.0f;
         }
-        else if (hexString.size() == 6)
+        else if (digits == 6 || digits == 8)
         {
-            // Hex color with 6 characters: #FFFF00
-            color[0] = (num / 0x10000) / 255.0f;
-            color[1] = ((num / 0x100) % 0x100) / 255.0f;
-            color[2] = (num % 0x100) / 255.0f;
+            if (digits == 6)
+                hex = (hex << 8) | 0xFF;
+            for (size_t i = 0; i < 4; ++i)
+                color[i] = ((hex >> (24 - 8 * i)) & 0xFF) / 255.0f;
         }
         else
         {
@@ -918,15 +869,19 @@ static bool ParseColor(CharIt& pos, const CharIt& end, ColorImpl& paint, bool su
         return true;
     }
 
-    auto length = std::distance(pos, end);
-    if (length >= 4)
+    // All other colors start with a keyword or function name.
+    auto name = pos;
+    auto nameEnd = pos;
+    while (nameEnd != end && isAlpha(*nameEnd))
+        nameEnd++;
+    size_t nameSize = static_cast<size_t>(nameEnd - name);
+
+    if (nameEnd != end && *nameEnd == '(')
     {
-        std::string char4string(pos, pos + 4);
-        std::transform(char4string.begin(), char4string.end(), char4string.begin(), ::tolower);
-        if (char4string.compare("rgb(") == 0)
+        if (EqualsIgnoreCase(name, nameSize, "rgb"))
         {
             result = SVGDocumentImpl::Result::kInvalid;
-            pos += 4;
+            pos = nameEnd + 1;
             std::int32_t r{};
             std::int32_t g{};
             std::int32_t b{};
@@ -953,10 +908,10 @@ static bool ParseColor(CharIt& pos, const CharIt& end, ColorImpl& paint, bool su
             result = SVGDocumentImpl::Result::kSuccess;
             return true;
         }
-        if (char4string.compare("var(") == 0)
+        if (EqualsIgnoreCase(name, nameSize, "var"))
         {
             result = SVGDocumentImpl::Result::kInvalid;
-            pos += 4;
+            pos = nameEnd + 1;
             if (!SkipOptWsp(pos, end))
                 return false;
             std::string customPropertyName;
@@ -988,44 +943,31 @@ static bool ParseColor(CharIt& pos, const CharIt& end, ColorImpl& paint, bool su
             result = SVGDocumentImpl::Result::kSuccess;
             return true;
         }
+        result = SVGDocumentImpl::Result::kInvalid;
+        return false;
     }
 
-    // Parse CSS named Colors.
-    for (const auto& namedColor : gCSSNamedColors)
+    if (auto namedColor = FindCSSNamedColor(name, nameSize))
     {
-        auto namedColorSize = std::get<1>(namedColor);
-        if (std::distance(pos, end) < static_cast<const long>(namedColorSize))
-            continue;
-        std::string nameString(pos, pos + namedColorSize);
-        std::transform(nameString.begin(), nameString.end(), nameString.begin(), ::tolower);
-        if (std::string(nameString).compare(std::get<0>(namedColor)) == 0)
-        {
-            color = std::get<2>(namedColor);
-            paint = color;
-            result = SVGDocumentImpl::Result::kSuccess;
-            pos += namedColorSize;
-            return true;
-        }
+        paint = *namedColor;
+        result = SVGDocumentImpl::Result::kSuccess;
+        pos = nameEnd;
+        return true;
     }
 
-    if (length >= 12 && supportsCurrentColor)
+    if (supportsCurrentColor && EqualsIgnoreCase(name, nameSize, "currentcolor"))
     {
-        std::string currentColorString(pos, pos + 12);
-        std::transform(currentColorString.begin(), currentColorString.end(), currentColorString.begin(), ::tolower);
-        if (currentColorString.compare("currentcolor") == 0)
-        {
-            paint = ColorKeys::kCurrentColor;
-            result = SVGDocumentImpl::Result::kSuccess;
-            pos += 12;
-            return true;
-        }
+        paint = ColorKeys::kCurrentColor;
+        result = SVGDocumentImpl::Result::kSuccess;
+        pos = nameEnd;
+        return true;
     }
 
     result = SVGDocumentImpl::Result::kInvalid;
     return false;
 }
 
-SVGDocumentImpl::Result ParseColor(const std::string& colorString, ColorImpl& paint, bool supportsCurrentColor /*= true*/)
+SVGDocumentImpl::Result ParseColor(boost::string_view colorString, ColorImpl& paint, bool supportsCurrentColor /*= true*/)
 {
     auto pos = colorString.begin();
     auto end = colorString.end();
@@ -1035,8 +977,8 @@ SVGDocumentImpl::Result ParseColor(const std::string& colorString, ColorImpl& pa
     return SVGDocumentImpl::Result::kInvalid;
 }
 
-SVGDocumentImpl::Result ParsePaint(const std::string& colorString, const std::map<std::string, GradientImpl>& gradientMap,
-    const std::array<float, 4>& viewBox, PaintImpl& paint)
+SVGDocumentImpl::Result ParsePaint(boost::string_view colorString,
+    const std::function<const GradientImpl*(boost::string_view)>& findGradient, const std::array<float, 4>& viewBox, PaintImpl& paint)
 {
     SVGDocumentImpl::Result result{SVGDocumentImpl::Result::kInvalid};
     if (!colorString.size())
@@ -1050,22 +992,20 @@ SVGDocumentImpl::Result ParsePaint(const std::string& colorString, const std::ma
     SVGDocumentImpl::Result urlResult{SVGDocumentImpl::Result::kInvalid};
     if (std::distance(pos, end) >= 5)
     {
-        std::string urlString(pos, pos + 5);
-        if (urlString.find("url(#") == 0)
+        if (boost::string_view(pos, 5) == "url(#")
         {
             // FIXME: Add proper parser for url()
             auto position = colorString.find(')');
-            if (position == std::string::npos)
+            if (position == boost::string_view::npos)
                 return SVGDocumentImpl::Result::kInvalid;
             auto id = colorString.substr(5, position - 5);
-            auto it = gradientMap.find(id);
-            if (it != gradientMap.end())
+            if (auto referencedGradient = findGradient(id))
             {
                 // * No color stops means the same as if 'none' was specified.
                 // * 1 color stop means solid color fill.
                 // https://www.w3.org/TR/SVG11/pservers.html#GradientStops (see notes at the end)
                 // Can not be determined earlier.
-                auto gradient = it->second;
+                auto gradient = *referencedGradient;
                 if (gradient.internalColorStops.empty())
                     return SVGDocumentImpl::Result::kDisabled;
                 else if (gradient.internalColorStops.size() == 1)
@@ -1095,14 +1035,14 @@ SVGDocumentImpl::Result ParsePaint(const std::string& colorString, const std::ma
                     paint = gradient;
                 }
             }
-            pos += position + 1;
+            pos = colorString.begin() + position + 1;
         }
     }
     if (!SkipOptWsp(pos, end))
         return result;
 
     ColorImpl altPaint;
-    if (std::distance(pos, end) >= 4 && std::string(pos, pos + 4).compare("none") == 0)
+    if (std::distance(pos, end) >= 4 && boost::string_view(pos, 4).compare("none") == 0)
     {
         pos += 4;
         if (urlResult == SVGDocumentImpl::Result::kInvalid)
@@ -13,6 +13,7 @@ governing permissions and limitations under the License.
 #pragma once
 
 #include "SVGDocumentImpl.h"
+#include <boost/utility/string_view.hpp>
 #include <functional>
 #include <map>
 #include <string>
@@ -21,17 +22,25 @@ namespace SVGNative
 {
 namespace SVGStringParser
 {
-std::unique_ptr<Transform> ParseTransform(const std::string& transformString, std::function<std::unique_ptr<Transform>()> createTransform);
-bool ParseNumber(const std::string& numberString, float& number);
-bool ParseListOfNumbers(const std::string& numberListString, std::vector<float>& numberList, bool isAllOptinoal = true);
+// All parsers read the characters of the passed range only. The range does not
+// need to be null-terminated.
+// Returns false and leaves matrix undefined if the transform list is invalid.
+bool ParseTransform(boost::string_view transformString, AffineTransform& matrix);
+bool ParseNumber(boost::string_view numberString, float& number);
+bool ParseListOfNumbers(boost::string_view numberListString, std::vector<float>& numberList, bool isAllOptinoal = true);
+// Succeeds only if the list has exactly count numbers.
+bool ParseListOfNumbers(boost::string_view numberListString, float* numbers, size_t count);
 bool ParseListOfLengthOrPercentage(
-    const std::string& lengthOrPercentageListString, float relDimensionLength, std::vector<float>& numberList, bool isAllOptinoal = true);
-bool ParseListOfStrings(const std::string& stringListString, std::vector<std::string>& stringList);
-bool ParseLengthOrPercentage(const std::string& lengthString, float relDimensionLength, float& absLengthInUnits, bool useQuirks = false);
-void ParsePathString(const std::string& pathString, Path& p);
-SVGDocumentImpl::Result ParseColor(const std::string& colorString, ColorImpl& paint, bool supportsCurrentColor = true);
-SVGDocumentImpl::Result ParsePaint(const std::string& colorString, const std::map<std::string, GradientImpl>& gradientMap,
-    const std::array<float, 4>& viewBox, PaintImpl& paint);
+    boost::string_view lengthOrPercentageListString, float relDimensionLength, std::vector<float>& numberList, bool isAllOptinoal = true);
+// The strings point into stringListString.
+bool ParseListOfStrings(boost::string_view stringListString, std::vector<boost::string_view>& stringList);
+bool ParseLengthOrPercentage(boost::string_view lengthString, float relDimensionLength, float& absLengthInUnits, bool useQuirks = false);
+// Adds the number of segments to segmentCount. Stops once segmentCount exceeds maxSegmentCount.
+void ParsePathString(boost::string_view pathString, Path& p, size_t& segmentCount, size_t maxSegmentCount);
+SVGDocumentImpl::Result ParseColor(boost::string_view colorString, ColorImpl& paint, bool supportsCurrentColor = true);
+// findGradient returns the gradient with the passed ID or nullptr.
+SVGDocumentImpl::Result ParsePaint(boost::string_view colorString,
+    const std::function<const GradientImpl*(boost::string_view)>& findGradient, const std::array<float, 4>& viewBox, PaintImpl& paint);
 
 } // namespace SVGStringParser
 
@@ -0,0 +1,367 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "XMLTokenizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace SVGNative
+{
+namespace
+{
+inline bool IsXMLWsp(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+inline bool IsNameEnd(char c) { return IsXMLWsp(c) || c == '/' || c == '>' || c == '?' || c == '=' || c == '<'; }
+
+inline const char* SkipXMLWsp(const char* pos, const char* end)
+{
+    while (pos != end && IsXMLWsp(*pos))
+        ++pos;
+    return pos;
+}
+
+inline bool StartsWith(const char* pos, const char* end, const char* prefix, size_t prefixSize)
+{
+    return static_cast<size_t>(end - pos) >= prefixSize && memcmp(pos, prefix, prefixSize) == 0;
+}
+
+// Finds terminator in [pos, end) and returns the position after it or nullptr.
+inline const char* FindAfter(const char* pos, const char* end, const char* terminator, size_t terminatorSize)
+{
+    while (static_cast<size_t>(end - pos) >= terminatorSize)
+    {
+        auto found = static_cast<const char*>(memchr(pos, terminator[0], end - pos - terminatorSize + 1));
+        if (!found)
+            return nullptr;
+        if (memcmp(found, terminator, terminatorSize) == 0)
+            return found + terminatorSize;
+        pos = found + 1;
+    }
+    return nullptr;
+}
+
+// Skips <!DOCTYPE ...> including an internal subset in brackets.
+const char* SkipDeclaration(const char* pos, const char* end)
+{
+    int depth{};
+    char quote{};
+    for (; pos != end; ++pos)
+    {
+        if (quote)
+        {
+            if (*pos == quote)
+                quote = 0;
+        }
+        else if (*pos == '"' || *pos == '\'')
+            quote = *pos;
+        else if (*pos == '[')
+            ++depth;
+        else if (*pos == ']')
+            --depth;
+        else if (*pos == '>' && depth <= 0)
+            return pos + 1;
+    }
+    return nullptr;
+}
+
+// Reads the start tag after '<' and passes every attribute to handleAttribute.
+template <typename AttributeHandler>
+XMLTokenType ReadStartElement(const char*& pos, const char* end, XMLToken& token, AttributeHandler handleAttribute)
+{
+    // pos points after '<'.
+    auto cur = pos;
+    auto nameStart = cur;
+    while (cur != end && !IsNameEnd(*cur))
+        ++cur;
+    if (cur == end)
+        return XMLTokenType::kIncomplete;
+    if (cur == nameStart)
+        return XMLTokenType::kError;
+    token.name = nameStart;
+    token.nameSize = static_cast<size_t>(cur - nameStart);
+
+    while (true)
+    {
+        cur = SkipXMLWsp(cur, end);
+        if (cur == end)
+            return XMLTokenType::kIncomplete;
+        if (*cur == '>')
+        {
+            pos = cur + 1;
+            return XMLTokenType::kStartElement;
+        }
+        if (*cur == '/')
+        {
+            if (++cur == end)
+                return XMLTokenType::kIncomplete;
+            if (*cur != '>')
+                return XMLTokenType::kError;
+            token.isEmptyElement = true;
+            pos = cur + 1;
+            return XMLTokenType::kStartElement;
+        }
+
+        auto attrNameStart = cur;
+        while (cur != end && !IsNameEnd(*cur) && *cur != '"' && *cur != '\'')
+            ++cur;
+        if (cur == end)
+            return XMLTokenType::kIncomplete;
+        if (cur == attrNameStart)
+            return XMLTokenType::kError;
+        auto attrNameEnd = cur;
+        cur = SkipXMLWsp(cur, end);
+        if (cur == end)
+            return XMLTokenType::kIncomplete;
+        if (*cur++ != '=')
+            return XMLTokenType::kError;
+        cur = SkipXMLWsp(cur, end);
+        if (cur == end)
+            return XMLTokenType::kIncomplete;
+        char quote = *cur++;
+        if (quote != '"' && quote != '\'')
+            return XMLTokenType::kError;
+        auto valueEnd = static_cast<const char*>(memchr(cur, quote, end - cur));
+        if (!valueEnd)
+            return XMLTokenType::kIncomplete;
+        handleAttribute(XMLAttribute{attrNameStart, static_cast<size_t>(attrNameEnd - attrNameStart), cur,
+            static_cast<size_t>(valueEnd - cur)});
+        cur = valueEnd + 1;
+    }
+}
+
+void AppendUTF8(std::uint32_t codePoint, char*& out)
+{
+    if (codePoint < 0x80)
+        *out++ = static_cast<char>(codePoint);
+    else if (codePoint < 0x800)
+    {
+        *out++ = static_cast<char>(0xC0 | (codePoint >> 6));
+        *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000)
+    {
+        *out++ = static_cast<char>(0xE0 | (codePoint >> 12));
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        *out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+// Length of the longest entity that can be decoded, "&#x10FFFF;".
+constexpr size_t kMaxEntitySize = 10;
+
+// Decodes the entity at pos (pointing at '&'). Returns the position after the
+// entity or nullptr if it is no known entity. The ';' is only searched within
+// the longest entity, so that text with many unterminated '&' stays linear.
+const char* DecodeEntity(const char* pos, const char* end, char*& out)
+{
+    auto searchSize = std::min(static_cast<size_t>(end - pos), kMaxEntitySize);
+    auto semicolon = static_cast<const char*>(memchr(pos, ';', searchSize));
+    if (!semicolon)
+        return nullptr;
+    auto nameStart = pos + 1;
+    auto nameSize = static_cast<size_t>(semicolon - nameStart);
+    if (nameSize >= 2 && *nameStart == '#')
+    {
+        std::uint32_t codePoint{};
+        bool isHex = nameStart[1] == 'x' || nameStart[1] == 'X';
+        auto digit = nameStart + (isHex ? 2 : 1);
+        if (digit == semicolon)
+            return nullptr;
+        for (; digit != semicolon; ++digit)
+        {
+            std::uint32_t value{};
+            char c = *digit;
+            if (c >= '0' && c <= '9')
+                value = static_cast<std::uint32_t>(c - '0');
+            else if (isHex && c >= 'a' && c <= 'f')
+                value = static_cast<std::uint32_t>(c - 'a' + 10);
+            else if (isHex && c >= 'A' && c <= 'F')
+                value = static_cast<std::uint32_t>(c - 'A' + 10);
+            else
+                return nullptr;
+            codePoint = codePoint * (isHex ? 16 : 10) + value;
+            if (codePoint > 0x10FFFF)
+                return nullptr;
+        }
+        AppendUTF8(codePoint, out);
+        return semicolon + 1;
+    }
+
+    char c{};
+    if (nameSize == 2 && memcmp(nameStart, "lt", 2) == 0)
+        c = '<';
+    else if (nameSize == 2 && memcmp(nameStart, "gt", 2) == 0)
+        c = '>';
+    else if (nameSize == 3 && memcmp(nameStart, "amp", 3) == 0)
+        c = '&';
+    else if (nameSize == 4 && memcmp(nameStart, "quot", 4) == 0)
+        c = '"';
+    else if (nameSize == 4 && memcmp(nameStart, "apos", 4) == 0)
+        c = '\'';
+    else
+        return nullptr;
+    *out++ = c;
+    return semicolon + 1;
+}
+} // namespace
+
+XMLTokenType ReadXMLToken(const char*& pos, const char* end, bool isFinal, XMLToken& token)
+{
+    token.name = nullptr;
+    token.nameSize = 0;
+    token.text = nullptr;
+    token.textSize = 0;
+    token.isEmptyElement = false;
+    token.attributes.clear();
+
+    if (pos == end)
+        return isFinal ? XMLTokenType::kError : XMLTokenType::kIncomplete;
+
+    auto incomplete = isFinal ? XMLTokenType::kError : XMLTokenType::kIncomplete;
+    if (*pos != '<')
+    {
+        auto textEnd = static_cast<const char*>(memchr(pos, '<', end - pos));
+        if (!textEnd)
+        {
+            if (!isFinal)
+                return XMLTokenType::kIncomplete;
+            textEnd = end;
+        }
+        token.text = pos;
+        token.textSize = static_cast<size_t>(textEnd - pos);
+        pos = textEnd;
+        return XMLTokenType::kText;
+    }
+
+    auto cur = pos + 1;
+    if (cur == end)
+        return incomplete;
+
+    if (*cur == '?')
+    {
+        // Processing instructions and the XML declaration.
+        auto after = FindAfter(cur + 1, end, "?>", 2);
+        if (!after)
+            return incomplete;
+        pos = after;
+        return XMLTokenType::kSkipped;
+    }
+    if (*cur == '!')
+    {
+        if (StartsWith(cur, end, "!--", 3))
+        {
+            auto after = FindAfter(cur + 3, end, "-->", 3);
+            if (!after)
+                return incomplete;
+            pos = after;
+            return XMLTokenType::kSkipped;
+        }
+        if (StartsWith(cur, end, "![CDATA[", 8))
+        {
+            auto after = FindAfter(cur + 8, end, "]]>", 3);
+            if (!after)
+                return incomplete;
+            token.text = cur + 8;
+            token.textSize = static_cast<size_t>(after - 3 - token.text);
+            pos = after;
+            return XMLTokenType::kCData;
+        }
+        // Prefixes of "!--" or "![CDATA[" may still turn into one of the above.
+        auto available = static_cast<size_t>(end - cur);
+        if ((available < 3 && memcmp(cur, "!--", available) == 0) || (available < 8 && memcmp(cur, "![CDATA[", available) == 0))
+            return incomplete;
+        auto after = SkipDeclaration(cur + 1, end);
+        if (!after)
+            return incomplete;
+        pos = after;
+        return XMLTokenType::kSkipped;
+    }
+    if (*cur == '/')
+    {
+        auto nameStart = ++cur;
+        while (cur != end && !IsNameEnd(*cur))
+            ++cur;
+        auto nameEnd = cur;
+        cur = SkipXMLWsp(cur, end);
+        if (cur == end)
+            return incomplete;
+        if (*cur != '>' || nameEnd == nameStart)
+            return XMLTokenType::kError;
+        token.name = nameStart;
+        token.nameSize = static_cast<size_t>(nameEnd - nameStart);
+        pos = cur + 1;
+        return XMLTokenType::kEndElement;
+    }
+
+    auto& attributes = token.attributes;
+    auto result = ReadStartElement(cur, end, token, [&attributes](const XMLAttribute& attribute) { attributes.push_back(attribute); });
+    if (result == XMLTokenType::kIncomplete)
+        return incomplete;
+    if (result == XMLTokenType::kStartElement)
+        pos = cur;
+    return result;
+}
+
+XMLTokenType ReadXMLStartTag(
+    const char*& pos, const char* end, XMLToken& token, void (*handleAttribute)(void* context, const XMLAttribute& attribute), void* context)
+{
+    token.name = nullptr;
+    token.nameSize = 0;
+    token.text = nullptr;
+    token.textSize = 0;
+    token.isEmptyElement = false;
+    token.attributes.clear();
+
+    if (end - pos < 2 || *pos != '<')
+        return XMLTokenType::kError;
+
+    auto cur = pos + 1;
+    auto result = ReadStartElement(
+        cur, end, token, [handleAttribute, context](const XMLAttribute& attribute) { handleAttribute(context, attribute); });
+    if (result == XMLTokenType::kIncomplete)
+        return XMLTokenType::kError;
+    if (result == XMLTokenType::kStartElement)
+        pos = cur;
+    return result;
+}
+
+size_t DecodeXMLEntities(const char* s, size_t size, char* out)
+{
+    auto outStart = out;
+    auto end = s + size;
+    while (s != end)
+    {
+        auto amp = static_cast<const char*>(memchr(s, '&', end - s));
+        auto chunkEnd = amp ? amp : end;
+        memmove(out, s, chunkEnd - s);
+        out += chunkEnd - s;
+        s = chunkEnd;
+        if (!amp)
+            break;
+        if (auto after = DecodeEntity(s, end, out))
+            s = after;
+        else
+            *out++ = *s++;
+    }
+    return static_cast<size_t>(out - outStart);
+}
+
+} // namespace SVGNative
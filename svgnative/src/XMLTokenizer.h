@@ -0,0 +1,82 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SVGNative
+{
+enum class XMLTokenType
+{
+    kStartElement, /** <name attr="value"> or <name/> **/
+    kEndElement, /** </name> **/
+    kText, /** Character data between tags. Entities are not decoded. **/
+    kCData, /** <![CDATA[...]]> **/
+    kSkipped, /** Comments, processing instructions, XML declaration and DOCTYPE. **/
+    kIncomplete, /** The token does not end within the passed range. **/
+    kError
+};
+
+struct XMLAttribute
+{
+    const char* name;
+    size_t nameSize;
+    const char* value; /** Raw value without quotes. Entities are not decoded. **/
+    size_t valueSize;
+};
+
+struct XMLToken
+{
+    const char* name{};
+    size_t nameSize{};
+    const char* text{};
+    size_t textSize{};
+    bool isEmptyElement{};
+    std::vector<XMLAttribute> attributes;
+};
+
+/**
+ * Reads the next token from the range [pos, end). Strings in token point into
+ * the range, nothing gets copied or modified.
+ * @param pos Start of the token. Advanced past the token on success.
+ * @param end End of the available input.
+ * @param isFinal If false, a token that reaches end is reported as kIncomplete
+ *      and pos is not advanced. Otherwise it is an error.
+ * @param token Receives name, text and attributes of the token.
+ */
+XMLTokenType ReadXMLToken(const char*& pos, const char* end, bool isFinal, XMLToken& token);
+
+/**
+ * Reads the start tag at pos like ReadXMLToken() with isFinal set, but passes
+ * the attributes to handleAttribute instead of storing them in token. Nothing
+ * gets allocated.
+ * @param pos Points to the '<' of a start tag. Advanced past the tag on success.
+ * @param end End of the available input.
+ * @param token Receives name and isEmptyElement of the tag.
+ * @param handleAttribute Called with context for each attribute in document order.
+ * @return kStartElement on success, kError otherwise.
+ */
+XMLTokenType ReadXMLStartTag(
+    const char*& pos, const char* end, XMLToken& token, void (*handleAttribute)(void* context, const XMLAttribute& attribute), void* context);
+
+/**
+ * Replaces predefined entities (&lt; &gt; &amp; &quot; &apos;) and character
+ * references. Unknown entities and '&' without ';' within the longest valid
+ * entity are kept as they are.
+ * @param out Receives the decoded string. Needs room for size characters.
+ * @return Size of the decoded string.
+ */
+size_t DecodeXMLEntities(const char* s, size_t size, char* out);
+
+} // namespace SVGNative
@@ -0,0 +1,251 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#include "XMLTree.h"
+#include "XMLTokenizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace SVGNative
+{
+constexpr size_t XMLDocument::kMinBlockSize;
+constexpr size_t XMLDocument::kMaxBlockSize;
+
+bool XMLDocument::Parse(const char* s, size_t length, char* writable)
+{
+    Clear();
+
+    const char* pos = s;
+    const char* end = s + length;
+    XMLToken token;
+    XMLNode* parent{};
+    // Nesting level within unsupported elements and further top-level elements.
+    size_t skippedDepth{};
+    while (pos != end)
+    {
+        auto tokenType = ReadXMLToken(pos, end, true, token);
+        switch (tokenType)
+        {
+        case XMLTokenType::kStartElement:
+        {
+            if (skippedDepth || (mRootNode && !parent))
+            {
+                if (!token.isEmptyElement)
+                    ++skippedDepth;
+                break;
+            }
+            auto element = ClassifySVGElement(token.name, token.nameSize);
+            auto node = CreateNode(XMLNodeType::kElement, element);
+            AppendNode(parent, node);
+            if (element == SVGElement::kUnknown)
+            {
+                if (!token.isEmptyElement)
+                    ++skippedDepth;
+                break;
+            }
+            for (const auto& attribute : token.attributes)
+            {
+                auto svgAttribute = ClassifySVGAttribute(attribute.name, attribute.nameSize);
+                if (svgAttribute == SVGAttribute::kUnknown)
+                    continue;
+                auto valueSize = attribute.valueSize;
+                auto value = DecodeValue(s, writable, attribute.value, valueSize);
+                AppendAttribute(node, svgAttribute, value, valueSize);
+            }
+            if (!token.isEmptyElement)
+                parent = node;
+            break;
+        }
+        case XMLTokenType::kEndElement:
+            if (skippedDepth)
+                --skippedDepth;
+            else if (parent)
+                parent = parent->parent;
+            else
+            {
+                Clear();
+                return false;
+            }
+            break;
+        case XMLTokenType::kText:
+        case XMLTokenType::kCData:
+        {
+            if (skippedDepth || !parent)
+                break;
+            auto value = token.text;
+            auto valueSize = token.textSize;
+            auto node = CreateNode(tokenType == XMLTokenType::kCData ? XMLNodeType::kCData : XMLNodeType::kData, SVGElement::kUnknown);
+            if (node->type == XMLNodeType::kData)
+            {
+                value = DecodeValue(s, writable, value, valueSize);
+                // The first text is the value of the element as well.
+                if (!parent->valueSize)
+                {
+                    parent->value = value;
+                    parent->valueSize = valueSize;
+                }
+            }
+            node->value = value;
+            node->valueSize = valueSize;
+            AppendNode(parent, node);
+            break;
+        }
+        case XMLTokenType::kSkipped:
+            break;
+        case XMLTokenType::kIncomplete:
+        case XMLTokenType::kError:
+        default:
+            Clear();
+            return false;
+        }
+    }
+
+    if (!mRootNode || parent || skippedDepth)
+    {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+XMLNode* XMLDocument::CreateNode(XMLNodeType type, SVGElement element)
+{
+    return new (Allocate(sizeof(XMLNode))) XMLNode{type, element, nullptr, 0, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+}
+
+void XMLDocument::AppendNode(XMLNode* parent, XMLNode* node)
+{
+    if (!parent)
+    {
+        if (!mRootNode)
+            mRootNode = node;
+        return;
+    }
+    node->parent = parent;
+    if (parent->lastChild)
+        parent->lastChild->nextSibling = node;
+    else
+        parent->firstChild = node;
+    parent->lastChild = node;
+}
+
+void XMLDocument::AppendAttribute(XMLNode* node, SVGAttribute attribute, const char* value, size_t valueSize)
+{
+    auto nodeAttribute = new (Allocate(sizeof(XMLNodeAttribute))) XMLNodeAttribute{attribute, value, valueSize, nullptr};
+    if (node->lastAttribute)
+        node->lastAttribute->next = nodeAttribute;
+    else
+        node->firstAttribute = nodeAttribute;
+    node->lastAttribute = nodeAttribute;
+}
+
+const char* XMLDocument::DecodeValue(const char* s, char* writable, const char* value, size_t& valueSize)
+{
+    // Most values have no entities and are used straight from the content.
+    if (!memchr(value, '&', valueSize))
+        return value;
+    auto decoded = writable ? writable + (value - s) : CreateString(valueSize);
+    valueSize = DecodeXMLEntities(value, valueSize, decoded);
+    return decoded;
+}
+
+char* XMLDocument::CreateString(size_t size) { return static_cast<char*>(Allocate(size)); }
+
+XMLNode* XMLDocument::CopySubtree(const XMLNode* node)
+{
+    auto copyString = [this](const char* value, size_t valueSize) -> const char* {
+        if (!valueSize)
+            return value;
+        auto copy = CreateString(valueSize);
+        memcpy(copy, value, valueSize);
+        return copy;
+    };
+
+    // Walk the subtree in pre-order. Iterative, the depth is not limited.
+    XMLNode* root{};
+    XMLNode* copyParent{};
+    auto source = node;
+    while (true)
+    {
+        auto copy = CreateNode(source->type, source->element);
+        copy->value = copyString(source->value, source->valueSize);
+        copy->valueSize = source->valueSize;
+        for (auto attr = source->firstAttribute; attr != nullptr; attr = attr->next)
+            AppendAttribute(copy, attr->attribute, copyString(attr->value, attr->valueSize), attr->valueSize);
+        if (copyParent)
+            AppendNode(copyParent, copy);
+        else
+            root = copy;
+
+        if (source->firstChild)
+        {
+            copyParent = copy;
+            source = source->firstChild;
+            continue;
+        }
+        while (source != node && !source->nextSibling)
+        {
+            source = source->parent;
+            copyParent = copyParent->parent;
+        }
+        if (source == node)
+            break;
+        source = source->nextSibling;
+    }
+    return root;
+}
+
+void XMLDocument::Clear()
+{
+    mRootNode = nullptr;
+    mSize = 0;
+    if (mBlocks.empty())
+        return;
+
+    auto largest = std::max_element(
+        mBlocks.begin(), mBlocks.end(), [](const Block& a, const Block& b) { return a.size < b.size; });
+    if (largest->size > kMaxBlockSize)
+    {
+        // Do not hold on to blocks of single large strings.
+        mBlocks.clear();
+        mBlockPos = nullptr;
+        mBlockRemaining = 0;
+        return;
+    }
+    std::swap(*largest, mBlocks.front());
+    mBlocks.erase(mBlocks.begin() + 1, mBlocks.end());
+    mBlockPos = mBlocks.front().data.get();
+    mBlockRemaining = mBlocks.front().size;
+}
+
+void* XMLDocument::Allocate(size_t size)
+{
+    // Round up so that nodes following strings stay aligned.
+    size = (size + alignof(XMLNode) - 1) & ~(alignof(XMLNode) - 1);
+    if (size > mBlockRemaining)
+    {
+        auto blockSize = std::max(size, mNextBlockSize);
+        mNextBlockSize = std::min(mNextBlockSize * 2, kMaxBlockSize);
+        mBlocks.push_back(Block{std::unique_ptr<char[]>(new char[blockSize]), blockSize});
+        mBlockPos = mBlocks.back().data.get();
+        mBlockRemaining = blockSize;
+    }
+    auto result = mBlockPos;
+    mBlockPos += size;
+    mBlockRemaining -= size;
+    mSize += size;
+    return result;
+}
+
+} // namespace SVGNative
@@ -0,0 +1,133 @@
+/*
+Copyright 2019 Adobe. All rights reserved.
+This file is licensed to you under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License. You may obtain a copy
+of the License at http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software distributed under
+the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+OF ANY KIND, either express or implied. See the License for the specific language
+governing permissions and limitations under the License.
+*/
+
+#pragma once
+
+#include "SVGAttributes.h"
+#include "SVGElements.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SVGNative
+{
+enum class XMLNodeType : std::uint8_t
+{
+    kElement,
+    kData, /** Character data with decoded entities. **/
+    kCData
+};
+
+struct XMLNodeAttribute
+{
+    SVGAttribute attribute;
+    const char* value;
+    size_t valueSize;
+    XMLNodeAttribute* next;
+};
+
+/**
+ * Node of the XML tree. Only the parts the SVG parser reads are kept: elements
+ * are stored as their SVGElement and only attributes with a known SVGAttribute
+ * are stored. Strings are not NUL-terminated.
+ */
+struct XMLNode
+{
+    XMLNodeType type;
+    SVGElement element; /** SVGElement::kUnknown for text and unsupported elements. **/
+    const char* value; /** Text of the node. For elements the text of the first data child. **/
+    size_t valueSize;
+    XMLNode* parent;
+    XMLNode* firstChild;
+    XMLNode* lastChild;
+    XMLNode* nextSibling;
+    XMLNodeAttribute* firstAttribute;
+    XMLNodeAttribute* lastAttribute;
+};
+
+/**
+ * Owns the nodes, attributes and strings of one XML tree. Memory gets allocated
+ * in blocks and is released as a whole.
+ */
+class XMLDocument
+{
+public:
+    XMLDocument() = default;
+    XMLDocument(const XMLDocument&) = delete;
+    XMLDocument& operator=(const XMLDocument&) = delete;
+
+    /**
+     * Builds the tree of the first top-level element of s[0, length). The tree
+     * points into s. Only attributes and text with entities get decoded, in
+     * place if writable is set and into memory of the document otherwise.
+     * Unsupported elements (like <metadata>, <title> or elements of foreign
+     * namespaces) are kept as nodes without attributes and children. Their
+     * content gets skipped without allocating.
+     * @param writable nullptr if s must not be modified, otherwise s itself.
+     * @return false if s is no well-formed XML or has no element.
+     */
+    bool Parse(const char* s, size_t length, char* writable = nullptr);
+
+    /**
+     * @return The top-level element or nullptr.
+     */
+    XMLNode* RootNode() const { return mRootNode; }
+
+    XMLNode* CreateNode(XMLNodeType type, SVGElement element);
+    /**
+     * Appends node to the children of parent. The first node appended without
+     * parent becomes the root node.
+     */
+    void AppendNode(XMLNode* parent, XMLNode* node);
+    void AppendAttribute(XMLNode* node, SVGAttribute attribute, const char* value, size_t valueSize);
+    char* CreateString(size_t size);
+    /**
+     * Copies node, its attributes and descendants with all strings into this
+     * document. The copy has no parent.
+     */
+    XMLNode* CopySubtree(const XMLNode* node);
+
+    /**
+     * Releases all nodes and strings. Keeps the largest block for reuse.
+     */
+    void Clear();
+
+    /**
+     * @return Bytes handed out since the last Clear().
+     */
+    size_t Size() const { return mSize; }
+
+private:
+    void* Allocate(size_t size);
+    // Returns value with decoded entities and updates valueSize.
+    const char* DecodeValue(const char* s, char* writable, const char* value, size_t& valueSize);
+
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> mBlocks;
+    char* mBlockPos{};
+    size_t mBlockRemaining{};
+    size_t mNextBlockSize{kMinBlockSize};
+    size_t mSize{};
+    XMLNode* mRootNode{};
+
+    static constexpr size_t kMinBlockSize = 1024;
+    static constexpr size_t kMaxBlockSize = 64 * 1024;
+};
+
+} // namespace SVGNative